@@ -20,6 +20,7 @@
 #include <Runtime/Engine/Classes/PhysicalMaterials/PhysicalMaterial.h>
 #include <Runtime/Engine/Classes/PhysicsEngine/PhysicsConstraintComponent.h>
 #include <Runtime/Engine/Classes/PhysicsEngine/PhysicsSettings.h>
+#include <Runtime/Engine/Public/Physics/PhysicsInterfaceCore.h>
 #include <HaptxApi/enum.h>
 #include <HaptxApi/transform.h>
 #include <Haptx/Public/ihaptx.h>
@@ -517,24 +518,204 @@ static inline bool isActorAuthoritative(const AActor* actor) {
   return actor->GetLocalRole() == ENetRole::ROLE_Authority;
 }
 
-//! Gets the FRigidBodyStates from all bones in a given skeletal mesh.
+//! @brief Rigid body states for a set of bodies stored as a structure of arrays.
 //!
-//! @param smc The mesh to get the FRigidBodyStates from.
-//! @param states [out] Populated with rigid body states.
-static void getRigidBodyStates(const USkeletalMeshComponent* smc,
-    TArray<FRigidBodyState>& states) {
-  if (!IsValid(smc)) {
+//! Used to read or write the state of many bodies while holding the physics scene lock once.
+struct RigidBodyStateBatch {
+
+  //! The bodies whose states are represented. Null entries are skipped.
+  TArray<FBodyInstance*> bodies;
+
+  //! World positions [cm].
+  TArray<FVector> w_positions_cm;
+
+  //! World orientations.
+  TArray<FQuat> w_orients;
+
+  //! World linear velocities [cm/s].
+  TArray<FVector> w_lin_vels_cm_s;
+
+  //! World angular velocities [deg/s].
+  TArray<FVector> w_ang_vels_deg_s;
+
+  //! ERigidBodyFlags for each body.
+  TArray<uint8> flags;
+
+  //! Empties the batch while keeping its allocations.
+  //!
+  //! @param expected_num The number of bodies expected to be added.
+  void reset(int32 expected_num = 0) {
+    bodies.Reset(expected_num);
+    w_positions_cm.Reset(expected_num);
+    w_orients.Reset(expected_num);
+    w_lin_vels_cm_s.Reset(expected_num);
+    w_ang_vels_deg_s.Reset(expected_num);
+    flags.Reset(expected_num);
+  }
+
+  //! Adds a body with a default state.
+  //!
+  //! @param body The body to add.
+  //! @returns The index of the body in the batch.
+  int32 add(FBodyInstance* body) {
+    w_positions_cm.Add(FVector::ZeroVector);
+    w_orients.Add(FQuat::Identity);
+    w_lin_vels_cm_s.Add(FVector::ZeroVector);
+    w_ang_vels_deg_s.Add(FVector::ZeroVector);
+    flags.Add(ERigidBodyFlags::None);
+    return bodies.Add(body);
+  }
+
+  //! Adds a body with a given state.
+  //!
+  //! @param body The body to add.
+  //! @param state The state of the body.
+  //! @returns The index of the body in the batch.
+  int32 add(FBodyInstance* body, const FRigidBodyState& state) {
+    int32 i = add(body);
+    setState(i, state);
+    return i;
+  }
+
+  //! The number of bodies in the batch.
+  //!
+  //! @returns The number of bodies in the batch.
+  int32 num() const {
+    return bodies.Num();
+  }
+
+  //! Gets the state of a body in the batch.
+  //!
+  //! @param i The index of the body.
+  //! @returns The state of the body.
+  FRigidBodyState getState(int32 i) const {
+    FRigidBodyState state;
+    state.Position = w_positions_cm[i];
+    state.Quaternion = w_orients[i];
+    state.LinVel = w_lin_vels_cm_s[i];
+    state.AngVel = w_ang_vels_deg_s[i];
+    state.Flags = flags[i];
+    return state;
+  }
+
+  //! Sets the state of a body in the batch.
+  //!
+  //! @param i The index of the body.
+  //! @param state The new state of the body.
+  void setState(int32 i, const FRigidBodyState& state) {
+    w_positions_cm[i] = state.Position;
+    w_orients[i] = state.Quaternion;
+    w_lin_vels_cm_s[i] = state.LinVel;
+    w_ang_vels_deg_s[i] = state.AngVel;
+    flags[i] = state.Flags;
+  }
+};
+
+//! Get the physics scene shared by all bodies in a batch.
+//!
+//! @param batch The batch in question.
+//! @returns The physics scene of the first valid body, or nullptr if the batch has none.
+static inline FPhysScene* getBatchPhysicsScene(const RigidBodyStateBatch& batch) {
+  for (FBodyInstance* body : batch.bodies) {
+    if (body != nullptr && body->IsValidBodyInstance()) {
+      return body->GetPhysicsScene();
+    }
+  }
+  return nullptr;
+}
+
+//! @brief Reads the current states of all bodies in a batch.
+//!
+//! The physics scene lock is taken once for all simulating bodies. Bodies that aren't simulating,
+//! or that live in a different scene, fall back to FBodyInstance::GetUnrealWorldTransform() and
+//! friends. Invalid bodies keep their existing state in the batch.
+//!
+//! @param [in,out] batch The batch to read into.
+static void readRigidBodyStates(RigidBodyStateBatch& batch) {
+  FPhysScene* scene = getBatchPhysicsScene(batch);
+  if (scene == nullptr) {
+    return;
+  }
+
+  TArray<int32, TInlineAllocator<8>> unlocked_indices;
+  FPhysicsCommand::ExecuteRead(scene, [&]() {
+    for (int32 i = 0; i < batch.num(); i++) {
+      FBodyInstance* body = batch.bodies[i];
+      if (body == nullptr || !body->IsValidBodyInstance()) {
+        continue;
+      }
+
+      const FPhysicsActorHandle& handle = body->GetPhysicsActorHandle();
+      if (!body->IsInstanceSimulatingPhysics() || body->GetPhysicsScene() != scene ||
+          !FPhysicsInterface::IsValid(handle)) {
+        unlocked_indices.Add(i);
+        continue;
+      }
+
+      const FTransform w_transform = FPhysicsInterface::GetGlobalPose_AssumesLocked(handle);
+      batch.w_positions_cm[i] = w_transform.GetTranslation();
+      batch.w_orients[i] = w_transform.GetRotation();
+      batch.w_lin_vels_cm_s[i] = FPhysicsInterface::GetLinearVelocity_AssumesLocked(handle);
+      batch.w_ang_vels_deg_s[i] = FMath::RadiansToDegrees(
+          FPhysicsInterface::GetAngularVelocity_AssumesLocked(handle));
+      batch.flags[i] = FPhysicsInterface::IsSleeping(handle) ?
+          ERigidBodyFlags::Sleeping : ERigidBodyFlags::None;
+    }
+  });
+
+  for (int32 i : unlocked_indices) {
+    FBodyInstance* body = batch.bodies[i];
+    const FTransform w_transform = body->GetUnrealWorldTransform();
+    batch.w_positions_cm[i] = w_transform.GetTranslation();
+    batch.w_orients[i] = w_transform.GetRotation();
+    batch.w_lin_vels_cm_s[i] = body->GetUnrealWorldVelocity();
+    batch.w_ang_vels_deg_s[i] = FMath::RadiansToDegrees(
+        body->GetUnrealWorldAngularVelocityInRadians());
+    batch.flags[i] = body->IsInstanceAwake() ? ERigidBodyFlags::None : ERigidBodyFlags::Sleeping;
+  }
+}
+
+//! @brief Teleports all bodies in a batch to their states in the batch.
+//!
+//! The physics scene lock is taken once for all simulating bodies. Bodies that aren't simulating,
+//! or that live in a different scene, fall back to FBodyInstance::SetBodyTransform().
+//!
+//! @param batch The batch to write from.
+static void writeRigidBodyStates(const RigidBodyStateBatch& batch) {
+  FPhysScene* scene = getBatchPhysicsScene(batch);
+  if (scene == nullptr) {
     return;
   }
 
-  states.SetNum(smc->Bodies.Num());
-  for (int i = 0; i < smc->Bodies.Num(); i++) {
-    FBodyInstance* body = smc->Bodies[i];
-    if (body == nullptr || !body->IsValidBodyInstance()) {
-      states[i] = FRigidBodyState();
-      continue;
+  TArray<int32, TInlineAllocator<8>> unlocked_indices;
+  FPhysicsCommand::ExecuteWrite(scene, [&]() {
+    for (int32 i = 0; i < batch.num(); i++) {
+      FBodyInstance* body = batch.bodies[i];
+      if (body == nullptr || !body->IsValidBodyInstance()) {
+        continue;
+      }
+
+      const FPhysicsActorHandle& handle = body->GetPhysicsActorHandle();
+      if (!body->IsInstanceSimulatingPhysics() || body->GetPhysicsScene() != scene ||
+          !FPhysicsInterface::IsValid(handle)) {
+        unlocked_indices.Add(i);
+        continue;
+      }
+
+      FPhysicsInterface::SetGlobalPose_AssumesLocked(handle,
+          FTransform(batch.w_orients[i], batch.w_positions_cm[i]));
+      FPhysicsInterface::SetLinearVelocity_AssumesLocked(handle, batch.w_lin_vels_cm_s[i]);
+      FPhysicsInterface::SetAngularVelocity_AssumesLocked(handle,
+          FMath::DegreesToRadians(batch.w_ang_vels_deg_s[i]));
     }
-    body->GetRigidBodyState(states[i]);
+  });
+
+  for (int32 i : unlocked_indices) {
+    FBodyInstance* body = batch.bodies[i];
+    body->SetBodyTransform(FTransform(batch.w_orients[i], batch.w_positions_cm[i]),
+        ETeleportType::TeleportPhysics);
+    body->SetLinearVelocity(batch.w_lin_vels_cm_s[i], false);
+    body->SetAngularVelocityInRadians(FMath::DegreesToRadians(batch.w_ang_vels_deg_s[i]), false);
   }
 }
 
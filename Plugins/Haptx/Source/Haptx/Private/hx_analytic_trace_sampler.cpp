@@ -0,0 +1,414 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#include <Haptx/Public/hx_analytic_trace_sampler.h>
+#include <Runtime/Engine/Classes/Components/PrimitiveComponent.h>
+#include <Runtime/Engine/Classes/Components/SkeletalMeshComponent.h>
+#include <Runtime/Engine/Classes/Components/StaticMeshComponent.h>
+#include <Runtime/Engine/Classes/PhysicsEngine/BodySetup.h>
+
+// Convex hulls with more vertices than this are swept individually since building their faces
+// from vertices alone scales with the fourth power of the vertex count.
+static const int32 MAX_CONVEX_VERTICES = 48;
+
+TMap<TPair<TWeakObjectPtr<UBodySetup>, int32>, HxAnalyticTraceSampler::ConvexPlanes>
+    HxAnalyticTraceSampler::convex_planes_;
+
+void HxAnalyticTraceSampler::gather(const TArray<FOverlapResult>& overlaps, bool trace_complex) {
+  trace_complex_ = trace_complex;
+  bodies_.Reset();
+  gathered_bodies_.Reset();
+  complex_components_.Reset();
+  w_sphere_centers_cm_.Reset();
+  w_sphere_radii_cm_.Reset();
+  sphere_bodies_.Reset();
+  w_capsule_centers_cm_.Reset();
+  w_capsule_axes_.Reset();
+  w_capsule_half_lengths_cm_.Reset();
+  w_capsule_radii_cm_.Reset();
+  capsule_bodies_.Reset();
+  w_box_centers_cm_.Reset();
+  w_box_orients_.Reset();
+  w_box_half_extents_cm_.Reset();
+  box_bodies_.Reset();
+  w_convex_planes_cm_.Reset();
+  convex_first_planes_.Reset();
+  convex_num_planes_.Reset();
+  convex_bodies_.Reset();
+
+  for (const FOverlapResult& overlap : overlaps) {
+    UPrimitiveComponent* component = overlap.GetComponent();
+    if (!IsValid(component)) {
+      continue;
+    }
+
+    // Overlaps with skeletal meshes are per body, and everything else has one body.
+    USkeletalMeshComponent* skeletal_mesh = Cast<USkeletalMeshComponent>(component);
+    if (skeletal_mesh != nullptr) {
+      if (skeletal_mesh->Bodies.IsValidIndex(overlap.ItemIndex)) {
+        FBodyInstance* body = skeletal_mesh->Bodies[overlap.ItemIndex];
+        if (body != nullptr && body->BodySetup.IsValid()) {
+          gatherBody(component, body,
+              skeletal_mesh->GetSocketTransform(body->BodySetup->BoneName));
+        }
+      }
+    } else {
+      gatherBody(component, component->GetBodyInstance(NAME_None, false),
+          component->GetComponentTransform());
+    }
+  }
+}
+
+void HxAnalyticTraceSampler::gatherBody(UPrimitiveComponent* component, FBodyInstance* body,
+    const FTransform& w_body) {
+  if (body == nullptr || gathered_bodies_.Contains(body)) {
+    return;
+  }
+  gathered_bodies_.Add(body);
+
+  UBodySetup* body_setup = body->BodySetup.Get();
+  if (body_setup == nullptr) {
+    return;
+  }
+
+  // Complex traces hit the render triangles of static meshes unless they're set to use simple
+  // collision for complex traces.
+  const ECollisionTraceFlag trace_flag = body_setup->GetCollisionTraceFlag();
+  const FKAggregateGeom& agg_geom = body_setup->AggGeom;
+  if (trace_flag == CTF_UseComplexAsSimple || agg_geom.GetElementCount() == 0 ||
+      (trace_complex_ && trace_flag != CTF_UseSimpleAsComplex &&
+      component->IsA<UStaticMeshComponent>())) {
+    complex_components_.AddUnique(component);
+    return;
+  }
+
+  // Convex hulls without cheap faces make the whole body fall back on SweepComponent().
+  TArray<const TArray<FPlane>*, TInlineAllocator<8>> l_convex_planes;
+  for (int32 i = 0; i < agg_geom.ConvexElems.Num(); i++) {
+    const TArray<FPlane>* planes = getConvexPlanes(body_setup, i, agg_geom.ConvexElems[i]);
+    if (planes == nullptr) {
+      complex_components_.AddUnique(component);
+      return;
+    }
+    l_convex_planes.Add(planes);
+  }
+
+  const int32 body_i = bodies_.Num();
+  bodies_.Add({component, body_setup->BoneName});
+  const FVector w_scale = w_body.GetScale3D().GetAbs();
+  const FQuat w_body_orient = w_body.GetRotation();
+
+  for (const FKSphereElem& elem : agg_geom.SphereElems) {
+    w_sphere_centers_cm_.Add(w_body.TransformPosition(elem.Center));
+    w_sphere_radii_cm_.Add(elem.Radius * w_scale.GetMin());
+    sphere_bodies_.Add(body_i);
+  }
+
+  for (const FKSphylElem& elem : agg_geom.SphylElems) {
+    w_capsule_centers_cm_.Add(w_body.TransformPosition(elem.Center));
+    w_capsule_axes_.Add((w_body_orient * elem.Rotation.Quaternion()).GetAxisZ());
+    w_capsule_half_lengths_cm_.Add(0.5f * elem.Length * w_scale.Z);
+    w_capsule_radii_cm_.Add(elem.Radius * FMath::Min(w_scale.X, w_scale.Y));
+    capsule_bodies_.Add(body_i);
+  }
+
+  for (const FKBoxElem& elem : agg_geom.BoxElems) {
+    w_box_centers_cm_.Add(w_body.TransformPosition(elem.Center));
+    w_box_orients_.Add(w_body_orient * elem.Rotation.Quaternion());
+    w_box_half_extents_cm_.Add(0.5f * FVector(elem.X, elem.Y, elem.Z) * w_scale);
+    box_bodies_.Add(body_i);
+  }
+
+  for (int32 i = 0; i < agg_geom.ConvexElems.Num(); i++) {
+    // Planes transform by the inverse transpose of the element's scale.
+    const FTransform w_elem = agg_geom.ConvexElems[i].GetTransform() * w_body;
+    const FVector w_elem_scale = w_elem.GetScale3D();
+    convex_first_planes_.Add(w_convex_planes_cm_.Num());
+    convex_num_planes_.Add(l_convex_planes[i]->Num());
+    convex_bodies_.Add(body_i);
+    for (const FPlane& l_plane : *l_convex_planes[i]) {
+      const FVector l_normal(l_plane.X, l_plane.Y, l_plane.Z);
+      const FVector w_normal =
+          w_elem.GetRotation().RotateVector(l_normal / w_elem_scale).GetSafeNormal();
+      const FVector w_point_cm = w_elem.TransformPosition(l_plane.W * l_normal);
+      w_convex_planes_cm_.Add(FPlane(w_normal, FVector::DotProduct(w_normal, w_point_cm)));
+    }
+  }
+}
+
+const TArray<FPlane>* HxAnalyticTraceSampler::getConvexPlanes(UBodySetup* body_setup,
+    int32 elem_i, const FKConvexElem& elem) {
+  const TArray<FVector>& vertices = elem.VertexData;
+  ConvexPlanes& convex_planes = convex_planes_.FindOrAdd(TPair<TWeakObjectPtr<UBodySetup>, int32>(
+      body_setup, elem_i));
+  if (convex_planes.num_vertices == vertices.Num()) {
+    return convex_planes.planes.Num() > 0 ? &convex_planes.planes : nullptr;
+  }
+
+  convex_planes.num_vertices = vertices.Num();
+  convex_planes.planes.Reset();
+  if (vertices.Num() < 4 || vertices.Num() > MAX_CONVEX_VERTICES) {
+    return nullptr;
+  }
+
+  // Every face of the hull passes through three of its vertices with all the others on one side.
+  const float tolerance_cm = 1.0e-3f * FMath::Max(elem.ElemBox.GetExtent().GetMax(), 1.0f);
+  for (int32 i = 0; i < vertices.Num(); i++) {
+    for (int32 j = i + 1; j < vertices.Num(); j++) {
+      for (int32 k = j + 1; k < vertices.Num(); k++) {
+        FVector normal = FVector::CrossProduct(vertices[j] - vertices[i],
+            vertices[k] - vertices[i]);
+        if (!normal.Normalize()) {
+          continue;
+        }
+
+        float w = FVector::DotProduct(normal, vertices[i]);
+        bool any_above = false;
+        bool any_below = false;
+        for (const FVector& vertex : vertices) {
+          const float height_cm = FVector::DotProduct(normal, vertex) - w;
+          any_above |= height_cm > tolerance_cm;
+          any_below |= height_cm < -tolerance_cm;
+        }
+        if (any_above == any_below) {
+          continue;
+        }
+        if (any_above) {
+          normal = -normal;
+          w = -w;
+        }
+
+        bool is_duplicate = false;
+        for (const FPlane& plane : convex_planes.planes) {
+          is_duplicate |= FVector::DotProduct(normal, FVector(plane.X, plane.Y, plane.Z)) >
+              1.0f - KINDA_SMALL_NUMBER && FMath::Abs(w - plane.W) < tolerance_cm;
+        }
+        if (!is_duplicate) {
+          convex_planes.planes.Add(FPlane(normal, w));
+        }
+      }
+    }
+  }
+
+  return convex_planes.planes.Num() > 0 ? &convex_planes.planes : nullptr;
+}
+
+bool HxAnalyticTraceSampler::sweep(const FVector& w_start_cm, const FVector& w_end_cm,
+    const FCollisionShape& sphere, FHitResult& hit) const {
+  FVector w_direction;
+  float length_cm;
+  (w_end_cm - w_start_cm).ToDirectionAndLength(w_direction, length_cm);
+  if (length_cm < KINDA_SMALL_NUMBER) {
+    return false;
+  }
+  const float r_cm = sphere.GetSphereRadius();
+
+  // The nearest hit so far.
+  float best_distance_cm = length_cm;
+  int32 best_body_i = INDEX_NONE;
+  FVector best_normal = FVector::ZeroVector;
+
+  // Spheres, inflated by the sweep radius.
+  for (int32 i = 0; i < w_sphere_centers_cm_.Num(); i++) {
+    const FVector m = w_start_cm - w_sphere_centers_cm_[i];
+    const float radius_cm = w_sphere_radii_cm_[i] + r_cm;
+    const float b = FVector::DotProduct(m, w_direction);
+    const float c = m.SizeSquared() - radius_cm * radius_cm;
+    const float discriminant = b * b - c;
+    if (c > 0.0f && (b > 0.0f || discriminant < 0.0f)) {
+      continue;
+    }
+
+    const float distance_cm = c <= 0.0f ? 0.0f : -b - FMath::Sqrt(discriminant);
+    if (distance_cm < best_distance_cm) {
+      best_distance_cm = distance_cm;
+      best_body_i = sphere_bodies_[i];
+      best_normal = c <= 0.0f ? -w_direction : (m + distance_cm * w_direction) / radius_cm;
+    }
+  }
+
+  // Capsules, inflated by the sweep radius: a cylinder wall and two end spheres.
+  for (int32 i = 0; i < w_capsule_centers_cm_.Num(); i++) {
+    const FVector& axis = w_capsule_axes_[i];
+    const float half_length_cm = w_capsule_half_lengths_cm_[i];
+    const float radius_cm = w_capsule_radii_cm_[i] + r_cm;
+    const FVector m = w_start_cm - w_capsule_centers_cm_[i];
+    const float m_axial = FVector::DotProduct(m, axis);
+    const float d_axial = FVector::DotProduct(w_direction, axis);
+    const FVector m_radial = m - m_axial * axis;
+    const FVector d_radial = w_direction - d_axial * axis;
+
+    const float a = d_radial.SizeSquared();
+    const float b = FVector::DotProduct(m_radial, d_radial);
+    const float c = m_radial.SizeSquared() - radius_cm * radius_cm;
+    float distance_cm = MAX_flt;
+    FVector normal = FVector::ZeroVector;
+    if (c <= 0.0f && FMath::Abs(m_axial) <= half_length_cm) {
+      distance_cm = 0.0f;
+      normal = -w_direction;
+    } else if (a > KINDA_SMALL_NUMBER && b < 0.0f && b * b - a * c >= 0.0f) {
+      const float t = (-b - FMath::Sqrt(b * b - a * c)) / a;
+      if (t >= 0.0f && FMath::Abs(m_axial + t * d_axial) <= half_length_cm) {
+        distance_cm = t;
+        normal = (m_radial + t * d_radial) / radius_cm;
+      }
+    }
+    if (distance_cm == MAX_flt) {
+      for (float end_sign : {-1.0f, 1.0f}) {
+        const FVector m_end = m - end_sign * half_length_cm * axis;
+        const float b_end = FVector::DotProduct(m_end, w_direction);
+        const float c_end = m_end.SizeSquared() - radius_cm * radius_cm;
+        const float discriminant = b_end * b_end - c_end;
+        if (c_end > 0.0f && (b_end > 0.0f || discriminant < 0.0f)) {
+          continue;
+        }
+
+        const float t = c_end <= 0.0f ? 0.0f : -b_end - FMath::Sqrt(discriminant);
+        if (t < distance_cm) {
+          distance_cm = t;
+          normal = c_end <= 0.0f ? -w_direction : (m_end + t * w_direction) / radius_cm;
+        }
+      }
+    }
+
+    if (distance_cm < best_distance_cm) {
+      best_distance_cm = distance_cm;
+      best_body_i = capsule_bodies_[i];
+      best_normal = normal;
+    }
+  }
+
+  // Boxes, inflated by the sweep radius. Slab test in each box's frame.
+  for (int32 i = 0; i < w_box_centers_cm_.Num(); i++) {
+    const FQuat& orient = w_box_orients_[i];
+    const FVector half_extents_cm = w_box_half_extents_cm_[i] + FVector(r_cm);
+    const FVector b_start_cm = orient.UnrotateVector(w_start_cm - w_box_centers_cm_[i]);
+    const FVector b_direction = orient.UnrotateVector(w_direction);
+
+    float t_enter = -MAX_flt;
+    float t_exit = MAX_flt;
+    int32 enter_axis = INDEX_NONE;
+    float enter_sign = 0.0f;
+    bool is_miss = false;
+    for (int32 axis = 0; axis < 3 && !is_miss; axis++) {
+      const float s = b_start_cm[axis];
+      const float d = b_direction[axis];
+      const float e = half_extents_cm[axis];
+      if (FMath::Abs(d) < KINDA_SMALL_NUMBER) {
+        is_miss = s < -e || s > e;
+        continue;
+      }
+
+      float t_near = (-e - s) / d;
+      float t_far = (e - s) / d;
+      float sign = -1.0f;
+      if (t_near > t_far) {
+        Swap(t_near, t_far);
+        sign = 1.0f;
+      }
+      if (t_near > t_enter) {
+        t_enter = t_near;
+        enter_axis = axis;
+        enter_sign = sign;
+      }
+      t_exit = FMath::Min(t_exit, t_far);
+      is_miss = t_enter > t_exit || t_exit < 0.0f;
+    }
+    if (is_miss) {
+      continue;
+    }
+
+    const float distance_cm = FMath::Max(t_enter, 0.0f);
+    if (distance_cm < best_distance_cm) {
+      best_distance_cm = distance_cm;
+      best_body_i = box_bodies_[i];
+      if (t_enter <= 0.0f || enter_axis == INDEX_NONE) {
+        best_normal = -w_direction;
+      } else {
+        FVector b_normal = FVector::ZeroVector;
+        b_normal[enter_axis] = enter_sign;
+        best_normal = orient.RotateVector(b_normal);
+      }
+    }
+  }
+
+  // Convex hulls, inflated by the sweep radius. Clip the sweep against each face.
+  for (int32 i = 0; i < convex_first_planes_.Num(); i++) {
+    const FPlane* planes = w_convex_planes_cm_.GetData() + convex_first_planes_[i];
+    float t_enter = 0.0f;
+    float t_exit = length_cm;
+    int32 enter_plane = INDEX_NONE;
+    bool is_miss = false;
+    for (int32 p = 0; p < convex_num_planes_[i] && !is_miss; p++) {
+      const FVector normal(planes[p].X, planes[p].Y, planes[p].Z);
+      const float height_cm = FVector::DotProduct(normal, w_start_cm) - planes[p].W - r_cm;
+      const float d = FVector::DotProduct(normal, w_direction);
+      if (FMath::Abs(d) < KINDA_SMALL_NUMBER) {
+        is_miss = height_cm > 0.0f;
+        continue;
+      }
+
+      const float t = -height_cm / d;
+      if (d < 0.0f) {
+        if (t > t_enter) {
+          t_enter = t;
+          enter_plane = p;
+        }
+      } else {
+        t_exit = FMath::Min(t_exit, t);
+      }
+      is_miss = t_enter > t_exit;
+    }
+    if (is_miss || t_enter >= best_distance_cm) {
+      continue;
+    }
+
+    best_distance_cm = t_enter;
+    best_body_i = convex_bodies_[i];
+    best_normal = enter_plane == INDEX_NONE ? -w_direction :
+        FVector(planes[enter_plane].X, planes[enter_plane].Y, planes[enter_plane].Z);
+  }
+
+  bool is_hit = best_body_i != INDEX_NONE;
+  if (is_hit) {
+    makeHit(best_body_i, w_start_cm, w_end_cm, w_direction, r_cm, best_distance_cm, best_normal,
+        hit);
+  }
+
+  // Bodies without usable simple collision get a narrow phase sweep of their own.
+  FHitResult complex_hit;
+  for (const TWeakObjectPtr<UPrimitiveComponent>& component_ptr : complex_components_) {
+    UPrimitiveComponent* component = component_ptr.Get();
+    if (IsValid(component) && component->SweepComponent(complex_hit, w_start_cm, w_end_cm,
+        FQuat::Identity, sphere, trace_complex_) &&
+        (!is_hit || complex_hit.Distance < hit.Distance)) {
+      hit = complex_hit;
+      is_hit = true;
+    }
+  }
+
+  return is_hit;
+}
+
+void HxAnalyticTraceSampler::makeHit(int32 body_i, const FVector& w_start_cm,
+    const FVector& w_end_cm, const FVector& w_direction, float w_radius_cm, float distance_cm,
+    const FVector& w_normal, FHitResult& hit) const {
+  const Body& body = bodies_[body_i];
+  UPrimitiveComponent* component = body.component.Get();
+  hit = FHitResult();
+  hit.bBlockingHit = true;
+  hit.bStartPenetrating = distance_cm <= 0.0f;
+  hit.Component = component;
+  hit.Actor = component != nullptr ? component->GetOwner() : nullptr;
+  hit.BoneName = body.bone;
+  hit.TraceStart = w_start_cm;
+  hit.TraceEnd = w_end_cm;
+  hit.Distance = distance_cm;
+  hit.Time = distance_cm / FVector::Dist(w_start_cm, w_end_cm);
+  hit.Location = w_start_cm + distance_cm * w_direction;
+  hit.Normal = w_normal;
+  hit.ImpactNormal = w_normal;
+  hit.ImpactPoint = hit.Location - w_radius_cm * w_normal;
+  hit.FaceIndex = INDEX_NONE;
+}
@@ -0,0 +1,75 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#include <Haptx/Public/hx_benchmark_stats.h>
+
+bool HxBenchmarkStats::is_enabled_ = false;
+double HxBenchmarkStats::time_s_[static_cast<int>(HxBenchmarkStat::LAST)] = {};
+int64 HxBenchmarkStats::physics_state_bytes_ = 0;
+int64 HxBenchmarkStats::oscillator_hits_ = 0;
+int64 HxBenchmarkStats::oscillator_misses_ = 0;
+
+void HxBenchmarkStats::setEnabled(bool enabled) {
+  is_enabled_ = enabled;
+}
+
+void HxBenchmarkStats::reset() {
+  for (double& time_s : time_s_) {
+    time_s = 0.0;
+  }
+  physics_state_bytes_ = 0;
+  oscillator_hits_ = 0;
+  oscillator_misses_ = 0;
+}
+
+void HxBenchmarkStats::addTime(HxBenchmarkStat stat, double time_s) {
+  if (stat < HxBenchmarkStat::LAST) {
+    time_s_[static_cast<int>(stat)] += time_s;
+  }
+}
+
+void HxBenchmarkStats::addPhysicsStateBytes(int64 num_bytes) {
+  physics_state_bytes_ += num_bytes;
+}
+
+void HxBenchmarkStats::addOscillatorSample(bool hit) {
+  if (hit) {
+    oscillator_hits_++;
+  } else {
+    oscillator_misses_++;
+  }
+}
+
+double HxBenchmarkStats::getTime(HxBenchmarkStat stat) {
+  return stat < HxBenchmarkStat::LAST ? time_s_[static_cast<int>(stat)] : 0.0;
+}
+
+int64 HxBenchmarkStats::getPhysicsStateBytes() {
+  return physics_state_bytes_;
+}
+
+int64 HxBenchmarkStats::getOscillatorHits() {
+  return oscillator_hits_;
+}
+
+int64 HxBenchmarkStats::getOscillatorMisses() {
+  return oscillator_misses_;
+}
+
+const TCHAR* HxBenchmarkStats::toString(HxBenchmarkStat stat) {
+  switch (stat) {
+  case HxBenchmarkStat::HAND_TICK:
+    return TEXT("hand_tick");
+  case HxBenchmarkStat::PATCH_TRACES:
+    return TEXT("patch_traces");
+  case HxBenchmarkStat::CORE_UPDATE:
+    return TEXT("core_update");
+  case HxBenchmarkStat::GRASP_UPDATE:
+    return TEXT("grasp_update");
+  case HxBenchmarkStat::SPATIAL_EFFECTS:
+    return TEXT("spatial_effects");
+  default:
+    return TEXT("unknown");
+  }
+}
@@ -0,0 +1,159 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#include <Haptx/Public/hx_collision_uv_sampler.h>
+#include <Runtime/Engine/Classes/Components/StaticMeshComponent.h>
+#include <Runtime/Engine/Classes/Engine/StaticMesh.h>
+#include <Runtime/Engine/Classes/Engine/World.h>
+#include <Runtime/Engine/Public/StaticMeshResources.h>
+#include <Haptx/Private/haptx_shared.h>
+#include <Haptx/Public/hx_core_actor.h>
+#include <Haptx/Public/hx_physical_material.h>
+
+TMap<TWeakObjectPtr<UStaticMesh>, TSharedPtr<const HxCollisionUvSampler::MeshUvTable>>
+    HxCollisionUvSampler::table_from_mesh_;
+TMap<TWeakObjectPtr<UPrimitiveComponent>, HxCollisionUvSampler::ComponentEntry>
+    HxCollisionUvSampler::entry_from_component_;
+int32 HxCollisionUvSampler::num_entries_after_prune_ = 0;
+FDelegateHandle HxCollisionUvSampler::world_cleanup_handle_;
+
+bool HxCollisionUvSampler::sample(const FHitResult& hit, const TArray<int32>& uv_channels,
+    TArray<FVector2D>& uvs) {
+  uvs.Reset();
+
+  UPrimitiveComponent* component = hit.Component.Get();
+  if (!IsValid(component) || hit.FaceIndex < 0 || uv_channels.Num() == 0) {
+    return false;
+  }
+
+  const MeshUvTable* table = getTable(component);
+  if (table == nullptr || hit.FaceIndex >= table->num_faces) {
+    return false;
+  }
+
+  const FVector l_point_cm =
+      component->GetComponentTransform().InverseTransformPosition(hit.ImpactPoint);
+  const int32 corner_i = 3 * hit.FaceIndex;
+  const FVector barycentric = FMath::ComputeBaryCentric2D(l_point_cm,
+      table->l_positions_cm[corner_i], table->l_positions_cm[corner_i + 1],
+      table->l_positions_cm[corner_i + 2]);
+  for (int32 uv_channel : uv_channels) {
+    if (uv_channel < 0 || uv_channel >= table->num_uv_channels) {
+      continue;
+    }
+
+    const FVector2D* corner_uvs = table->uvs.GetData() + corner_i * table->num_uv_channels;
+    uvs.Add(barycentric.X * corner_uvs[uv_channel] +
+        barycentric.Y * corner_uvs[table->num_uv_channels + uv_channel] +
+        barycentric.Z * corner_uvs[2 * table->num_uv_channels + uv_channel]);
+  }
+
+  return uvs.Num() > 0;
+}
+
+const HxCollisionUvSampler::MeshUvTable* HxCollisionUvSampler::getTable(
+    UPrimitiveComponent* component) {
+  UStaticMeshComponent* smc = Cast<UStaticMeshComponent>(component);
+  UStaticMesh* mesh = IsValid(smc) ? smc->GetStaticMesh() : nullptr;
+
+  ComponentEntry* entry = entry_from_component_.Find(component);
+  if (entry != nullptr && entry->mesh.Get() == mesh) {
+    return entry->table.Get();
+  }
+
+  if (!world_cleanup_handle_.IsValid()) {
+    world_cleanup_handle_ =
+        FWorldDelegates::OnWorldCleanup.AddStatic(&HxCollisionUvSampler::onWorldCleanup);
+  }
+  pruneIfGrown();
+
+  TSharedPtr<const MeshUvTable> table = nullptr;
+  UHxPhysicalMaterial* material =
+      Cast<UHxPhysicalMaterial>(getPhysicalMaterial(component, NAME_None));
+  if (mesh != nullptr && IsValid(material) && material->sample_uvs_) {
+    TSharedPtr<const MeshUvTable>* mesh_table = table_from_mesh_.Find(mesh);
+    table = mesh_table != nullptr ? *mesh_table : table_from_mesh_.Add(mesh, buildTable(mesh));
+  }
+
+  ComponentEntry& new_entry = entry_from_component_.Add(component);
+  new_entry.mesh = mesh;
+  new_entry.table = table;
+  return table.Get();
+}
+
+void HxCollisionUvSampler::pruneIfGrown() {
+  // The fewest entries worth pruning.
+  const int32 MIN_ENTRIES_TO_PRUNE = 64;
+
+  const int32 num_entries = entry_from_component_.Num() + table_from_mesh_.Num();
+  if (num_entries < FMath::Max(MIN_ENTRIES_TO_PRUNE, 2 * num_entries_after_prune_)) {
+    return;
+  }
+
+  for (auto it = entry_from_component_.CreateIterator(); it; ++it) {
+    if (!it.Key().IsValid() || it.Value().mesh.IsStale()) {
+      it.RemoveCurrent();
+    }
+  }
+  for (auto it = table_from_mesh_.CreateIterator(); it; ++it) {
+    if (!it.Key().IsValid()) {
+      it.RemoveCurrent();
+    }
+  }
+  num_entries_after_prune_ = entry_from_component_.Num() + table_from_mesh_.Num();
+}
+
+void HxCollisionUvSampler::onWorldCleanup(UWorld* world, bool session_ended,
+    bool cleanup_resources) {
+  entry_from_component_.Empty();
+  table_from_mesh_.Empty();
+  num_entries_after_prune_ = 0;
+}
+
+TSharedPtr<const HxCollisionUvSampler::MeshUvTable> HxCollisionUvSampler::buildTable(
+    UStaticMesh* mesh) {
+  if (mesh == nullptr || mesh->RenderData == nullptr ||
+      mesh->RenderData->LODResources.Num() == 0) {
+    return nullptr;
+  }
+
+  // Match the triangle order UStaticMesh::GetPhysicsTriMeshData() cooks so face indices from hits
+  // line up.
+  const int32 lod_i = FMath::Clamp(mesh->LODForCollision, 0,
+      mesh->RenderData->LODResources.Num() - 1);
+  const FStaticMeshLODResources& lod = mesh->RenderData->LODResources[lod_i];
+  const FPositionVertexBuffer& positions = lod.VertexBuffers.PositionVertexBuffer;
+  const FStaticMeshVertexBuffer& vertices = lod.VertexBuffers.StaticMeshVertexBuffer;
+  FIndexArrayView indices = lod.IndexBuffer.GetArrayView();
+  if (positions.GetVertexData() == nullptr || vertices.GetTexCoordData() == nullptr ||
+      indices.Num() == 0) {
+    AHxCoreActor::logWarning(FString::Printf(TEXT(
+        "HxCollisionUvSampler::buildTable(): %s has no CPU copy of its mesh data. Enable "
+        "\"Allow CPU Access\" on it to sample UVs."), *mesh->GetName()));
+    return nullptr;
+  }
+
+  TSharedPtr<MeshUvTable> table = MakeShared<MeshUvTable>();
+  table->num_uv_channels = vertices.GetNumTexCoords();
+  for (const FStaticMeshSection& section : lod.Sections) {
+    if (!section.bEnableCollision) {
+      continue;
+    }
+
+    const int32 first_corner_i = static_cast<int32>(section.FirstIndex);
+    const int32 num_corners = 3 * static_cast<int32>(section.NumTriangles);
+    table->l_positions_cm.Reserve(table->l_positions_cm.Num() + num_corners);
+    table->uvs.Reserve(table->uvs.Num() + num_corners * table->num_uv_channels);
+    for (int32 i = first_corner_i; i < first_corner_i + num_corners; i++) {
+      const uint32 vertex_i = indices[i];
+      table->l_positions_cm.Add(positions.VertexPosition(vertex_i));
+      for (int32 uv_channel = 0; uv_channel < table->num_uv_channels; uv_channel++) {
+        table->uvs.Add(vertices.GetVertexUV(vertex_i, uv_channel));
+      }
+    }
+  }
+  table->num_faces = table->l_positions_cm.Num() / 3;
+
+  return table;
+}
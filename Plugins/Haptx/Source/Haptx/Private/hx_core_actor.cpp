@@ -3,6 +3,8 @@
 // The contents of this file are proprietary and confidential.
 
 #include <Haptx/Public/hx_core_actor.h>
+#include <algorithm>
+#include <functional>
 #include <Runtime/Engine/Classes/Kismet/GameplayStatics.h>
 #include <Runtime/Engine/Classes/Kismet/KismetMathLibrary.h>
 #include <Runtime/Engine/Classes/Kismet/KismetStringLibrary.h>
@@ -10,14 +12,21 @@
 #include <Runtime/Engine/Public/Net/UnrealNetwork.h>
 #include <HaptxApi/direct_pneumatic_calculator.h>
 #include <Haptx/Private/haptx_shared.h>
+#include <Haptx/Public/hx_benchmark_stats.h>
 #include <Haptx/Public/hx_debug_draw_system.h>
 #include <Haptx/Public/hx_hand_actor.h>
+#include <Haptx/Public/hx_oscillator_bank.h>
+#include <Haptx/Public/hx_patch_component.h>
 #include <Haptx/Public/hx_simulation_callbacks.h>
+#include <Haptx/Public/hx_spatial_effect_component.h>
+#include <Haptx/Public/hx_user_profile_service.h>
 
 DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("HxCore::Tick"),
     STAT_Tick, STATGROUP_HxCore)
 DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("HxCore::core_::update"),
     STAT_core_update, STATGROUP_HxCore)
+DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("HxCore::updateSpatialEffectRegistration"),
+    STAT_updateSpatialEffectRegistration, STATGROUP_HxCore)
 DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("HxCore::updateGrasps"),
     STAT_updateGrasps, STATGROUP_HxCore)
 DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("HxCore::visualizeGrasps"),
@@ -27,6 +36,9 @@ DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("HxCore::registerObjectIfNotAlready - CI"),
 DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("HxCore::registerObjectIfNotAlready - GD"),
     STAT_registerObjectIfNotAlready_GD, STATGROUP_HxCore)
 
+//! How far beyond a body's bounds spatial effects get registered for it [cm].
+constexpr float SPATIAL_EFFECT_BODY_MARGIN_CM = 1.0f;
+
 void FHxCoreGlobalFirstTickFunction::ExecuteTick(
     float DeltaTime,
     ELevelTick TickType,
@@ -52,11 +64,19 @@ AHxCoreActor::AHxCoreActor(const FObjectInitializer& object_initializer) :
     toggle_network_state_vis_action_(TEXT("HxToggleNetworkStateVis")),
     enable_tactile_feedback_(true), enable_force_feedback_(true), enable_grasping_(true),
     grasp_threshold_(18.0f), release_hysteresis_(0.75f),
-    physics_authority_mode_(EPhysicsAuthorityMode::SERVER), display_on_screen_messages_(true),
+    physics_authority_mode_(EPhysicsAuthorityMode::SERVER), user_profile_refresh_period_s_(5.0f),
+    display_on_screen_messages_(true),
     min_severity_(EOnScreenMessageSeverity::INFO), text_size_(4.0f), max_line_length_(80u),
     left_margin_(0.33f), top_margin_(0.33f), haptx_system_(),
     initialize_haptx_system_attempted_(false), initialize_haptx_system_result_(false),
-    contact_interpreter_(), hsv_controller_from_air_controller_id_(), haptx_log_messages_() {
+    contact_interpreter_(), hsv_controller_from_air_controller_id_(), haptx_log_messages_(),
+    patches_awaiting_parallel_traces_(), hands_awaiting_contact_flush_(),
+    tactile_trace_object_params_(),
+    tactile_trace_object_params_built_(false), tactile_trace_query_params_(),
+    tactile_trace_budget_frame_(0u),
+    tactile_trace_priority_threshold_(0.0f), tactile_traces_remaining_(0),
+    tactile_trace_demand_(), spatial_effect_index_(), ci_spatial_effects_(),
+    nearby_spatial_effects_(), ci_body_components_() {
   PrimaryActorTick.bCanEverTick = true;
   // Tick after all other tick logic in the game has completed
   SetTickGroup(ETickingGroup::TG_PostPhysics);
@@ -120,6 +140,8 @@ void AHxCoreActor::BeginPlay() {
   }
 
   HxDebugDrawSystem::open();
+  HxUserProfileService::requestLoad();
+  time_of_last_user_profile_refresh_s_ = GetWorld()->GetTimeSeconds();
   AHxOnScreenLog* on_screen_log = AHxOnScreenLog::getInstance(GetWorld());
   if (IsValid(on_screen_log)) {
     on_screen_log->display_on_screen_messages_ = display_on_screen_messages_;
@@ -168,14 +190,39 @@ void AHxCoreActor::Tick(float delta_seconds) {
   // Print out any System Log messages we know about
   printLogMessages();
 
+  // Pick up changes to the active user profile without blocking the game thread.
+  float time_s = GetWorld()->GetTimeSeconds();
+  if (user_profile_refresh_period_s_ > 0.0f &&
+      time_s - time_of_last_user_profile_refresh_s_ > user_profile_refresh_period_s_) {
+    HxUserProfileService::refresh();
+    time_of_last_user_profile_refresh_s_ = time_s;
+  }
+
+  // Patch traces queued this frame feed this update.
+  if (patches_awaiting_parallel_traces_.Num() > 0) {
+    UHxPatchComponent::traceInParallel(patches_awaiting_parallel_traces_);
+    patches_awaiting_parallel_traces_.Reset();
+  }
+
+  // Hand contacts gathered during physics feed this update as well.
+  for (const TWeakObjectPtr<AHxHandActor>& hand : hands_awaiting_contact_flush_) {
+    if (hand.IsValid()) {
+      hand->flushContacts();
+    }
+  }
+  hands_awaiting_contact_flush_.Reset();
+
   // Skip tick if nothing opened
   if (!isHaptxSystemInitialized()) {
     return;
   }
+  updateSpatialEffectRegistration(physics_delta_time_s_);
   {
     SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_core_update)
+    HX_BENCHMARK_SCOPE(CORE_UPDATE)
     HaptxApi::AirController::maintainComms();
     std::unordered_map<HaptxApi::HaptxUuid, HaptxApi::HapticFrame> haptic_frames;
+    HxOscillatorBank::advance(physics_delta_time_s_);
     contact_interpreter_.commit(physics_delta_time_s_, &haptic_frames);
     for (auto& air_controller : haptx_system_.getDk2AirControllers()) {
       if (air_controller == nullptr) {
@@ -484,6 +531,7 @@ void AHxCoreActor::toggleNetworkStateVisualizer() {
 
 void AHxCoreActor::updateGrasps(float delta_seconds) {
   SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_updateGrasps)
+  HX_BENCHMARK_SCOPE(GRASP_UPDATE)
   // Execute any actions recommended by the HaptxApi::GraspDetector.
   grasp_detector_.detectGrasps(delta_seconds);
   for (auto grasp_event = grasp_detector_.getGraspHistory().begin();
@@ -1015,6 +1063,222 @@ bool AHxCoreActor::tryRegisterObjectWithCi(UPrimitiveComponent* comp, FName bone
   return true;
 }
 
+void AHxCoreActor::queueParallelTraces(UHxPatchComponent* patch) {
+  if (IsValid(patch)) {
+    patches_awaiting_parallel_traces_.Add(patch);
+  }
+}
+
+void AHxCoreActor::queueContactFlush(AHxHandActor* hand) {
+  if (IsValid(hand)) {
+    hands_awaiting_contact_flush_.AddUnique(hand);
+  }
+}
+
+const FCollisionObjectQueryParams& AHxCoreActor::getTactileTraceObjectParams() {
+  if (!tactile_trace_object_params_built_) {
+    updateTactileTraceObjectParams();
+  }
+  return tactile_trace_object_params_;
+}
+
+void AHxCoreActor::updateTactileTraceObjectParams() {
+  tactile_trace_object_params_ = FCollisionObjectQueryParams();
+  if (allow_tactile_feedback_collision_type_whitelist_) {
+    for (auto type : tactile_feedback_collision_types_) {
+      tactile_trace_object_params_.AddObjectTypesToQuery(type);
+    }
+  } else {
+    for (EObjectTypeQuery type = ObjectTypeQuery1; type != ObjectTypeQuery_MAX; ++((int&)(type))) {
+      tactile_trace_object_params_.AddObjectTypesToQuery(
+          UEngineTypes::ConvertToCollisionChannel(type));
+    }
+  }
+  tactile_trace_object_params_built_ = true;
+}
+
+TSharedPtr<const FCollisionQueryParams> AHxCoreActor::getTactileTraceQueryParams(AActor* owner,
+    bool trace_complex) {
+  if (!IsValid(owner)) {
+    return nullptr;
+  }
+
+  return findOrAddTactileTraceQueryParams(owner, trace_complex);
+}
+
+void AHxCoreActor::ignoreActorInTactileTraces(AActor* owner, AActor* actor) {
+  if (!IsValid(owner) || !IsValid(actor)) {
+    return;
+  }
+
+  // Changes apply in place so every patch sharing the parameters sees them.
+  for (bool trace_complex : {false, true}) {
+    TSharedPtr<FCollisionQueryParams> query_params =
+        findOrAddTactileTraceQueryParams(owner, trace_complex);
+    if (!query_params->GetIgnoredActors().Contains(actor->GetUniqueID())) {
+      query_params->AddIgnoredActor(actor);
+    }
+  }
+}
+
+TSharedPtr<FCollisionQueryParams> AHxCoreActor::findOrAddTactileTraceQueryParams(AActor* owner,
+    bool trace_complex) {
+  const TPair<TWeakObjectPtr<AActor>, bool> key(owner, trace_complex);
+  TSharedPtr<FCollisionQueryParams>* query_params = tactile_trace_query_params_.Find(key);
+  if (query_params != nullptr) {
+    return *query_params;
+  }
+
+  // Drop the parameters of actors that have since been destroyed.
+  for (auto it = tactile_trace_query_params_.CreateIterator(); it; ++it) {
+    if (!it->Key.Key.IsValid()) {
+      it.RemoveCurrent();
+    }
+  }
+
+  TSharedPtr<FCollisionQueryParams> new_query_params = MakeShared<FCollisionQueryParams>(
+      SCENE_QUERY_STAT(HxPatchObjectTrace), trace_complex);
+  new_query_params->bReturnFaceIndex = !UPhysicsSettings::Get()->bSuppressFaceRemapTable;
+  new_query_params->bReturnPhysicalMaterial = true;
+  new_query_params->AddIgnoredActor(owner);
+  tactile_trace_query_params_.Add(key, new_query_params);
+  return new_query_params;
+}
+
+bool AHxCoreActor::isTactileTraceBudgetEnabled() const {
+  return tactile_trace_budget_ > 0;
+}
+
+float AHxCoreActor::getCoverageRegionTracePriority(const FString& coverage_region) const {
+  float priority = 0.0f;
+  bool matched = false;
+  for (const auto& key_and_priority : coverage_region_trace_priorities_) {
+    if (coverage_region.Contains(key_and_priority.Key)) {
+      priority = matched ? FMath::Max(priority, key_and_priority.Value) : key_and_priority.Value;
+      matched = true;
+    }
+  }
+
+  return matched ? priority : 1.0f;
+}
+
+int32 AHxCoreActor::claimTactileTraces(const TArray<float>& priorities) {
+  if (!isTactileTraceBudgetEnabled()) {
+    return priorities.Num();
+  }
+
+  updateTactileTraceBudgetFrame();
+  tactile_trace_demand_.Append(priorities);
+  int32 num_eligible = 0;
+  for (float priority : priorities) {
+    if (priority >= tactile_trace_priority_threshold_) {
+      num_eligible++;
+    }
+  }
+
+  const int32 num_claimed = FMath::Min(num_eligible, tactile_traces_remaining_);
+  tactile_traces_remaining_ -= num_claimed;
+  return num_claimed;
+}
+
+void AHxCoreActor::registerSpatialEffect(UHxSpatialEffectComponent* effect) {
+  if (!IsValid(effect)) {
+    return;
+  }
+
+  spatial_effect_index_.addEffect(effect);
+  if (!index_spatial_effects_) {
+    registerSpatialEffectWithCi(effect);
+  }
+}
+
+void AHxCoreActor::unregisterSpatialEffect(UHxSpatialEffectComponent* effect) {
+  spatial_effect_index_.removeEffect(effect);
+  std::shared_ptr<HaptxApi::SpatialEffect> spatial_effect;
+  if (ci_spatial_effects_.RemoveAndCopyValue(effect, spatial_effect) &&
+      spatial_effect != nullptr) {
+    contact_interpreter_.unregisterSpatialEffect(spatial_effect->getId());
+  }
+}
+
+void AHxCoreActor::updateSpatialEffectRegistration(float delta_time_s) {
+  SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_updateSpatialEffectRegistration)
+  HX_BENCHMARK_SCOPE(SPATIAL_EFFECTS)
+
+  spatial_effect_index_.setCellSizeCm(spatial_effect_index_cell_size_cm_);
+  spatial_effect_index_.update();
+
+  nearby_spatial_effects_.Reset();
+  if (index_spatial_effects_) {
+    for (int32 i = ci_body_components_.Num() - 1; i >= 0; i--) {
+      UPrimitiveComponent* body = ci_body_components_[i].Get();
+      if (!IsValid(body)) {
+        ci_body_components_.RemoveAtSwap(i);
+        continue;
+      }
+      spatial_effect_index_.findEffects(body->Bounds.GetBox().ExpandBy(
+          SPATIAL_EFFECT_BODY_MARGIN_CM), nearby_spatial_effects_);
+    }
+  } else {
+    nearby_spatial_effects_.Append(spatial_effect_index_.getEffects());
+  }
+
+  for (auto it = ci_spatial_effects_.CreateIterator(); it; ++it) {
+    if (!nearby_spatial_effects_.Contains(it.Key())) {
+      if (it.Value() != nullptr) {
+        contact_interpreter_.unregisterSpatialEffect(it.Value()->getId());
+      }
+      it.RemoveCurrent();
+    }
+  }
+  for (UHxSpatialEffectComponent* effect : nearby_spatial_effects_) {
+    registerSpatialEffectWithCi(effect);
+  }
+
+  // Effects advance as part of the contact interpreter's update, so those it doesn't know about
+  // are advanced here.
+  for (UHxSpatialEffectComponent* effect : spatial_effect_index_.getEffects()) {
+    if (!ci_spatial_effects_.Contains(effect)) {
+      std::shared_ptr<HaptxApi::SpatialEffect> spatial_effect = effect->getSpatialEffect();
+      if (spatial_effect != nullptr && spatial_effect->isPlaying()) {
+        spatial_effect->advance(delta_time_s);
+      }
+    }
+  }
+}
+
+void AHxCoreActor::registerSpatialEffectWithCi(UHxSpatialEffectComponent* effect) {
+  if (ci_spatial_effects_.Contains(effect)) {
+    return;
+  }
+
+  std::shared_ptr<HaptxApi::SpatialEffect> spatial_effect = effect->getSpatialEffect();
+  if (spatial_effect != nullptr) {
+    contact_interpreter_.registerSpatialEffect(spatial_effect);
+    ci_spatial_effects_.Add(effect, spatial_effect);
+  }
+}
+
+void AHxCoreActor::updateTactileTraceBudgetFrame() {
+  if (tactile_trace_budget_frame_ == GFrameCounter) {
+    return;
+  }
+
+  // Demand is steady from frame to frame, so last frame's demand sets the priority a trace needs
+  // to be one of the budget's highest priority traces this frame.
+  tactile_trace_budget_frame_ = GFrameCounter;
+  tactile_traces_remaining_ = tactile_trace_budget_;
+  if (tactile_trace_demand_.Num() > tactile_trace_budget_) {
+    std::nth_element(tactile_trace_demand_.GetData(),
+        tactile_trace_demand_.GetData() + tactile_trace_budget_ - 1,
+        tactile_trace_demand_.GetData() + tactile_trace_demand_.Num(), std::greater<float>());
+    tactile_trace_priority_threshold_ = tactile_trace_demand_[tactile_trace_budget_ - 1];
+  } else {
+    tactile_trace_priority_threshold_ = 0.0f;
+  }
+  tactile_trace_demand_.Reset();
+}
+
 void AHxCoreActor::registerBodyWithCi(int64_t ci_body_id, UPrimitiveComponent* comp, FName bone,
     const FBodyParameters& parameters, HaptxApi::RigidBodyPart rigid_body_part) {
   if (comp == nullptr) {
@@ -1030,6 +1294,7 @@ void AHxCoreActor::registerBodyWithCi(int64_t ci_body_id, UPrimitiveComponent* c
     return;
   }
 
+  ci_body_components_.AddUnique(comp);
   std::shared_ptr<const HaptxApi::SimulationCallbacks>& callbacks =
       ci_object_id_to_callbacks_.Emplace(ci_body_id,
       std::make_shared<const PrimitiveComponentCallbacks>(comp, bone));
@@ -6,8 +6,8 @@
 #include <Haptx/Private/haptx_shared.h>
 
 UHxCurveDirectEffectComponent::UHxCurveDirectEffectComponent() : input_time_scale_(1.0f), 
-    displacement_curve_(nullptr), output_displacement_scale_(1.0f), min_time_s_(0.0f), 
-    max_time_s_(0.0f) {}
+    displacement_curve_(nullptr), output_displacement_scale_(1.0f),
+    curve_table_resolution_(256), min_time_s_(0.0f), max_time_s_(0.0f) {}
 
 float UHxCurveDirectEffectComponent::getInputTimeScale() const {
   return input_time_scale_;
@@ -35,6 +35,19 @@ void UHxCurveDirectEffectComponent::setOutputDisplacementScale(float output_disp
   output_displacement_scale_ = output_displacement_scale;
 }
 
+int32 UHxCurveDirectEffectComponent::getCurveTableResolution() const {
+  return curve_table_resolution_;
+}
+
+void UHxCurveDirectEffectComponent::setCurveTableResolution(int32 curve_table_resolution) {
+  curve_table_resolution_ = curve_table_resolution;
+  updateDisplacementCurveExtrema();
+}
+
+float UHxCurveDirectEffectComponent::getCurveTableMaxError() const {
+  return curve_table_.getMaxError();
+}
+
 void UHxCurveDirectEffectComponent::BeginPlay() {
   Super::BeginPlay();
   updateDisplacementCurveExtrema();
@@ -46,9 +59,10 @@ float UHxCurveDirectEffectComponent::getDisplacementM(
     return 0.0f;
   }
   else {
-    float curve_output_cm = displacement_curve_->GetFloatValue(
-        (input_time_scale_ > 0.0f ? min_time_s_ : max_time_s_) + 
-        input_time_scale_ * direct_info.time_s);
+    const float time_s = (input_time_scale_ > 0.0f ? min_time_s_ : max_time_s_) +
+        input_time_scale_ * direct_info.time_s;
+    float curve_output_cm = curve_table_.isBaked() ? curve_table_.evaluate(time_s) :
+        displacement_curve_->GetFloatValue(time_s);
 
     return hxFromUnrealLength(output_displacement_scale_ * curve_output_cm);
   }
@@ -79,5 +93,8 @@ void UHxCurveDirectEffectComponent::updateDisplacementCurveExtrema() {
       }
     }
   }
+  curve_table_.bake(displacement_curve_, curve_table_resolution_,
+      FSimpleDelegate::CreateUObject(this,
+      &UHxCurveDirectEffectComponent::updateDisplacementCurveExtrema));
   updateDuration();
 }
@@ -5,7 +5,8 @@
 #include <Haptx/Public/hx_curve_object_effect_component.h>
 
 UHxCurveObjectEffectComponent::UHxCurveObjectEffectComponent() : input_time_scale_(1.0f), 
-    force_curve_(nullptr), output_force_scale_(1.0f), min_time_s_(0.0f), max_time_s_(0.0f) {}
+    force_curve_(nullptr), output_force_scale_(1.0f), curve_table_resolution_(256),
+    min_time_s_(0.0f), max_time_s_(0.0f) {}
 
 void UHxCurveObjectEffectComponent::BeginPlay() {
   Super::BeginPlay();
@@ -18,9 +19,10 @@ float UHxCurveObjectEffectComponent::getForceN(
     return 0.0f;
   }
   else {
-    float curve_output_cn = force_curve_->GetFloatValue(
-        (input_time_scale_ > 0.0f ? min_time_s_ : max_time_s_) + 
-        input_time_scale_ * contact_info.time_s);
+    const float time_s = (input_time_scale_ > 0.0f ? min_time_s_ : max_time_s_) +
+        input_time_scale_ * contact_info.time_s;
+    float curve_output_cn = curve_table_.isBaked() ? curve_table_.evaluate(time_s) :
+        force_curve_->GetFloatValue(time_s);
 
     return hxFromUnrealLength(-contact_info.object_normal.dot(contact_info.body_normal) *
         output_force_scale_ * curve_output_cn);
@@ -52,6 +54,9 @@ void UHxCurveObjectEffectComponent::updateForceCurveExtrema() {
       }
     }
   }
+  curve_table_.bake(force_curve_, curve_table_resolution_,
+      FSimpleDelegate::CreateUObject(this,
+      &UHxCurveObjectEffectComponent::updateForceCurveExtrema));
   updateDuration();
 }
 
@@ -80,3 +85,16 @@ float UHxCurveObjectEffectComponent::getOutputForceScale() const {
 void UHxCurveObjectEffectComponent::setOutputForceScale(float output_force_scale) {
   output_force_scale_ = output_force_scale;
 }
+
+int32 UHxCurveObjectEffectComponent::getCurveTableResolution() const {
+  return curve_table_resolution_;
+}
+
+void UHxCurveObjectEffectComponent::setCurveTableResolution(int32 curve_table_resolution) {
+  curve_table_resolution_ = curve_table_resolution;
+  updateForceCurveExtrema();
+}
+
+float UHxCurveObjectEffectComponent::getCurveTableMaxError() const {
+  return curve_table_.getMaxError();
+}
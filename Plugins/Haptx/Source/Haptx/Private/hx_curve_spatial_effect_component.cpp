@@ -6,7 +6,8 @@
 #include <Haptx/Private/haptx_shared.h>
 
 UHxCurveSpatialEffectComponent::UHxCurveSpatialEffectComponent() : input_time_scale_(1.0f), 
-    force_curve_(nullptr), output_force_scale_(1.0f), min_time_s_(0.0f), max_time_s_(0.0f) {}
+    force_curve_(nullptr), output_force_scale_(1.0f), curve_table_resolution_(256),
+    min_time_s_(0.0f), max_time_s_(0.0f) {}
 
 float UHxCurveSpatialEffectComponent::getInputTimeScale() const {
   return input_time_scale_;
@@ -34,6 +35,19 @@ void UHxCurveSpatialEffectComponent::setOutputForceScale(float output_force_scal
   output_force_scale_ = output_force_scale;
 }
 
+int32 UHxCurveSpatialEffectComponent::getCurveTableResolution() const {
+  return curve_table_resolution_;
+}
+
+void UHxCurveSpatialEffectComponent::setCurveTableResolution(int32 curve_table_resolution) {
+  curve_table_resolution_ = curve_table_resolution;
+  updateForceCurveExtrema();
+}
+
+float UHxCurveSpatialEffectComponent::getCurveTableMaxError() const {
+  return curve_table_.getMaxError();
+}
+
 void UHxCurveSpatialEffectComponent::BeginPlay() {
   Super::BeginPlay();
 
@@ -46,9 +60,10 @@ float UHxCurveSpatialEffectComponent::getForceN(
     return 0.0f;
   }
   else {
-    float curve_output_n = force_curve_->GetFloatValue(
-        (input_time_scale_ > 0.0f ? min_time_s_ : max_time_s_) +
-        input_time_scale_ * spatial_info.time_s);
+    const float time_s = (input_time_scale_ > 0.0f ? min_time_s_ : max_time_s_) +
+        input_time_scale_ * spatial_info.time_s;
+    float curve_output_n = curve_table_.isBaked() ? curve_table_.evaluate(time_s) :
+        force_curve_->GetFloatValue(time_s);
 
     return hxFromUnrealLength(output_force_scale_ * curve_output_n);
   }
@@ -79,5 +94,8 @@ void UHxCurveSpatialEffectComponent::updateForceCurveExtrema() {
       }
     }
   }
+  curve_table_.bake(force_curve_, curve_table_resolution_,
+      FSimpleDelegate::CreateUObject(this,
+      &UHxCurveSpatialEffectComponent::updateForceCurveExtrema));
   updateDuration();
 }
@@ -0,0 +1,123 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#include <Haptx/Public/hx_curve_table.h>
+#include <Haptx/Public/hx_core_actor.h>
+
+//! The number of points between each pair of samples where error is measured.
+constexpr int32 ERROR_POINTS_PER_SAMPLE = 8;
+
+//! A warning is logged when the table strays from its curve by more than this fraction of the
+//! curve's range.
+constexpr float MAX_RELATIVE_ERROR_WARNING = 0.01f;
+
+HxCurveTable::HxCurveTable() : values_(), min_time_(0.0f), samples_per_time_(0.0f),
+    max_index_(0.0f), max_error_(0.0f) {}
+
+HxCurveTable::~HxCurveTable() {
+#if WITH_EDITOR
+  watchCurve(nullptr, FSimpleDelegate());
+#endif
+}
+
+bool HxCurveTable::bake(UCurveFloat* curve, int32 resolution, FSimpleDelegate on_curve_edited) {
+  reset();
+  if (!IsValid(curve)) {
+    return false;
+  }
+#if WITH_EDITOR
+  watchCurve(curve, on_curve_edited);
+#endif
+
+  const FRichCurve& rich_curve = curve->FloatCurve;
+  if (resolution < 2 || rich_curve.GetNumKeys() == 0 ||
+      rich_curve.PreInfinityExtrap != RCCE_Constant ||
+      rich_curve.PostInfinityExtrap != RCCE_Constant) {
+    return false;
+  }
+
+  float max_time = 0.0f;
+  rich_curve.GetTimeRange(min_time_, max_time);
+  const float duration = max_time - min_time_;
+  samples_per_time_ = duration > 0.0f ? (resolution - 1) / duration : 0.0f;
+  max_index_ = static_cast<float>(resolution - 1);
+
+  values_.SetNumUninitialized(resolution);
+  for (int32 i = 0; i < resolution; i++) {
+    values_[i] = rich_curve.Eval(FMath::Lerp(min_time_, max_time,
+        static_cast<float>(i) / (resolution - 1)));
+  }
+  max_error_ = measureMaxError(curve);
+
+  float min_value = 0.0f;
+  float max_value = 0.0f;
+  rich_curve.GetValueRange(min_value, max_value);
+  if (max_error_ > MAX_RELATIVE_ERROR_WARNING * (max_value - min_value)) {
+    AHxCoreActor::logWarning(FString::Printf(TEXT(
+        "HxCurveTable::bake(): %s differs from its %d sample table by up to %f. Increase the "
+        "curve table resolution of effects using it for more accuracy."), *curve->GetName(),
+        resolution, max_error_));
+  }
+  return true;
+}
+
+void HxCurveTable::reset() {
+#if WITH_EDITOR
+  watchCurve(nullptr, FSimpleDelegate());
+#endif
+  values_.Empty();
+  min_time_ = 0.0f;
+  samples_per_time_ = 0.0f;
+  max_index_ = 0.0f;
+  max_error_ = 0.0f;
+}
+
+bool HxCurveTable::isBaked() const {
+  return values_.Num() > 0;
+}
+
+float HxCurveTable::getMaxError() const {
+  return max_error_;
+}
+
+float HxCurveTable::measureMaxError(const UCurveFloat* curve) const {
+  const FRichCurve& rich_curve = curve->FloatCurve;
+  float max_error = 0.0f;
+
+  // Check between every pair of samples, where linear interpolation strays furthest.
+  const float time_per_point = samples_per_time_ > 0.0f ?
+      1.0f / (samples_per_time_ * ERROR_POINTS_PER_SAMPLE) : 0.0f;
+  const int32 num_points = FMath::TruncToInt(max_index_) * ERROR_POINTS_PER_SAMPLE;
+  for (int32 i = 1; i < num_points; i++) {
+    const float time = min_time_ + i * time_per_point;
+    max_error = FMath::Max(max_error, FMath::Abs(evaluate(time) - rich_curve.Eval(time)));
+  }
+
+  // Also check the keys, since sharp corners rarely line up with samples.
+  for (const FRichCurveKey& key : rich_curve.Keys) {
+    max_error = FMath::Max(max_error, FMath::Abs(evaluate(key.Time) - key.Value));
+  }
+  return max_error;
+}
+
+#if WITH_EDITOR
+void HxCurveTable::watchCurve(UCurveFloat* curve, FSimpleDelegate on_curve_edited) {
+  if (watched_curve_.IsValid() && watched_curve_handle_.IsValid()) {
+    watched_curve_->OnUpdateCurve.Remove(watched_curve_handle_);
+  }
+  watched_curve_handle_.Reset();
+  watched_curve_ = curve;
+  on_curve_edited_ = on_curve_edited;
+
+  if (IsValid(curve) && on_curve_edited_.IsBound()) {
+    watched_curve_handle_ = curve->OnUpdateCurve.AddRaw(this, &HxCurveTable::onCurveUpdated);
+  }
+}
+
+void HxCurveTable::onCurveUpdated(UCurveBase* curve, EPropertyChangeType::Type change_type) {
+  // Copied since the callback usually bakes again, which rebinds it.
+  FSimpleDelegate on_curve_edited = on_curve_edited_;
+  on_curve_edited.ExecuteIfBound();
+}
+#endif
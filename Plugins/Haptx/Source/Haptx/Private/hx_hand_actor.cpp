@@ -5,9 +5,12 @@
 #include <Haptx/Public/hx_hand_actor.h>
 #include <vector>
 #include <Runtime/Core/Public/Modules/ModuleManager.h>
+#include <Runtime/Core/Public/Serialization/MemoryWriter.h>
 #include <Runtime/CoreUObject/Public/UObject/ConstructorHelpers.h>
+#include <Runtime/Engine/Classes/Camera/PlayerCameraManager.h>
 #include <Runtime/Engine/Classes/Engine/SkeletalMeshSocket.h>
 #include <Runtime/Engine/Classes/GameFramework/GameStateBase.h>
+#include <Runtime/Engine/Classes/GameFramework/PlayerController.h>
 #include <Runtime/Engine/Classes/PhysicsEngine/PhysicsAsset.h>
 #include <Runtime/Engine/Classes/PhysicsEngine/PhysicsConstraintTemplate.h>
 #include <Runtime/Engine/Public/DrawDebugHelpers.h>
@@ -21,12 +24,13 @@
 #include <HaptxApi/openvr_wrapper.h>
 #include <HaptxApi/simulated_peripheral_database.h>
 #include <HaptxApi/thimble_compensator.h>
-#include <HaptxApi/user_profile_database.h>
 #include <Haptx/Private/haptx_shared.h>
+#include <Haptx/Public/hx_benchmark_stats.h>
 #include <Haptx/Public/hx_core_actor.h>
 #include <Haptx/Public/hx_on_screen_log.h>
 #include <Haptx/Public/hx_patch_component.h>
 #include <Haptx/Public/hx_physical_material.h>
+#include <Haptx/Public/hx_user_profile_service.h>
 
 FOnLeftHandInitialized AHxHandActor::on_left_hand_initialized;
 FOnRightHandInitialized AHxHandActor::on_right_hand_initialized;
@@ -34,6 +38,10 @@ TWeakObjectPtr<AHxHandActor> AHxHandActor::left_hand_;
 TWeakObjectPtr<AHxHandActor> AHxHandActor::right_hand_;
 TMap<UPrimitiveComponent*, FGlobalPhysicsAuthorityObjectData>
     AHxHandActor::global_physics_authority_data_from_comp_;
+TArray<HxPhysicsAuthorityZoneOverlap> AHxHandActor::pending_physics_authority_zone_overlaps_;
+uint64 AHxHandActor::physics_authority_zone_overlaps_frame_ = 0;
+TMap<UPrimitiveComponent*, HxGraspClaim> AHxHandActor::grasp_claim_from_comp_;
+TArray<TWeakObjectPtr<AHxHandActor>> AHxHandActor::physics_authority_hands_;
 
 DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::TickPrimary()"),
     STAT_TickPrimary, STATGROUP_AHxHandActor)
@@ -43,10 +51,14 @@ DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::updateHandAnimation()"),
     STAT_updateHandAnimation, STATGROUP_AHxHandActor)
 DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::NotifyHit()"),
     STAT_NotifyHit, STATGROUP_AHxHandActor)
-DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::NotifyHit() - CI"),
-    STAT_NotifyHit_CI, STATGROUP_AHxHandActor)
-DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::NotifyHit() - GD"),
-    STAT_NotifyHit_GD, STATGROUP_AHxHandActor)
+DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::flushContacts()"),
+    STAT_flushContacts, STATGROUP_AHxHandActor)
+DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::flushContacts() - CI"),
+    STAT_flushContacts_CI, STATGROUP_AHxHandActor)
+DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::flushContacts() - GD"),
+    STAT_flushContacts_GD, STATGROUP_AHxHandActor)
+DECLARE_DWORD_COUNTER_STAT_IF_PROFILING(TEXT("AHxHandActor - Hits Coalesced"),
+    STAT_HitsCoalesced, STATGROUP_AHxHandActor)
 DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::visualizeForceFeedbackOutput()"),
     STAT_visualizeForceFeedbackOutput, STATGROUP_AHxHandActor)
 DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::visualizeMocapData()"),
@@ -57,6 +69,14 @@ DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::visualizeHandAnimation2()"),
     STAT_visualizeHandAnimation2, STATGROUP_AHxHandActor)
 DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::updatePhysicsState()"),
     STAT_updatePhysicsState, STATGROUP_AHxHandActor)
+DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::updatePhysicsLod()"),
+    STAT_updatePhysicsLod, STATGROUP_AHxHandActor)
+DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::processPhysicsAuthorityZoneOverlaps()"),
+    STAT_processPhysicsAuthorityZoneOverlaps, STATGROUP_AHxHandActor)
+DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::recordRewindHistory()"),
+    STAT_recordRewindHistory, STATGROUP_AHxHandActor)
+DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::arbitrateGraspClaims()"),
+    STAT_arbitrateGraspClaims, STATGROUP_AHxHandActor)
 DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::updateReplicatedConstraints()"),
     STAT_updateReplicatedConstraints, STATGROUP_AHxHandActor)
 DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("AHxHandActor::setLocalConstraintsPhysicallyEnabled()"),
@@ -86,13 +106,20 @@ AHxHandActor::AHxHandActor(const FObjectInitializer& object_initializer) :
     glove_slip_compensation_parameters_(), enable_thimble_compensation_(true),
     thimble_compensation_parameters_(), enable_corrective_teleportation_(true),
     corrective_teleportation_distance_(50.0f), mocap_origin_(nullptr),
-    simulated_animation_aggressiveness_1_s(10.0f), visualize_force_feedback_(false),
+    simulated_animation_aggressiveness_1_s(10.0f),
+    scripted_input_(false), visualize_force_feedback_(false),
     force_feedback_visualization_parameters_(), visualize_motion_capture_(false),
     visualize_hand_animation_(false), visualize_hand_animation_2_(false), dis_vis_parameters_(),
     physics_targets_transmission_frequency_hz_(50.0f), physics_targets_buffer_duration_s_(0.05f),
     physics_state_transmission_frequency_hz_(50.0f), physics_state_buffer_duration_s_(0.05f),
-    physics_authority_zone_radius_hysteresis_(0.1f),
-    visualize_displacement_(true), toggle_dis_vis_action_(TEXT("HxToggleDisplacementVis")),
+    physics_authority_zone_radius_hysteresis_(0.1f), physics_state_full_rate_distance_cm_(300.0f),
+    physics_state_cull_distance_cm_(0.0f), physics_state_reduced_rate_divisor_(5),
+    physics_state_view_culling_(true), physics_state_view_margin_deg_(15.0f),
+    physics_lod_enabled_(true), physics_lod_distance_cm_(500.0f), physics_lod_off_screen_(true),
+    physics_lod_interaction_radius_cm_(100.0f), physics_lod_hysteresis_(0.1f),
+    rewind_history_duration_s_(1.0f), rewind_pose_tolerance_cm_(5.0f),
+    trace_origins_asset_(nullptr), bake_trace_origins_(false), visualize_displacement_(true),
+    toggle_dis_vis_action_(TEXT("HxToggleDisplacementVis")),
     toggle_mocap_vis_action_(TEXT("HxToggleMocapVis")),
     toggle_trace_vis_action_(TEXT("HxToggleTraceVis")),
     toggle_tactile_feedback_vis_action_(TEXT("HxToggleTactileFeedbackVis")),
@@ -102,21 +129,33 @@ AHxHandActor::AHxHandActor(const FObjectInitializer& object_initializer) :
     is_enabled_(true), is_input_bound_(false), is_client_physics_authority_(true),
     local_constraints_need_disabled_(false),
     l_middle1_cm_(FVector::ZeroVector), palm_constraint_(nullptr), joints_(),
-    contacting_object_ids_(), damping_constraint_from_object_id_(), palm_extent_(0.0f),
+    contacting_object_ids_(), damping_constraint_from_object_id_(), damping_constraint_pool_(),
+    contact_damping_body_indices_(), contact_damping_w_body_transforms_(),
+    contact_damping_l_body_bounds_cm_(), palm_extent_(0.0f),
     actors_to_ignore_(), physics_state_(), replicated_constraints_(), local_constraints_(),
     PhysicsAuthorityZone(nullptr), objects_in_physics_authority_zone_(),
-    comps_that_need_replication_targets_removed_(), num_physics_authority_zone_overlaps_(0),
+    num_physics_authority_zone_overlaps_(0), physics_authority_needs_update_(true),
+    physics_authority_mode_evaluated_(EPhysicsAuthorityMode::SERVER),
     physics_targets_buffer_tail_i_(0), physics_targets_buffer_head_i_(0),
     physics_targets_buffer_started_(false), physics_state_buffer_tail_i_(0),
     physics_state_buffer_head_i_(0),
     physics_state_buffer_started_(false), time_of_last_physics_transmission_s_(0.0f),
-    follow_time_s_(0.0f), physics_authority_zone_radius_enlarged_cm_(0.0f),
+    physics_state_multicast_count_(0u), is_sending_physics_state_multicast_(false),
+    is_physics_lod_kinematic_(false), is_replay_puppet_(false), rewind_history_head_i_(0),
+    rewind_history_num_(0), time_of_last_rewind_record_s_(0.0f),
+    rewind_claim_start_time_s_from_comp_(), rewind_rejected_comps_(),
+    follow_time_s_(0.0f), physics_state_batch_(),
+    physics_authority_zone_radius_enlarged_cm_(0.0f),
     physics_authority_zone_radius_nominal_cm_(0.0f), w_uhp_hand_scale_factor_(1.f),
     hand_needs_scale_update_(false), recently_warned_about_tracking_ref_being_off_(false),
     first_tick_has_happened_(false), palm_needs_first_teleport_(true), dis_vis_pmc_(nullptr),
-    dis_vis_mat_inst_(nullptr), finger_body_parameters_(), palm_body_parameters_(),
-    retractuator_parameters_(), bone_data_from_bone_name_(), hx_core_(nullptr),
-    gesture_(HaptxApi::Gesture::PRECISION_GRASP), last_simulated_anim_frame_(), mocap_system_(),
+    dis_vis_mat_inst_(nullptr), dis_vis_palm_bone_index_(INDEX_NONE), dis_vis_targets_(),
+    dis_vis_targets_dirty_(false), dis_vis_time_since_update_s_(0.0f),
+    finger_body_parameters_(), palm_body_parameters_(),
+    retractuator_parameters_(), bone_data_from_body_index_(), contacts_(),
+    contact_index_from_key_(), hx_core_(nullptr),
+    gesture_(HaptxApi::Gesture::PRECISION_GRASP), last_simulated_anim_frame_(),
+    scripted_w_mcp3_(FTransform::Identity), scripted_trigger_value_(0.0f), mocap_system_(),
     glove_slip_compensator_(), glove_(nullptr),
     hand_joint_bone_names_{
     {bone_names_.thumb1, bone_names_.thumb2, bone_names_.thumb3},
@@ -270,7 +309,8 @@ void AHxHandActor::OnGlobalCreatePhysics(UActorComponent* component) {
     if (patch && patch->GetAttachParent() == smc) {
       patch->SetRelativeScale3D(FVector::OneVector / w_uhp_hand_scale_factor_);
       if (isLocallyControlled()) {
-        patch->updateTraceOrigins(GetSkeletalMeshComponent(), static_mesh_);
+        patch->updateTraceOrigins(GetSkeletalMeshComponent(), static_mesh_,
+            trace_origins_asset_, bake_trace_origins_);
       }
     }
   }
@@ -391,20 +431,40 @@ void AHxHandActor::BeginPlay() {
   }
 
   if (isLocallyControlled()) {
-    if (checkForDuplicateHands()) {
+    if (!scripted_input_ && checkForDuplicateHands()) {
       AHxCoreActor::logError(FString::Printf(
           TEXT("Multiple hands claim to be the %s hand, disabling myself."), HAND_AS_TEXT), true);
       hardDisable();
       return;
     }
 
-    loadUserProfile();
+    // The profile loads in the background, so the hand starts with the default profile and
+    // resizes once the real one arrives.
+    user_profile_changed_handle_ = HxUserProfileService::onUserProfileChanged().AddUObject(this,
+        &AHxHandActor::loadUserProfile);
+    if (HxUserProfileService::isLoaded()) {
+      loadUserProfile();
+    } else {
+      HxUserProfileService::requestLoad();
+    }
     registerRetractuators();
   }
 
+  // Keep enough history to cover rewind_history_duration_s_ at the rate it's recorded, plus a
+  // frame on either end to interpolate with.
+  const int32 MAX_REWIND_HISTORY_FRAMES = 1024;
+  if (isAuthoritative() && rewind_history_duration_s_ > 0.0f) {
+    rewind_history_ = TCircularBuffer<FHandPhysicsStateFrame>(static_cast<uint32>(FMath::Clamp(
+        FMath::CeilToInt(rewind_history_duration_s_ * physics_state_transmission_frequency_hz_) +
+        2, 1, MAX_REWIND_HISTORY_FRAMES)));
+    rewind_history_head_i_ = 0;
+    rewind_history_num_ = 0;
+  }
+
   physics_authority_zone_radius_enlarged_cm_ = (1.0f + physics_authority_zone_radius_hysteresis_) *
       PhysicsAuthorityZone->GetUnscaledSphereRadius();
   physics_authority_zone_radius_nominal_cm_ = PhysicsAuthorityZone->GetUnscaledSphereRadius();
+  physics_authority_hands_.AddUnique(this);
 
   if (!IsTemplate()) {
     SecondaryTick.Target = this;
@@ -420,9 +480,22 @@ void AHxHandActor::BeginPlay() {
   }
 }
 
+void AHxHandActor::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+  HxUserProfileService::onUserProfileChanged().Remove(user_profile_changed_handle_);
+  user_profile_changed_handle_.Reset();
+  physics_authority_hands_.Remove(this);
+  for (auto it = grasp_claim_from_comp_.CreateIterator(); it; ++it) {
+    if (it.Value().hand.Get() == this) {
+      it.RemoveCurrent();
+    }
+  }
+  Super::EndPlay(EndPlayReason);
+}
+
 void AHxHandActor::Tick(float DeltaTime) {
   Super::Tick(DeltaTime);
   SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_TickPrimary)
+  HX_BENCHMARK_SCOPE(HAND_TICK)
 
   if (!is_enabled_) {
     return;
@@ -437,23 +510,12 @@ void AHxHandActor::Tick(float DeltaTime) {
   }
 
   // We can't do this in on-overlap code since movement replication can cause overlaps, leading to
-  // modification of data structures that are being iterated over.
-  if (comps_that_need_replication_targets_removed_.Num() > 0) {
-    UWorld* world = GetWorld();
-    if (IsValid(world)) {
-      FPhysScene* phys_scene = world->GetPhysicsScene();
-      if (phys_scene != nullptr) {
-        FPhysicsReplication* phys_rep = phys_scene->GetPhysicsReplication();
-        if (phys_rep != nullptr) {
-          for (auto& comp : comps_that_need_replication_targets_removed_) {
-            if (IsValid(comp)) {
-              phys_rep->RemoveReplicatedTarget(comp);
-            }
-          }
-          comps_that_need_replication_targets_removed_.Empty();
-        }
-      }
-    }
+  // modification of data structures that are being iterated over. The first hand to tick each
+  // frame processes the overlaps of all hands.
+  processPhysicsAuthorityZoneOverlaps();
+
+  if (is_replay_puppet_) {
+    return;
   }
 
   if (isLocallyControlled()) {
@@ -480,6 +542,8 @@ void AHxHandActor::Tick(float DeltaTime) {
     }
   }
 
+  updatePhysicsLod();
+
   if (isAuthoritative() && !isLocallyControlled() && isPhysicsAuthority()) {
     // The server being authoritative over a hand being driven by a client.
     interpolatePhysicsTargets(DeltaTime);
@@ -494,33 +558,43 @@ void AHxHandActor::TickSecondary(
     ELevelTick TickType,
     FHxHandSecondaryTickFunction& ThisTickFunction) {
   SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_TickSecondary)
-  if (!is_enabled_) {
+  HX_BENCHMARK_SCOPE(HAND_TICK)
+  if (!is_enabled_ || is_replay_puppet_) {
     return;
   }
 
-  // Remove any contact damping constraints that should no longer exist.
-  TArray<int64> keys_to_remove;
-  for (auto& key_value : damping_constraint_from_object_id_) {
-    if (!contacting_object_ids_.Contains(key_value.Key)) {
-      keys_to_remove.Add(key_value.Key);
-    }
-  }
-  for (int64 key : keys_to_remove) {
-    UPhysicsConstraintComponent** constraint_ptr_ptr =
-        damping_constraint_from_object_id_.Find(key);
-    if (constraint_ptr_ptr != nullptr) {
-      notifyLocalConstraintDestroyed(*constraint_ptr_ptr);
-      destroyPhysicsConstraintComponent(*constraint_ptr_ptr);
-      damping_constraint_from_object_id_.Remove(key);
+  // The core normally flushes this frame's hits before its update. Catch any that arrived since
+  // before evaluating contact damping constraints.
+  flushContacts();
+
+  // Release any contact damping constraints that should no longer exist.
+  for (auto it = damping_constraint_from_object_id_.CreateIterator(); it; ++it) {
+    if (!contacting_object_ids_.Contains(it.Key())) {
+      releaseContactDampingConstraint(it.Value());
+      it.RemoveCurrent();
     }
   }
-  contacting_object_ids_.Empty();
+  contacting_object_ids_.Reset();
 
-  // Server only code.
-  if (isAuthoritative()) {
+  // Server only code. Overlap changes are arbitrated in processPhysicsAuthorityZoneOverlaps(), so
+  // here we only need to catch the initial evaluation and mode changes.
+  if (isAuthoritative() && (physics_authority_needs_update_ || (IsValid(hx_core_) &&
+      hx_core_->getPhysicsAuthorityMode() != physics_authority_mode_evaluated_))) {
     serverUpdatePhysicsAuthority();
   }
 
+  if (isAuthoritative() && rewind_history_duration_s_ > 0.0f) {
+    AGameStateBase* game_state = UGameplayStatics::GetGameState(GetWorld());
+    if (IsValid(game_state)) {
+      float time_s = game_state->GetServerWorldTimeSeconds();
+      if (time_s - time_of_last_rewind_record_s_ >=
+          1.0f / physics_state_transmission_frequency_hz_) {
+        recordRewindHistory(time_s);
+        time_of_last_rewind_record_s_ = time_s;
+      }
+    }
+  }
+
   if (isPhysicsAuthority()) {
     AGameStateBase* game_state = UGameplayStatics::GetGameState(GetWorld());
     if (IsValid(game_state)) {
@@ -529,11 +603,17 @@ void AHxHandActor::TickSecondary(
       // Insert a half period of offset for left hands to stagger messages.
       if (time_s - time_of_last_physics_transmission_s_ -
           (hand_ == ERelativeDirection::LEFT ? 0.5f * period_s : 0.0f) > period_s) {
-        getRigidBodyStates(GetSkeletalMeshComponent(), physics_state_.w_body_states);
-        getPhysicsStatesOfObjectsInAuthorityZone(physics_state_.w_object_states);
+        getPhysicsStates(physics_state_.w_body_states, physics_state_.w_object_states);
         getLocalConstraintStates(physics_state_.constraint_states);
+        if (HxBenchmarkStats::isEnabled()) {
+          // Standalone benchmarks have no connections to measure, so measure the payload instead.
+          TArray<uint8> bytes;
+          FMemoryWriter writer(bytes);
+          FHandPhysicsState::StaticStruct()->SerializeBin(writer, &physics_state_);
+          HxBenchmarkStats::addPhysicsStateBytes(bytes.Num());
+        }
         if (isAuthoritative()) {
-          multicastUpdatePhysicsState(time_s, physics_state_);
+          sendPhysicsStateToRelevantConnections(time_s, physics_state_);
         } else {
           serverUpdatePhysicsState(time_s, physics_state_);
         }
@@ -573,158 +653,250 @@ void AHxHandActor::NotifyHit(UPrimitiveComponent* MyComp, AActor* Other,
       !IsValid(OtherComp) || actors_to_ignore_.Contains(Other)) {
     return;
   }
-  FHxHandActorBoneData* bone_data = bone_data_from_bone_name_.Find(Hit.MyBoneName);
 
-  HaptxApi::Vector3D normal_impulse_ns =
-      hxFromUnrealLength(NormalImpulse.Size() * Hit.ImpactNormal);  // Removes direction ambiguity.
-  if (isLocallyControlled()) {
-    // Register contact with CI.
-    int64_t ci_object_id;
-    if (bone_data == nullptr || !bone_data->has_ci_body_id) {
-      UE_LOG(HaptX, Error,
-          TEXT("AHxHandActor::NotifyHit: Bone not registered with CI %s."),
-          *Hit.MyBoneName.ToString())
-    } else if (!hx_core_->tryRegisterObjectWithCi(OtherComp, Hit.BoneName, false, ci_object_id)) {
-      UE_LOG(HaptX, Error,
-          TEXT("AHxHandActor::NotifyHit: Object not registered with CI %s:%s."),
-          *OtherComp->GetName(), *Hit.BoneName.ToString())
-    } else {
-      SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_NotifyHit_CI)
-      hx_core_->getContactInterpreter().addContact(
-          ci_object_id,
-          bone_data->ci_body_id,
-          normal_impulse_ns);
-    }
-  }
+  // For hits on skeletal meshes Hit.Item holds the index of our body.
+  int32 body_index = bone_data_from_body_index_.IsValidIndex(Hit.Item) ? Hit.Item :
+      smc->GetPhysicsAsset() != nullptr ? smc->GetPhysicsAsset()->FindBodyIndex(Hit.MyBoneName) :
+      INDEX_NONE;
 
-  // Register contact with GD.
-  int64_t gd_object_id;
-  if (bone_data == nullptr || !bone_data->has_gd_body_id) {
-    UE_LOG(HaptX, Error,
-        TEXT("AHxHandActor::NotifyHit: Bone not registered with GD %s."),
-        *Hit.MyBoneName.ToString())
-  } else if (!hx_core_->tryRegisterObjectWithGd(OtherComp, Hit.BoneName, false, gd_object_id)) {
-    UE_LOG(HaptX, Error,
-        TEXT("AHxHandActor::NotifyHit: Object not registered with GD %s:%s."),
-        *OtherComp->GetName(), *Hit.BoneName.ToString())
+  // PhysX may report many hits per bone/body pair per frame. Accumulate them here and process
+  // them once per frame in flushContacts(), which the core calls before it consumes contacts.
+  if (contacts_.Num() == 0) {
+    hx_core_->queueContactFlush(this);
+  }
+  TTuple<int32, const UPrimitiveComponent*, FName> key(body_index, OtherComp, Hit.BoneName);
+  int32* contact_index = contact_index_from_key_.Find(key);
+  HxHandActorContact* contact = nullptr;
+  if (contact_index != nullptr) {
+    contact = &contacts_[*contact_index];
+    INC_DWORD_STAT_IF_PROFILING(STAT_HitsCoalesced);
   } else {
-    SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_NotifyHit_GD)
-    HaptxApi::GraspDetector::GraspContactInfo gci;
-    gci.object_id = gd_object_id;
-    gci.grasp_body_id = bone_data->gd_body_id;
-    gci.contact_location = hxFromUnrealLength(Hit.Location);
-    gci.impulse = normal_impulse_ns;
-    hx_core_->getGraspDetector().addGraspContact(gci);
-  }
-
-  // Damp the motion of objects in the palm to help with holding.
-  if (bone_data != nullptr && bone_data->can_engage_contact_damping) {
-    FBodyInstance* other_inst = getBodyInstance(OtherComp, Hit.BoneName);
-    if (other_inst != nullptr && other_inst->bSimulatePhysics) {
-      UHxPhysicalMaterial* hx_phys_mat = Cast<UHxPhysicalMaterial>(
-          other_inst->GetSimplePhysicalMaterial());
-      bool contact_damping_enabled = (IsValid(hx_phys_mat) &&
-          hx_phys_mat->override_contact_damping_enabled_) ? hx_phys_mat->contact_damping_enabled_ :
-          enable_contact_damping_;
-      FBodyInstance* palm_inst = smc->GetBodyInstance(bone_names_.palm);
-      if (contact_damping_enabled && palm_inst != nullptr) {
-        // The color to draw the contact damping trace if it hits the hand.
-        static const FColor HAND_HIT_COLOR = DEBUG_PURPLE_OR_TEAL;
-        // The color to draw the contact damping trace if it misses the hand.
-        static const FColor HAND_MISSED_COLOR = DEBUG_RED_OR_GREEN;
-        // How thick to draw the contact damping trace.
-        static const float L_TRACE_THICKNESS_CM = 0.07f;
-        // The radius of the sphere to draw at the contact damping trace hit location
-        // (assuming it hits).
-        static const float L_HIT_RADIUS_CM = 0.2f;
-
-        // Only allow contact damping if the hand is "below" the object in the context of gravity.
-        FVector w_trace_begin_cm = other_inst->GetCOMPosition();
-        FVector w_trace_end_cm = w_trace_begin_cm -
-            FVector::UpVector * (FMath::Abs(FVector::DotProduct(
-            w_trace_begin_cm - palm_inst->GetCOMPosition(), FVector::UpVector)) + palm_extent_);
-
-        bool hit_hand = false;
-        FHitResult hand_trace_result;
-        static FCollisionObjectQueryParams pawn_whitelist = { ECollisionChannel::ECC_Pawn };
-        if (GetWorld()->LineTraceSingleByObjectType(hand_trace_result, w_trace_begin_cm,
-            w_trace_end_cm, pawn_whitelist) && hand_trace_result.Component.Get() == smc) {
-          FHxHandActorBoneData* hand_trace_bone_data =
-              bone_data_from_bone_name_.Find(hand_trace_result.BoneName);
-          if (hand_trace_bone_data != nullptr &&
-              hand_trace_bone_data->can_engage_contact_damping) {
-            int64 other_id = getBodyInstanceId(other_inst);
-            if (!damping_constraint_from_object_id_.Contains(other_id)) {
-              other_inst->SetLinearVelocity(FVector::ZeroVector, false);
-              UPhysicsConstraintComponent* damping_constraint = createContactDampingConstraint(
-                  OtherComp, Hit.BoneName);
-              damping_constraint_from_object_id_.Add(other_id, damping_constraint);
-              notifyLocalConstraintCreated(damping_constraint);
-            }
-            contacting_object_ids_.Add(other_id);
-            hit_hand = true;
-
-            if (visualize_contact_damping_) {
-              HxDebugDrawSystem::sphere(
-                  GetOwner(),
-                  hand_trace_result.Location,
-                  componentAverage(smc->GetComponentScale()) * L_HIT_RADIUS_CM,
-                  HAND_HIT_COLOR);
-            }
-          }
-        }
+    contact_index_from_key_.Add(key, contacts_.Num());
+    contact = &contacts_.AddDefaulted_GetRef();
+    contact->body_index = body_index;
+    contact->bone_name = Hit.MyBoneName;
+    contact->other_comp = OtherComp;
+    contact->other_bone_name = Hit.BoneName;
+  }
+
+  float normal_impulse_mag = NormalImpulse.Size();
+  // Removes direction ambiguity.
+  contact->w_normal_impulse += normal_impulse_mag * Hit.ImpactNormal;
+  contact->w_weighted_location_sum_cm += normal_impulse_mag * Hit.Location;
+  contact->location_weight_sum += normal_impulse_mag;
+  contact->w_location_sum_cm += Hit.Location;
+  contact->num_hits++;
+}
+
+void AHxHandActor::flushContacts() {
+  SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_flushContacts)
+  if (contacts_.Num() == 0) {
+    return;
+  }
+
+  // Objects whose contact damping has already been evaluated this frame.
+  TSet<int64> damping_evaluated_ids;
+  contact_damping_w_body_transforms_.Reset();
+  bool is_locally_controlled = isLocallyControlled();
+  for (const HxHandActorContact& contact : contacts_) {
+    UPrimitiveComponent* other_comp = contact.other_comp.Get();
+    if (!IsValid(hx_core_) || !IsValid(other_comp)) {
+      continue;
+    }
+    FHxHandActorBoneData* bone_data = getBoneData(contact.body_index);
 
-        if (visualize_contact_damping_) {
-          HxDebugDrawSystem::line(GetOwner(), w_trace_begin_cm, w_trace_end_cm,
-              hit_hand ? HAND_HIT_COLOR : HAND_MISSED_COLOR,
-              componentAverage(smc->GetComponentScale()) * L_TRACE_THICKNESS_CM);
+    HaptxApi::Vector3D normal_impulse_ns = hxFromUnrealLength(contact.w_normal_impulse);
+    if (is_locally_controlled) {
+      // Register contact with CI.
+      int64_t ci_object_id;
+      if (bone_data == nullptr || !bone_data->has_ci_body_id) {
+        UE_LOG(HaptX, Error,
+            TEXT("AHxHandActor::flushContacts: Bone not registered with CI %s."),
+            *contact.bone_name.ToString())
+      } else if (!hx_core_->tryRegisterObjectWithCi(other_comp, contact.other_bone_name, false,
+          ci_object_id)) {
+        UE_LOG(HaptX, Error,
+            TEXT("AHxHandActor::flushContacts: Object not registered with CI %s:%s."),
+            *other_comp->GetName(), *contact.other_bone_name.ToString())
+      } else {
+        SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_flushContacts_CI)
+        hx_core_->getContactInterpreter().addContact(
+            ci_object_id,
+            bone_data->ci_body_id,
+            normal_impulse_ns);
+      }
+    }
+
+    // Register contact with GD.
+    int64_t gd_object_id;
+    if (bone_data == nullptr || !bone_data->has_gd_body_id) {
+      UE_LOG(HaptX, Error,
+          TEXT("AHxHandActor::flushContacts: Bone not registered with GD %s."),
+          *contact.bone_name.ToString())
+    } else if (!hx_core_->tryRegisterObjectWithGd(other_comp, contact.other_bone_name, false,
+        gd_object_id)) {
+      UE_LOG(HaptX, Error,
+          TEXT("AHxHandActor::flushContacts: Object not registered with GD %s:%s."),
+          *other_comp->GetName(), *contact.other_bone_name.ToString())
+    } else {
+      SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_flushContacts_GD)
+      HaptxApi::GraspDetector::GraspContactInfo gci;
+      gci.object_id = gd_object_id;
+      gci.grasp_body_id = bone_data->gd_body_id;
+      gci.contact_location = hxFromUnrealLength(contact.getRepresentativeLocation());
+      gci.impulse = normal_impulse_ns;
+      hx_core_->getGraspDetector().addGraspContact(gci);
+    }
+
+    // Damp the motion of objects in the palm to help with holding.
+    if (bone_data != nullptr && bone_data->can_engage_contact_damping) {
+      FBodyInstance* other_inst = getBodyInstance(other_comp, contact.other_bone_name);
+      if (other_inst != nullptr && other_inst->bSimulatePhysics) {
+        bool already_evaluated = false;
+        damping_evaluated_ids.Add(getBodyInstanceId(other_inst), &already_evaluated);
+        if (!already_evaluated) {
+          tryEngageContactDamping(contact, other_inst);
         }
       }
     }
   }
+
+  contacts_.Reset();
+  contact_index_from_key_.Reset();
 }
 
-FString AHxHandActor::GetUserProfileName()
-{
-  FString name;
-  std::wstring active_username;
-  if (!HaptxApi::UserProfileDatabase::getActiveUsername(&active_username)) {
-    name = FString(TEXT("No user profile loaded"));
-  }
-  else {
-    name = active_username.c_str();
+void AHxHandActor::tryEngageContactDamping(const HxHandActorContact& contact,
+    FBodyInstance* other_inst) {
+  USkeletalMeshComponent* smc = GetSkeletalMeshComponent();
+  UPrimitiveComponent* other_comp = contact.other_comp.Get();
+  if (!IsValid(smc) || !IsValid(other_comp) || other_inst == nullptr) {
+    return;
   }
-  return name;
-}
 
-float AHxHandActor::GetUserHandLength()
-{
-  float length = 0.0f;
-  HaptxApi::UserProfile user_profile;
+  UHxPhysicalMaterial* hx_phys_mat = Cast<UHxPhysicalMaterial>(
+      other_inst->GetSimplePhysicalMaterial());
+  bool contact_damping_enabled = (IsValid(hx_phys_mat) &&
+      hx_phys_mat->override_contact_damping_enabled_) ? hx_phys_mat->contact_damping_enabled_ :
+      enable_contact_damping_;
+  FBodyInstance* palm_inst = smc->GetBodyInstance(bone_names_.palm);
+  if (!contact_damping_enabled || palm_inst == nullptr) {
+    return;
+  }
 
-  std::wstring active_username;
+  // The color to draw the contact damping test if it hits the hand.
+  static const FColor HAND_HIT_COLOR = DEBUG_PURPLE_OR_TEAL;
+  // The color to draw the contact damping test if it misses the hand.
+  static const FColor HAND_MISSED_COLOR = DEBUG_RED_OR_GREEN;
+  // How thick to draw the contact damping test.
+  static const float L_TRACE_THICKNESS_CM = 0.07f;
+  // The radius of the sphere to draw at the contact damping test hit location
+  // (assuming it hits).
+  static const float L_HIT_RADIUS_CM = 0.2f;
+
+  // Only allow contact damping if the hand is "below" the object in the context of gravity.
+  FVector w_trace_begin_cm = other_inst->GetCOMPosition();
+  FVector w_trace_end_cm = w_trace_begin_cm -
+      FVector::UpVector * (FMath::Abs(FVector::DotProduct(
+      w_trace_begin_cm - palm_inst->GetCOMPosition(), FVector::UpVector)) + palm_extent_);
+
+  FVector w_hit_cm;
+  bool hit_hand = segmentIntersectsContactDampingBodies(w_trace_begin_cm, w_trace_end_cm,
+      w_hit_cm);
+  if (hit_hand) {
+    int64 other_id = getBodyInstanceId(other_inst);
+    if (!damping_constraint_from_object_id_.Contains(other_id)) {
+      other_inst->SetLinearVelocity(FVector::ZeroVector, false);
+      UPhysicsConstraintComponent* damping_constraint = acquireContactDampingConstraint(
+          other_comp, contact.other_bone_name);
+      damping_constraint_from_object_id_.Add(other_id, damping_constraint);
+      notifyLocalConstraintCreated(damping_constraint);
+    }
+    contacting_object_ids_.Add(other_id);
 
-  if (HaptxApi::UserProfileDatabase::getActiveUsername(&active_username) &&
-    HaptxApi::UserProfileDatabase::getUserProfile(active_username, &user_profile)) {
-    length = user_profile.getBasicHandDimsValueM(HaptxApi::BHD_LENGTH);
+    if (visualize_contact_damping_) {
+      HxDebugDrawSystem::sphere(
+          GetOwner(),
+          w_hit_cm,
+          componentAverage(smc->GetComponentScale()) * L_HIT_RADIUS_CM,
+          HAND_HIT_COLOR);
+    }
   }
 
-  return length;
+  if (visualize_contact_damping_) {
+    HxDebugDrawSystem::line(GetOwner(), w_trace_begin_cm, w_trace_end_cm,
+        hit_hand ? HAND_HIT_COLOR : HAND_MISSED_COLOR,
+        componentAverage(smc->GetComponentScale()) * L_TRACE_THICKNESS_CM);
+  }
 }
 
-float AHxHandActor::GetUserHandWidth()
-{
-  float width = 0.0f;
-  HaptxApi::UserProfile user_profile;
+bool AHxHandActor::segmentIntersectsContactDampingBodies(const FVector& w_begin_cm,
+    const FVector& w_end_cm, FVector& w_hit_cm) {
+  USkeletalMeshComponent* smc = GetSkeletalMeshComponent();
+  if (!IsValid(smc)) {
+    return false;
+  }
 
-  std::wstring active_username;
+  // Body transforms and bounds only need to be read once per frame no matter how many objects
+  // are tested. Scale is moved from the transforms into the bounds so that scaled hands are tested
+  // against bounds of the right size.
+  if (contact_damping_w_body_transforms_.Num() != contact_damping_body_indices_.Num()) {
+    contact_damping_w_body_transforms_.Reset(contact_damping_body_indices_.Num());
+    contact_damping_l_body_bounds_cm_.Reset(contact_damping_body_indices_.Num());
+    for (int32 body_index : contact_damping_body_indices_) {
+      FBodyInstance* body = smc->Bodies.IsValidIndex(body_index) ? smc->Bodies[body_index] :
+          nullptr;
+      if (body == nullptr || !body->IsValidBodyInstance() || !body->BodySetup.IsValid()) {
+        contact_damping_w_body_transforms_.Add(FTransform::Identity);
+        contact_damping_l_body_bounds_cm_.Add(FBox(ForceInit));
+        continue;
+      }
 
-  if (HaptxApi::UserProfileDatabase::getActiveUsername(&active_username) &&
-    HaptxApi::UserProfileDatabase::getUserProfile(active_username, &user_profile)) {
-    width = user_profile.getBasicHandDimsValueM(HaptxApi::BHD_BREADTH);
+      FTransform w_body = body->GetUnrealWorldTransform();
+      contact_damping_l_body_bounds_cm_.Add(body->BodySetup->AggGeom.CalcAABB(
+          FTransform(FQuat::Identity, FVector::ZeroVector, body->Scale3D)));
+      w_body.SetScale3D(FVector::OneVector);
+      contact_damping_w_body_transforms_.Add(w_body);
+    }
   }
 
-  return width;
+  bool hit = false;
+  float min_hit_time = 1.0f;
+  for (int i = 0; i < contact_damping_body_indices_.Num(); i++) {
+    const FBox& l_bounds_cm = contact_damping_l_body_bounds_cm_[i];
+    if (!l_bounds_cm.IsValid) {
+      continue;
+    }
+
+    const FTransform& w_body = contact_damping_w_body_transforms_[i];
+    FVector l_begin_cm = w_body.InverseTransformPosition(w_begin_cm);
+    FVector l_end_cm = w_body.InverseTransformPosition(w_end_cm);
+    FVector l_hit_cm;
+    FVector l_hit_normal;
+    float hit_time = 1.0f;
+    if (FMath::LineExtentBoxIntersection(l_bounds_cm, l_begin_cm, l_end_cm,
+        FVector::ZeroVector, l_hit_cm, l_hit_normal, hit_time) && hit_time <= min_hit_time) {
+      hit = true;
+      min_hit_time = hit_time;
+      w_hit_cm = w_body.TransformPosition(l_hit_cm);
+    }
+  }
+  return hit;
+}
+
+FString AHxHandActor::GetUserProfileName() {
+  HxUserProfileService::requestLoad();
+  return HxUserProfileService::hasActiveProfile() ? HxUserProfileService::getUsername() :
+      FString(TEXT("No user profile loaded"));
+}
+
+float AHxHandActor::GetUserHandLength() {
+  HxUserProfileService::requestLoad();
+  return HxUserProfileService::getHandLengthM();
+}
+
+float AHxHandActor::GetUserHandWidth() {
+  HxUserProfileService::requestLoad();
+  return HxUserProfileService::getHandWidthM();
 }
 
 ERelativeDirection AHxHandActor::getHand() const {
@@ -774,6 +946,13 @@ AHxHandActor* AHxHandActor::getRightHand() {
   }
 }
 
+void AHxHandActor::setScriptedInput(const FTransform& w_mcp3, HaptxApi::Gesture gesture,
+    float trigger_value) {
+  scripted_w_mcp3_ = w_mcp3;
+  gesture_ = gesture;
+  scripted_trigger_value_ = FMath::Clamp(trigger_value, 0.0f, 1.0f);
+}
+
 bool AHxHandActor::isLocallyControlled() const {
   return isPawnLocallyControlled(pawn_);
 }
@@ -971,7 +1150,7 @@ bool AHxHandActor::tryGetCiBodyId(const UHxPatchComponent &patch, int64_t *ci_bo
     return false;
   }
 
-  FHxHandActorBoneData* find_result = bone_data_from_bone_name_.Find(patch.GetAttachSocketName());
+  FHxHandActorBoneData* find_result = getBoneData(patch.GetAttachSocketName());
   if (find_result == nullptr) {
     return false;
   }
@@ -1002,7 +1181,7 @@ bool AHxHandActor::checkForDuplicateHands() const {
   for (AActor* actor : actors) {
     AHxHandActor* ahh = Cast<AHxHandActor>(actor);
     if (ahh != nullptr && ahh != this && ahh->isLocallyControlled() && ahh->hand_ == hand_ &&
-        ahh->is_enabled_) {
+        ahh->is_enabled_ && !ahh->scripted_input_) {
       return true;
     }
   }
@@ -1178,10 +1357,9 @@ void AHxHandActor::updatePhysicsTargets(const FHandPhysicsTargets& targets) {
   palm_constraint_->SetAngularOrientationTarget(w_middle1_orient);
 
   if (IsValid(dis_vis_pmc_)) {
-    dis_vis_pmc_->SetBoneLocationByName(bone_names_.palm, targets.w_middle1_pos_cm -
-        w_middle1_orient.RotateVector(l_middle1_cm_), EBoneSpaces::WorldSpace);
-    dis_vis_pmc_->SetBoneRotationByName(bone_names_.palm, w_middle1_orient,
-        EBoneSpaces::WorldSpace);
+    // Written to the pose in updateDisplacementVisualizer() at its own rate.
+    dis_vis_targets_ = targets;
+    dis_vis_targets_dirty_ = true;
   }
 
   USkeletalMeshComponent* smc = GetSkeletalMeshComponent();
@@ -1199,17 +1377,6 @@ void AHxHandActor::updatePhysicsTargets(const FHandPhysicsTargets& targets) {
 
         int flat_index = HaptxApi::FJ_LAST * f_i + fj_i;
         joints_[f_i][fj_i]->SetAngularOrientationTarget(targets.l_joint_orients[flat_index]);
-
-        if (IsValid(dis_vis_pmc_)) {
-          int32 bone_index = dis_vis_pmc_->GetBoneIndex(hand_joint_bone_names_[f_i][fj_i]);
-          if (bone_index > 0 && bone_index < dis_vis_pmc_->BoneSpaceTransforms.Num()) {
-            FQuat base_rotation = UKismetMathLibrary::MakeRotFromXY(joints_[f_i][fj_i]->PriAxis2,
-                joints_[f_i][fj_i]->SecAxis2).Quaternion();
-            dis_vis_pmc_->BoneSpaceTransforms[bone_index].SetRotation(
-                base_rotation * targets.l_joint_orients[flat_index]);
-            dis_vis_pmc_->MarkRefreshTransformDirty();
-          }
-        }
       }
     }
   }
@@ -1235,17 +1402,14 @@ void AHxHandActor::updatePhysicsState(const FHandPhysicsState& state) {
     return;
   }
 
+  // Gather every body first so they can all be written under a single scene lock.
+  physics_state_batch_.reset(smc->Bodies.Num() + state.w_object_states.Num());
   for (int i = 0; i < smc->Bodies.Num(); i++) {
     FBodyInstance* body = smc->Bodies[i];
     if (body == nullptr || !body->IsValidBodyInstance()) {
       continue;
     }
-
-    const FRigidBodyState& body_state = state.w_body_states[i];
-    body->SetBodyTransform(FTransform(body_state.Quaternion, body_state.Position),
-        ETeleportType::TeleportPhysics);
-    body->SetLinearVelocity(body_state.LinVel, false);
-    body->SetAngularVelocityInRadians(FMath::DegreesToRadians(body_state.AngVel), false);
+    physics_state_batch_.add(body, state.w_body_states[i]);
   }
 
   for (auto& w_object_state : state.w_object_states) {
@@ -1262,14 +1426,10 @@ void AHxHandActor::updatePhysicsState(const FHandPhysicsState& state) {
     }
 
     if (body != nullptr && body->IsValidBodyInstance()) {
-      body->SetBodyTransform(
-          FTransform(w_object_state.state.Quaternion, w_object_state.state.Position),
-          ETeleportType::TeleportPhysics);
-      body->SetLinearVelocity(w_object_state.state.LinVel, false);
-      body->SetAngularVelocityInRadians(FMath::DegreesToRadians(w_object_state.state.AngVel),
-          false);
+      physics_state_batch_.add(body, w_object_state.state);
     }
   }
+  writeRigidBodyStates(physics_state_batch_);
 
   if (local_constraints_need_disabled_) {
     local_constraints_need_disabled_ = false;
@@ -1295,7 +1455,175 @@ void AHxHandActor::serverUpdatePhysicsState_Implementation(float time_s,
       pushPhysicsTargets(time_s, state.targets);
     }
   } else {
-    multicastUpdatePhysicsState(time_s, state);
+    if (rewind_history_duration_s_ > 0.0f) {
+      TSet<UPrimitiveComponent*> rejected_comps;
+      arbitrateGraspClaims(time_s, state, rejected_comps);
+      if (rejected_comps.Num() > 0) {
+        // Forward everything except this client's view of objects another player was given.
+        FHandPhysicsState validated_state = state;
+        validated_state.w_object_states.RemoveAll([&](const FObjectPhysicsState& object_state) {
+          return rejected_comps.Contains(object_state.component);
+        });
+        validated_state.constraint_states.RemoveAll(
+            [&](const FConstraintPhysicsState& constraint_state) {
+          return rejected_comps.Contains(constraint_state.component1) ||
+              rejected_comps.Contains(constraint_state.component2);
+        });
+        sendPhysicsStateToRelevantConnections(time_s, validated_state);
+        return;
+      }
+    }
+    sendPhysicsStateToRelevantConnections(time_s, state);
+  }
+}
+
+void AHxHandActor::recordRewindHistory(float time_s) {
+  SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_recordRewindHistory)
+  FHandPhysicsStateFrame& frame = rewind_history_[rewind_history_head_i_];
+  frame.time_s = time_s;
+  getPhysicsStates(frame.state.w_body_states, frame.state.w_object_states);
+  rewind_history_head_i_ = rewind_history_.GetNextIndex(rewind_history_head_i_);
+  rewind_history_num_ =
+      FMath::Min(rewind_history_num_ + 1, static_cast<int>(rewind_history_.Capacity()));
+}
+
+bool AHxHandActor::rewindPhysicsState(float time_s, FHandPhysicsState& state) const {
+  if (rewind_history_num_ <= 0) {
+    return false;
+  }
+
+  int b_i = rewind_history_.GetPreviousIndex(rewind_history_head_i_);
+  const FHandPhysicsStateFrame& newest = rewind_history_[b_i];
+  if (newest.time_s - time_s > rewind_history_duration_s_) {
+    return false;
+  } else if (time_s >= newest.time_s) {
+    state = newest.state;
+    return true;
+  }
+
+  // Walk backwards until we find the frames on either side of the requested time.
+  for (int n = 1; n < rewind_history_num_; n++) {
+    int a_i = rewind_history_.GetPreviousIndex(b_i);
+    const FHandPhysicsStateFrame& a = rewind_history_[a_i];
+    const FHandPhysicsStateFrame& b = rewind_history_[b_i];
+    if (a.time_s <= time_s) {
+      float alpha = b.time_s - a.time_s > 0.0f ? (time_s - a.time_s) / (b.time_s - a.time_s) : 0.0f;
+      state = FHandPhysicsState::interpolate(a.state, b.state, alpha);
+      return true;
+    }
+    b_i = a_i;
+  }
+  return false;
+}
+
+void AHxHandActor::arbitrateGraspClaims(float time_s, const FHandPhysicsState& state,
+    TSet<UPrimitiveComponent*>& rejected_comps) {
+  SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_arbitrateGraspClaims)
+  rejected_comps.Reset();
+  USkeletalMeshComponent* smc = GetSkeletalMeshComponent();
+
+  // Every object the client has a grasp constraint with counts as a claim on that object.
+  TSet<UPrimitiveComponent*> claimed_comps;
+  for (const FConstraintPhysicsState& constraint_state : state.constraint_states) {
+    if (!constraint_state.is_grasp) {
+      continue;
+    }
+    UPrimitiveComponent* object = constraint_state.component1 == smc ?
+        constraint_state.component2 : constraint_state.component1;
+    if (IsValid(object) && object != smc) {
+      claimed_comps.Add(object);
+    }
+  }
+
+  // Forget the objects this hand has let go of.
+  for (auto it = rewind_claim_start_time_s_from_comp_.CreateIterator(); it; ++it) {
+    if (!claimed_comps.Contains(it.Key())) {
+      HxGraspClaim* claim = grasp_claim_from_comp_.Find(it.Key());
+      if (claim != nullptr && claim->hand.Get() == this) {
+        grasp_claim_from_comp_.Remove(it.Key());
+      }
+      rewind_rejected_comps_.Remove(it.Key());
+      it.RemoveCurrent();
+    }
+  }
+
+  bool rewind_attempted = false;
+  bool rewind_succeeded = false;
+  FHandPhysicsState rewound_state;
+  for (UPrimitiveComponent* object : claimed_comps) {
+    float start_time_s = rewind_claim_start_time_s_from_comp_.FindOrAdd(object, time_s);
+    HxGraspClaim& claim = grasp_claim_from_comp_.FindOrAdd(object);
+    AHxHandActor* claim_hand = claim.hand.Get();
+
+    bool is_contested = claim_hand != this && IsValid(claim_hand) &&
+        claim_hand->pawn_ != pawn_ && time_s - claim.last_time_s <= rewind_history_duration_s_;
+    if (is_contested) {
+      // Another player holds this object. The grasp that began earliest keeps it, but only if
+      // the server agrees this hand is where the client says it is. Claims the server can't
+      // rewind to are stale or forged, so they lose.
+      bool challenger_wins = start_time_s < claim.start_time_s;
+      if (challenger_wins) {
+        if (!rewind_attempted) {
+          rewind_attempted = true;
+          rewind_succeeded = rewindPhysicsState(time_s, rewound_state);
+        }
+        challenger_wins =
+            rewind_succeeded && isObjectStateConsistent(object, state, rewound_state);
+      }
+
+      if (!challenger_wins) {
+        rejected_comps.Add(object);
+        rejectGraspClaim(object);
+        continue;
+      }
+      claim_hand->rejectGraspClaim(object);
+    }
+
+    if (claim_hand != this) {
+      claim.hand = this;
+      claim.start_time_s = start_time_s;
+    }
+    claim.last_time_s = time_s;
+    rewind_rejected_comps_.Remove(object);
+  }
+}
+
+bool AHxHandActor::isObjectStateConsistent(UPrimitiveComponent* object,
+    const FHandPhysicsState& state, const FHandPhysicsState& rewound_state) const {
+  bool object_in_zone = false;
+  for (const FObjectPhysicsState& rewound_object_state : rewound_state.w_object_states) {
+    if (rewound_object_state.component != object) {
+      continue;
+    }
+    object_in_zone = true;
+
+    for (const FObjectPhysicsState& object_state : state.w_object_states) {
+      if (object_state.component == object &&
+          object_state.body_index == rewound_object_state.body_index &&
+          FVector::Dist(object_state.state.Position, rewound_object_state.state.Position) >
+          rewind_pose_tolerance_cm_) {
+        return false;
+      }
+    }
+  }
+  return object_in_zone;
+}
+
+void AHxHandActor::rejectGraspClaim(UPrimitiveComponent* object) {
+  if (!rewind_rejected_comps_.Contains(object)) {
+    rewind_rejected_comps_.Add(object);
+    clientRejectGraspClaim(object);
+  }
+}
+
+void AHxHandActor::clientRejectGraspClaim_Implementation(UPrimitiveComponent* object) {
+  // Stop pulling on the object locally. The constraints are destroyed as usual once the grasp
+  // releases.
+  for (auto& constraint : local_constraints_) {
+    if (IsValid(constraint) && (constraint->OverrideComponent1.Get() == object ||
+        constraint->OverrideComponent2.Get() == object)) {
+      setConstraintPhysicallyEnabled(constraint, false);
+    }
   }
 }
 
@@ -1311,6 +1639,81 @@ void AHxHandActor::multicastUpdatePhysicsState_Implementation(float time_s,
   }
 }
 
+void AHxHandActor::sendPhysicsStateToRelevantConnections(float time_s,
+    const FHandPhysicsState& state) {
+  // Unreliable multicasts are only sent to connections for which IsNetRelevantFor() passes, which
+  // is where per-connection interest management happens.
+  is_sending_physics_state_multicast_ = true;
+  multicastUpdatePhysicsState(time_s, state);
+  is_sending_physics_state_multicast_ = false;
+  physics_state_multicast_count_++;
+}
+
+bool AHxHandActor::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget,
+    const FVector& SrcLocation) const {
+  if (!Super::IsNetRelevantFor(RealViewer, ViewTarget, SrcLocation)) {
+    return false;
+  }
+
+  return !is_sending_physics_state_multicast_ || isPhysicsStateRelevantFor(RealViewer,
+      SrcLocation);
+}
+
+bool AHxHandActor::isPhysicsStateRelevantFor(const AActor* real_viewer,
+    const FVector& w_view_location_cm) const {
+  const APlayerController* player_controller = Cast<APlayerController>(real_viewer);
+  if (!IsValid(player_controller)) {
+    return true;
+  }
+
+  // The controlling player always receives its own hands' state.
+  const APawn* viewer_pawn = player_controller->GetPawn();
+  if (viewer_pawn == nullptr || viewer_pawn == pawn_) {
+    return true;
+  }
+
+  // Players whose hands share objects with this hand need the full rate to interact smoothly.
+  for (auto& it : objects_in_physics_authority_zone_) {
+    const FGlobalPhysicsAuthorityObjectData* global_data =
+        global_physics_authority_data_from_comp_.Find(it.Key);
+    if (global_data != nullptr &&
+        global_data->physics_authority_zone_count_from_pawn.Contains(viewer_pawn)) {
+      return true;
+    }
+  }
+
+  const FVector w_hand_pos_cm = GetActorLocation();
+  const float dist_sq_cm2 = FVector::DistSquared(w_hand_pos_cm, w_view_location_cm);
+  if (physics_state_cull_distance_cm_ > 0.0f &&
+      dist_sq_cm2 > physics_state_cull_distance_cm_ * physics_state_cull_distance_cm_) {
+    return false;
+  }
+
+  bool full_rate =
+      dist_sq_cm2 <= physics_state_full_rate_distance_cm_ * physics_state_full_rate_distance_cm_;
+  if (full_rate && physics_state_view_culling_) {
+    FVector w_view_pos_cm;
+    FRotator w_view_rot;
+    player_controller->GetPlayerViewPoint(w_view_pos_cm, w_view_rot);
+    const float fov_deg = IsValid(player_controller->PlayerCameraManager) ?
+        player_controller->PlayerCameraManager->GetFOVAngle() : 90.0f;
+    const float half_angle_deg =
+        FMath::Min(0.5f * fov_deg + physics_state_view_margin_deg_, 180.0f);
+    const FVector w_to_hand = (w_hand_pos_cm - w_view_pos_cm).GetSafeNormal();
+    full_rate = FVector::DotProduct(w_view_rot.Vector(), w_to_hand) >=
+        FMath::Cos(FMath::DegreesToRadians(half_angle_deg));
+  }
+
+  if (full_rate || physics_state_reduced_rate_divisor_ <= 1) {
+    return true;
+  }
+
+  // Stagger reduced rate transmissions so that different connections receive them on different
+  // multicasts.
+  const uint32 divisor = static_cast<uint32>(physics_state_reduced_rate_divisor_);
+  return (physics_state_multicast_count_ + GetTypeHash(real_viewer)) % divisor == 0u;
+}
+
 void AHxHandActor::updateReplicatedConstraints(const TArray<FConstraintPhysicsState>& states) {
   SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_updateReplicatedConstraints)
   TSet<int32> new_constraint_ids;
@@ -1321,6 +1724,17 @@ void AHxHandActor::updateReplicatedConstraints(const TArray<FConstraintPhysicsSt
     const FConstraintPhysicsState& constraint_state = states[i];
     new_constraint_ids.Add(constraint_state.id);
 
+    // Pooled constraints keep their ids when retargeted, so a known id may now constrain
+    // different components.
+    UPhysicsConstraintComponent** existing_constraint =
+        replicated_constraints_.Find(constraint_state.id);
+    if (existing_constraint != nullptr && IsValid(*existing_constraint) &&
+        ((*existing_constraint)->OverrideComponent1.Get() != constraint_state.component1 ||
+        (*existing_constraint)->OverrideComponent2.Get() != constraint_state.component2)) {
+      destroyPhysicsConstraintComponent(*existing_constraint);
+      replicated_constraints_.Remove(constraint_state.id);
+    }
+
     if (!replicated_constraints_.Contains(constraint_state.id)) {
       UPhysicsConstraintComponent* constraint = NewObject<UPhysicsConstraintComponent>(this);
       constraint->RegisterComponent();
@@ -1353,6 +1767,88 @@ void AHxHandActor::updateReplicatedConstraints(const TArray<FConstraintPhysicsSt
   }
 }
 
+void AHxHandActor::updatePhysicsLod() {
+  SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_updatePhysicsLod)
+  // How long a hand can go without being rendered before it's considered off-screen [s].
+  static constexpr float RENDER_TIMEOUT_S = 0.5f;
+
+  // Only hands that are following replicated physics state are candidates. This excludes dedicated
+  // servers, which have no local view to judge by.
+  bool should_be_kinematic = false;
+  USkeletalMeshComponent* smc = GetSkeletalMeshComponent();
+  UWorld* world = GetWorld();
+  APlayerController* player_controller = IsValid(world) ?
+      world->GetFirstPlayerController() : nullptr;
+  if (physics_lod_enabled_ && !isLocallyControlled() && !isPhysicsAuthority() &&
+      IsValid(smc) && IsValid(player_controller) && !isPhysicsLodInteracting()) {
+    FVector w_view_location_cm;
+    FRotator w_view_rotation;
+    player_controller->GetPlayerViewPoint(w_view_location_cm, w_view_rotation);
+
+    // Move the threshold away from the current state so hands near it don't flutter.
+    float lod_distance_cm = physics_lod_distance_cm_ * (is_physics_lod_kinematic_ ?
+        1.0f - physics_lod_hysteresis_ : 1.0f + physics_lod_hysteresis_);
+    bool is_far = physics_lod_distance_cm_ > 0.0f && FVector::DistSquared(
+        smc->Bounds.Origin, w_view_location_cm) > FMath::Square(lod_distance_cm);
+    bool is_off_screen = physics_lod_off_screen_ && !smc->WasRecentlyRendered(RENDER_TIMEOUT_S);
+    should_be_kinematic = is_far || is_off_screen;
+  }
+
+  if (should_be_kinematic != is_physics_lod_kinematic_) {
+    setPhysicsLodKinematic(should_be_kinematic);
+  }
+}
+
+bool AHxHandActor::isPhysicsLodInteracting() const {
+  // Overlapping another player's physics authority zone.
+  if (num_physics_authority_zone_overlaps_ > 0) {
+    return true;
+  }
+
+  // Sharing an object with another player's physics authority zone.
+  for (auto& it : objects_in_physics_authority_zone_) {
+    const FGlobalPhysicsAuthorityObjectData* global_data =
+        global_physics_authority_data_from_comp_.Find(it.Key);
+    if (global_data != nullptr && global_data->physics_authority_zone_count_from_pawn.Num() > 1) {
+      return true;
+    }
+  }
+
+  // Within reach of a local hand.
+  USkeletalMeshComponent* smc = GetSkeletalMeshComponent();
+  if (!IsValid(smc)) {
+    return false;
+  }
+  for (AHxHandActor* local_hand : {getLeftHand(), getRightHand()}) {
+    USkeletalMeshComponent* local_smc = IsValid(local_hand) ?
+        local_hand->GetSkeletalMeshComponent() : nullptr;
+    if (IsValid(local_smc) && FVector::DistSquared(smc->Bounds.Origin,
+        local_smc->Bounds.Origin) < FMath::Square(physics_lod_interaction_radius_cm_)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void AHxHandActor::setPhysicsLodKinematic(bool kinematic) {
+  USkeletalMeshComponent* smc = GetSkeletalMeshComponent();
+  if (!IsValid(smc)) {
+    return;
+  }
+
+  is_physics_lod_kinematic_ = kinematic;
+  // While kinematic, updatePhysicsState() poses the bodies directly. The rendered pose must be
+  // read back from the bodies and animation must not overwrite them.
+  smc->bBlendPhysics = kinematic;
+  smc->KinematicBonesUpdateType = kinematic ? EKinematicBonesUpdateToPhysics::SkipAllBones :
+      EKinematicBonesUpdateToPhysics::SkipSimulatingBones;
+  smc->SetSimulatePhysics(!kinematic);
+  if (!kinematic) {
+    // Bodies resume from wherever playback left them and receive velocities on the next update.
+    smc->WakeAllRigidBodies();
+  }
+}
+
 void AHxHandActor::teleportHand(const FVector& w_position_cm, const FQuat& w_orient) {
   USkeletalMeshComponent* smc = GetSkeletalMeshComponent();
   if (!IsValid(smc)) {
@@ -1440,11 +1936,29 @@ void AHxHandActor::initPalmConstraint() {
   }
 }
 
-UPhysicsConstraintComponent* AHxHandActor::createContactDampingConstraint(
+UPhysicsConstraintComponent* AHxHandActor::acquireContactDampingConstraint(
     UPrimitiveComponent* other_comp, FName other_bone) {
-  UPhysicsConstraintComponent* damping_constraint = NewObject<UPhysicsConstraintComponent>(
-      this, UPhysicsConstraintComponent::StaticClass());
-  damping_constraint->RegisterComponent();
+  UPhysicsConstraintComponent* damping_constraint = nullptr;
+  while (damping_constraint_pool_.Num() > 0 && !IsValid(damping_constraint)) {
+    damping_constraint = damping_constraint_pool_.Pop(false);
+  }
+
+  if (!IsValid(damping_constraint)) {
+    damping_constraint = NewObject<UPhysicsConstraintComponent>(
+        this, UPhysicsConstraintComponent::StaticClass());
+    damping_constraint->RegisterComponent();
+    damping_constraint->ConstraintInstance.SetLinearXMotion(ELinearConstraintMotion::LCM_Free);
+    damping_constraint->ConstraintInstance.SetLinearYMotion(ELinearConstraintMotion::LCM_Free);
+    damping_constraint->ConstraintInstance.SetLinearZMotion(ELinearConstraintMotion::LCM_Free);
+    damping_constraint->ConstraintInstance.SetAngularTwistMotion(
+        EAngularConstraintMotion::ACM_Free);
+    damping_constraint->ConstraintInstance.SetAngularSwing1Motion(
+        EAngularConstraintMotion::ACM_Free);
+    damping_constraint->ConstraintInstance.SetAngularSwing2Motion(
+        EAngularConstraintMotion::ACM_Free);
+    damping_constraint->ConstraintInstance.ProfileInstance.AngularDrive.AngularDriveMode =
+        EAngularDriveMode::SLERP;
+  }
 
   // Center the constraint on the other body to decouple the bodies translation from the
   // constraint's rotation.
@@ -1452,15 +1966,9 @@ UPhysicsConstraintComponent* AHxHandActor::createContactDampingConstraint(
   if (other_body != nullptr) {
     damping_constraint->SetWorldLocation(other_body->GetCOMPosition());
   }
-  damping_constraint->ConstraintInstance.SetLinearXMotion(ELinearConstraintMotion::LCM_Free);
-  damping_constraint->ConstraintInstance.SetLinearYMotion(ELinearConstraintMotion::LCM_Free);
-  damping_constraint->ConstraintInstance.SetLinearZMotion(ELinearConstraintMotion::LCM_Free);
-  damping_constraint->ConstraintInstance.SetAngularTwistMotion(EAngularConstraintMotion::ACM_Free);
-  damping_constraint->ConstraintInstance.SetAngularSwing1Motion(
-      EAngularConstraintMotion::ACM_Free);
-  damping_constraint->ConstraintInstance.SetAngularSwing2Motion(
-      EAngularConstraintMotion::ACM_Free);
 
+  // Damping may differ per object, so drives are configured every time the constraint is
+  // retargeted.
   FConstraintDrive linear_damping_drive;
   linear_damping_drive.bEnableVelocityDrive = true;
   UHxPhysicalMaterial* hx_phys_mat =
@@ -1478,8 +1986,6 @@ UPhysicsConstraintComponent* AHxHandActor::createContactDampingConstraint(
   damping_constraint->ConstraintInstance.ProfileInstance.LinearDrive.XDrive = linear_damping_drive;
   damping_constraint->ConstraintInstance.ProfileInstance.LinearDrive.YDrive = linear_damping_drive;
   damping_constraint->ConstraintInstance.ProfileInstance.LinearDrive.ZDrive = linear_damping_drive;
-  damping_constraint->ConstraintInstance.ProfileInstance.AngularDrive.AngularDriveMode =
-      EAngularDriveMode::SLERP;
   damping_constraint->ConstraintInstance.ProfileInstance.AngularDrive.SlerpDrive =
       angular_damping_drive;
   damping_constraint->SetLinearVelocityTarget(FVector::ZeroVector);
@@ -1489,6 +1995,18 @@ UPhysicsConstraintComponent* AHxHandActor::createContactDampingConstraint(
   return damping_constraint;
 }
 
+void AHxHandActor::releaseContactDampingConstraint(UPhysicsConstraintComponent* constraint) {
+  if (!IsValid(constraint)) {
+    return;
+  }
+
+  notifyLocalConstraintDestroyed(constraint);
+  constraint->BreakConstraint();
+  constraint->OverrideComponent1 = nullptr;
+  constraint->OverrideComponent2 = nullptr;
+  damping_constraint_pool_.Add(constraint);
+}
+
 void AHxHandActor::onPhysicsAuthorityZoneBeginOverlap(UPrimitiveComponent* overlapped_component,
     AActor* other_actor, UPrimitiveComponent* other_comp, int32 other_body_index,
     bool from_sweep, const FHitResult& sweep_result) {
@@ -1496,39 +2014,11 @@ void AHxHandActor::onPhysicsAuthorityZoneBeginOverlap(UPrimitiveComponent* overl
     return;
   }
 
-  // If it's another hand, increment our tracker and return early.
-  AHxHandActor* other_hand_actor = Cast<AHxHandActor>(other_actor);
-  if (IsValid(other_hand_actor) && other_hand_actor->PhysicsAuthorityZone == other_comp) {
-    if (other_hand_actor->pawn_ != pawn_) {
-      num_physics_authority_zone_overlaps_++;
-      if (num_physics_authority_zone_overlaps_ == 1 && IsValid(PhysicsAuthorityZone)) {
-        PhysicsAuthorityZone->SetSphereRadius(physics_authority_zone_radius_enlarged_cm_);
-      }
-    }
-    return;
-  }
-
-  // Increment our internal overlap tracking map.
-  int& internal_count = objects_in_physics_authority_zone_.FindOrAdd(other_comp);
-  internal_count++;
-
-  // Increment the global overlap tracking map.
-  FGlobalPhysicsAuthorityObjectData& global_data =
-      global_physics_authority_data_from_comp_.FindOrAdd(other_comp);
-  int& global_count = global_data.physics_authority_zone_count_from_pawn.FindOrAdd(pawn_, 0);
-  global_count++;
-
-  // While an object is being managed by HaptX's networking system we must make sure Unreal's
-  // replicate movement feature is disabled on the object.
-  // Apparently Unreal's replicate movement feature only operates on the root component of the
-  // actor.
-  if (!isAuthoritative() && global_data.physics_authority_zone_count_from_pawn.Num() == 1 &&
-      global_count == 1 && isMovementReplicated(other_comp)) {
-    other_actor->bReplicateMovement = false;
-    global_data.was_replicating_movement = true;
-    // It's unsafe to clear replication targets at this time.
-    comps_that_need_replication_targets_removed_.Add(other_comp);
-  }
+  HxPhysicsAuthorityZoneOverlap overlap;
+  overlap.hand = this;
+  overlap.other_comp = other_comp;
+  overlap.delta = 1;
+  pending_physics_authority_zone_overlaps_.Add(overlap);
 }
 
 void AHxHandActor::onPhysicsAuthorityZoneEndOverlap(UPrimitiveComponent* overlapped_component,
@@ -1537,49 +2027,148 @@ void AHxHandActor::onPhysicsAuthorityZoneEndOverlap(UPrimitiveComponent* overlap
     return;
   }
 
-  AHxHandActor* other_hand_actor = Cast<AHxHandActor>(other_actor);
-  if (IsValid(other_hand_actor) && other_hand_actor->PhysicsAuthorityZone == other_comp &&
-      other_hand_actor->pawn_ != pawn_) {
-    num_physics_authority_zone_overlaps_--;
-    if (num_physics_authority_zone_overlaps_ == 0 && IsValid(PhysicsAuthorityZone)) {
-      PhysicsAuthorityZone->SetSphereRadius(physics_authority_zone_radius_nominal_cm_);
-    }
+  HxPhysicsAuthorityZoneOverlap overlap;
+  overlap.hand = this;
+  overlap.other_comp = other_comp;
+  overlap.delta = -1;
+  pending_physics_authority_zone_overlaps_.Add(overlap);
+}
+
+void AHxHandActor::processPhysicsAuthorityZoneOverlaps() {
+  if (physics_authority_zone_overlaps_frame_ == GFrameCounter) {
+    return;
+  }
+  physics_authority_zone_overlaps_frame_ = GFrameCounter;
+  if (pending_physics_authority_zone_overlaps_.Num() == 0) {
     return;
   }
+  SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_processPhysicsAuthorityZoneOverlaps)
 
-  int* internal_count = objects_in_physics_authority_zone_.Find(other_comp);
-  if (internal_count != nullptr) {
-    (*internal_count)--;
+  // Take the queue so that any overlaps generated while processing wait for the next frame.
+  TArray<HxPhysicsAuthorityZoneOverlap> overlaps =
+      MoveTemp(pending_physics_authority_zone_overlaps_);
+  pending_physics_authority_zone_overlaps_.Reset();
 
-    if ((*internal_count) <= 0) {
-      objects_in_physics_authority_zone_.Remove(other_comp);
+  // Coalesce events into one net change per hand and component, in the order they first occurred.
+  TArray<HxPhysicsAuthorityZoneOverlap> net_overlaps;
+  TMap<TPair<AHxHandActor*, UPrimitiveComponent*>, int32> net_overlap_index_from_key;
+  for (const HxPhysicsAuthorityZoneOverlap& overlap : overlaps) {
+    TPair<AHxHandActor*, UPrimitiveComponent*> key(overlap.hand.Get(), overlap.other_comp.Get());
+    if (key.Key == nullptr || key.Value == nullptr) {
+      continue;
     }
-  }
 
-  auto global_data_it = global_physics_authority_data_from_comp_.Find(other_comp);
-  if (global_data_it != nullptr) {
-    FGlobalPhysicsAuthorityObjectData& global_data = (*global_data_it);
+    int32* net_overlap_index = net_overlap_index_from_key.Find(key);
+    if (net_overlap_index != nullptr) {
+      net_overlaps[*net_overlap_index].delta += overlap.delta;
+    } else {
+      net_overlap_index_from_key.Add(key, net_overlaps.Add(overlap));
+    }
+  }
 
-    int* global_count_it = global_data.physics_authority_zone_count_from_pawn.Find(pawn_);
-    if (global_count_it != nullptr) {
-      int& global_count = (*global_count_it);
+  bool authority_inputs_changed = false;
+  TMap<UPrimitiveComponent*, bool> comps_to_update;
+  for (const HxPhysicsAuthorityZoneOverlap& net_overlap : net_overlaps) {
+    AHxHandActor* hand = net_overlap.hand.Get();
+    UPrimitiveComponent* other_comp = net_overlap.other_comp.Get();
+    if (net_overlap.delta != 0 && IsValid(hand) && IsValid(other_comp)) {
+      authority_inputs_changed |= hand->applyPhysicsAuthorityZoneOverlap(other_comp,
+          net_overlap.delta, comps_to_update);
+    }
+  }
 
-      global_count--;
-      if (global_count <= 0) {
-        global_data.physics_authority_zone_count_from_pawn.Remove(pawn_);
+  // While an object is being managed by HaptX's networking system we must make sure Unreal's
+  // replicate movement feature is disabled on the object. Apparently Unreal's replicate movement
+  // feature only operates on the root component of the actor.
+  for (auto& it : comps_to_update) {
+    UPrimitiveComponent* comp = it.Key;
+    bool changed_by_client = it.Value;
+    FGlobalPhysicsAuthorityObjectData* global_data =
+        global_physics_authority_data_from_comp_.Find(comp);
+    if (global_data == nullptr) {
+      continue;
+    }
 
-        if (global_data.physics_authority_zone_count_from_pawn.Num() == 0) {
-          if (!isAuthoritative() && global_data.was_replicating_movement) {
-            other_actor->bReplicateMovement = true;
-          }
+    AActor* owner = comp->GetOwner();
+    if (global_data->physics_authority_zone_count_from_pawn.Num() > 0) {
+      if (changed_by_client && !global_data->was_replicating_movement && IsValid(owner) &&
+          isMovementReplicated(comp)) {
+        owner->bReplicateMovement = false;
+        global_data->was_replicating_movement = true;
 
-          global_physics_authority_data_from_comp_.Remove(other_comp);
+        UWorld* world = comp->GetWorld();
+        FPhysScene* phys_scene = IsValid(world) ? world->GetPhysicsScene() : nullptr;
+        FPhysicsReplication* phys_rep =
+            phys_scene != nullptr ? phys_scene->GetPhysicsReplication() : nullptr;
+        if (phys_rep != nullptr) {
+          phys_rep->RemoveReplicatedTarget(comp);
         }
       }
+    } else {
+      if (changed_by_client && global_data->was_replicating_movement && IsValid(owner)) {
+        owner->bReplicateMovement = true;
+      }
+      global_physics_authority_data_from_comp_.Remove(comp);
+    }
+  }
+
+  // Arbitrate physics authority across all pawns now that every overlap has been applied.
+  if (authority_inputs_changed) {
+    for (auto it = physics_authority_hands_.CreateIterator(); it; ++it) {
+      AHxHandActor* hand = it->Get();
+      if (!IsValid(hand)) {
+        it.RemoveCurrent();
+        continue;
+      }
+
+      if (hand->is_enabled_ && hand->isAuthoritative()) {
+        hand->serverUpdatePhysicsAuthority();
+      }
     }
   }
 }
 
+bool AHxHandActor::applyPhysicsAuthorityZoneOverlap(UPrimitiveComponent* other_comp, int delta,
+    TMap<UPrimitiveComponent*, bool>& comps_to_update) {
+  // If it's another pawn's hand, update our tracker and return early.
+  AHxHandActor* other_hand_actor = Cast<AHxHandActor>(other_comp->GetOwner());
+  if (IsValid(other_hand_actor) && other_hand_actor->PhysicsAuthorityZone == other_comp) {
+    if (other_hand_actor->pawn_ == pawn_) {
+      return false;
+    }
+
+    bool was_overlapping = num_physics_authority_zone_overlaps_ > 0;
+    num_physics_authority_zone_overlaps_ =
+        FMath::Max(0, num_physics_authority_zone_overlaps_ + delta);
+    bool is_overlapping = num_physics_authority_zone_overlaps_ > 0;
+    if (was_overlapping != is_overlapping && IsValid(PhysicsAuthorityZone)) {
+      PhysicsAuthorityZone->SetSphereRadius(is_overlapping ?
+          physics_authority_zone_radius_enlarged_cm_ : physics_authority_zone_radius_nominal_cm_);
+    }
+    return was_overlapping != is_overlapping;
+  }
+
+  // Update our internal overlap tracking map.
+  int& internal_count = objects_in_physics_authority_zone_.FindOrAdd(other_comp);
+  internal_count += delta;
+  if (internal_count <= 0) {
+    objects_in_physics_authority_zone_.Remove(other_comp);
+  }
+
+  // Update the global overlap tracking map. Empty entries are removed by the caller.
+  FGlobalPhysicsAuthorityObjectData& global_data =
+      global_physics_authority_data_from_comp_.FindOrAdd(other_comp);
+  int& global_count = global_data.physics_authority_zone_count_from_pawn.FindOrAdd(pawn_, 0);
+  global_count += delta;
+  if (global_count <= 0) {
+    global_data.physics_authority_zone_count_from_pawn.Remove(pawn_);
+  }
+
+  bool& changed_by_client = comps_to_update.FindOrAdd(other_comp, false);
+  changed_by_client = changed_by_client || !isAuthoritative();
+  return true;
+}
+
 bool AHxHandActor::serverUpdatePhysicsAuthority_Validate() {
   return true;
 }
@@ -1593,6 +2182,8 @@ void AHxHandActor::serverUpdatePhysicsAuthority_Implementation() {
   bool is_client_physics_authority_cached = is_client_physics_authority_;
 
   EPhysicsAuthorityMode mode = hx_core_->getPhysicsAuthorityMode();
+  physics_authority_needs_update_ = false;
+  physics_authority_mode_evaluated_ = mode;
   switch (mode) {
   case (EPhysicsAuthorityMode::DYNAMIC): {
     // Evaluate whether any multi-player interactions are happening.
@@ -1631,15 +2222,25 @@ bool AHxHandActor::isPhysicsAuthority() const {
       (isLocallyControlled() && is_client_physics_authority_);
 }
 
-void AHxHandActor::getPhysicsStatesOfObjectsInAuthorityZone(
+void AHxHandActor::getPhysicsStates(TArray<FRigidBodyState>& w_body_states,
     TArray<FObjectPhysicsState>& object_states) {
+  USkeletalMeshComponent* hand_smc = GetSkeletalMeshComponent();
+  int num_hand_bodies = IsValid(hand_smc) ? hand_smc->Bodies.Num() : 0;
+
   // There will be at least one FBodyInstance per overlap.
   int num_overlaps = 0;
   for (auto& it : objects_in_physics_authority_zone_) {
     num_overlaps += it.Value;
   }
   object_states.Empty(num_overlaps);
+  physics_state_batch_.reset(num_hand_bodies + num_overlaps);
 
+  // The hand's bodies occupy the beginning of the batch.
+  for (int i = 0; i < num_hand_bodies; i++) {
+    physics_state_batch_.add(hand_smc->Bodies[i]);
+  }
+
+  // Object bodies follow the hand's in the batch, in the same order as object_states.
   for (auto& iter : objects_in_physics_authority_zone_) {
     UPrimitiveComponent* comp = iter.Key;
     if (!IsValid(comp)) {
@@ -1658,8 +2259,8 @@ void AHxHandActor::getPhysicsStatesOfObjectsInAuthorityZone(
         FObjectPhysicsState w_object_state;
         w_object_state.component = comp;
         w_object_state.body_index = body->InstanceBodyIndex;
-        body->GetRigidBodyState(w_object_state.state);
         object_states.Add(w_object_state);
+        physics_state_batch_.add(body);
       }
     } else {
       if (!comp->BodyInstance.IsValidBodyInstance() || !comp->BodyInstance.bSimulatePhysics) {
@@ -1669,10 +2270,20 @@ void AHxHandActor::getPhysicsStatesOfObjectsInAuthorityZone(
       FObjectPhysicsState w_object_state;
       w_object_state.component = comp;
       w_object_state.body_index = comp->BodyInstance.InstanceBodyIndex;
-      comp->BodyInstance.GetRigidBodyState(w_object_state.state);
       object_states.Add(w_object_state);
+      physics_state_batch_.add(&comp->BodyInstance);
     }
   }
+
+  readRigidBodyStates(physics_state_batch_);
+
+  w_body_states.SetNum(num_hand_bodies);
+  for (int i = 0; i < num_hand_bodies; i++) {
+    w_body_states[i] = physics_state_batch_.getState(i);
+  }
+  for (int i = 0; i < object_states.Num(); i++) {
+    object_states[i].state = physics_state_batch_.getState(num_hand_bodies + i);
+  }
 }
 
 void AHxHandActor::getLocalConstraintStates(TArray<FConstraintPhysicsState>& constraint_states) {
@@ -1685,6 +2296,7 @@ void AHxHandActor::getLocalConstraintStates(TArray<FConstraintPhysicsState>& con
       constraint_state.component2 = constraint->OverrideComponent2.Get();
       constraint_state.w_scale = constraint->GetComponentScale();
       constraint_state.constraint_instance = constraint->ConstraintInstance;
+      constraint_state.is_grasp = damping_constraint_from_object_id_.FindKey(constraint) == nullptr;
       constraint_states.Add(constraint_state);
     }
   }
@@ -1792,7 +2404,12 @@ void AHxHandActor::updateHandAnimation(float delta_time) {
       last_simulated_anim_frame_ = HaptxApi::SimulatedGestures::getAnimFrame(gesture_, 0.0f);
     }
 
-    if (HaptxApi::OpenvrWrapper::isReady()) {
+    if (scripted_input_) {
+      HaptxApi::AnimFrame target_anim_frame = HaptxApi::SimulatedGestures::getAnimFrame(gesture_,
+          scripted_trigger_value_);
+      last_simulated_anim_frame_ = HaptxApi::AnimFrame::slerp(last_simulated_anim_frame_,
+          target_anim_frame, delta_time * simulated_animation_aggressiveness_1_s);
+    } else if (HaptxApi::OpenvrWrapper::isReady()) {
       bool touch_pad_pressed = false;
       if (HaptxApi::OpenvrWrapper::getControllerButtonPressed(HaptxApi::RelativeDirection(hand_),
           HaptxApi::ControllerButton::TOUCH_PAD, &touch_pad_pressed) ==
@@ -1940,13 +2557,15 @@ void AHxHandActor::updateHandAnimation(float delta_time) {
 }
 
 void AHxHandActor::loadUserProfile() {
-  std::wstring active_username;
-  if (!HaptxApi::UserProfileDatabase::getActiveUsername(&active_username) ||
-      !HaptxApi::UserProfileDatabase::getUserProfile(active_username, &user_profile_)) {
+  if (!is_enabled_ || !HxUserProfileService::isLoaded()) {
+    return;
+  }
+
+  if (!HxUserProfileService::hasActiveProfile()) {
     AHxCoreActor::logWarning(
         "Failed to load active user profile. Using the default profile instead.", true);
-    user_profile_ = HaptxApi::UserProfile();
   }
+  user_profile_ = HxUserProfileService::getUserProfile();
   if (glove_ == nullptr) {
     AHxCoreActor::logError("AHxHandActor::loadUserProfile(): Null glove.");
     return;
@@ -2025,11 +2644,8 @@ void AHxHandActor::loadUserProfile() {
     return;
   }
 
-  float w_uhp_middle_finger_length =
-      user_profile_.finger_bone_lengths_m[HaptxApi::Finger::F_MIDDLE][HaptxApi::FingerBone::FB_PROXIMAL] +
-      user_profile_.finger_bone_lengths_m[HaptxApi::Finger::F_MIDDLE][HaptxApi::FingerBone::FB_MEDIAL] +
-      user_profile_.finger_bone_lengths_m[HaptxApi::Finger::F_MIDDLE][HaptxApi::FingerBone::FB_DISTAL];
-  float w_uhp_hand_scale_factor = w_uhp_middle_finger_length / w_default_middle_finger_length_m;
+  float w_uhp_hand_scale_factor =
+      HxUserProfileService::getMiddleFingerLengthM() / w_default_middle_finger_length_m;
 
   serverUserProfileUpdate(hand_material, mesh, w_uhp_hand_scale_factor);
 }
@@ -2061,6 +2677,12 @@ bool AHxHandActor::tryGetHandLocationAndRotation(FTransform& w_mcp3, FTransform&
     return false;
   }
 
+  if (scripted_input_) {
+    w_mcp3 = scripted_w_mcp3_;
+    w_vive = scripted_w_mcp3_;
+    return true;
+  }
+
   if (!HaptxApi::OpenvrWrapper::isReady()) {
     return false;
   }
@@ -2423,6 +3045,27 @@ bool AHxHandActor::initializeDisplacementVisualizer() {
   dis_vis_pmc_->SetWorldLocationAndRotation(smc->GetComponentLocation(), smc->GetComponentQuat());
   dis_vis_pmc_->SetWorldScale3D(smc->GetComponentScale());
 
+  // Cache everything needed to write physics targets straight into the pose.
+  dis_vis_palm_bone_index_ = dis_vis_pmc_->GetBoneIndex(bone_names_.palm);
+  for (int f_i = 0; f_i < HaptxApi::F_LAST; f_i++) {
+    for (int fj_i = 0; fj_i < HaptxApi::FJ_LAST; fj_i++) {
+      dis_vis_joint_bone_indices_[f_i][fj_i] = INDEX_NONE;
+      dis_vis_joint_base_rotations_[f_i][fj_i] = FQuat::Identity;
+      if (joints_[f_i][fj_i] == nullptr) {
+        continue;
+      }
+
+      int32 bone_index = dis_vis_pmc_->GetBoneIndex(hand_joint_bone_names_[f_i][fj_i]);
+      if (bone_index > 0 && bone_index < dis_vis_pmc_->BoneSpaceTransforms.Num()) {
+        dis_vis_joint_bone_indices_[f_i][fj_i] = bone_index;
+        dis_vis_joint_base_rotations_[f_i][fj_i] = UKismetMathLibrary::MakeRotFromXY(
+            joints_[f_i][fj_i]->PriAxis2, joints_[f_i][fj_i]->SecAxis2).Quaternion();
+      }
+    }
+  }
+  dis_vis_targets_dirty_ = false;
+  dis_vis_time_since_update_s_ = 0.0f;
+
   // Setup our custom material and sync relevant variables.
   dis_vis_mat_inst_ = UMaterialInstanceDynamic::Create(dis_vis_mat_, this);
   if (!IsValid(dis_vis_mat_inst_)) {
@@ -2446,13 +3089,61 @@ void AHxHandActor::updateDisplacementVisualizer(float delta_time_s) {
     return;
   }
 
-  // Compute the greatest displacement between hand bones.
-  TArray<FName> bone_names;
-  smc->GetBoneNames(bone_names);
+  dis_vis_time_since_update_s_ += delta_time_s;
+  if (dis_vis_parameters_.update_rate_hz > 0.0f &&
+      dis_vis_time_since_update_s_ < 1.0f / dis_vis_parameters_.update_rate_hz) {
+    return;
+  }
+  dis_vis_time_since_update_s_ = 0.0f;
+
+  // Write the latest physics targets into the pose in one pass.
+  TArray<FTransform>& bone_space_transforms = dis_vis_pmc_->BoneSpaceTransforms;
+  if (dis_vis_targets_dirty_) {
+    dis_vis_targets_dirty_ = false;
+
+    FQuat w_middle1_orient = dis_vis_targets_.w_middle1_orient;
+    FVector w_palm_pos_cm = dis_vis_targets_.w_middle1_pos_cm -
+        w_middle1_orient.RotateVector(l_middle1_cm_);
+    if (bone_space_transforms.IsValidIndex(dis_vis_palm_bone_index_) &&
+        dis_vis_pmc_->SkeletalMesh->RefSkeleton.GetParentIndex(dis_vis_palm_bone_index_) ==
+        INDEX_NONE) {
+      // The palm is the root bone, so its bone space is component space.
+      FTransform& l_palm = bone_space_transforms[dis_vis_palm_bone_index_];
+      const FTransform& w_pmc = dis_vis_pmc_->GetComponentTransform();
+      l_palm.SetLocation(w_pmc.InverseTransformPosition(w_palm_pos_cm));
+      l_palm.SetRotation(w_pmc.InverseTransformRotation(w_middle1_orient));
+    } else {
+      dis_vis_pmc_->SetBoneLocationByName(bone_names_.palm, w_palm_pos_cm,
+          EBoneSpaces::WorldSpace);
+      dis_vis_pmc_->SetBoneRotationByName(bone_names_.palm, w_middle1_orient.Rotator(),
+          EBoneSpaces::WorldSpace);
+    }
+
+    static const int num_joints = HaptxApi::F_LAST * HaptxApi::FJ_LAST;
+    if (dis_vis_targets_.l_joint_orients.Num() == num_joints) {
+      for (int f_i = 0; f_i < HaptxApi::F_LAST; f_i++) {
+        for (int fj_i = 0; fj_i < HaptxApi::FJ_LAST; fj_i++) {
+          int32 bone_index = dis_vis_joint_bone_indices_[f_i][fj_i];
+          if (bone_index == INDEX_NONE) {
+            continue;
+          }
+
+          bone_space_transforms[bone_index].SetRotation(
+              dis_vis_joint_base_rotations_[f_i][fj_i] *
+              dis_vis_targets_.l_joint_orients[HaptxApi::FJ_LAST * f_i + fj_i]);
+        }
+      }
+    }
+    dis_vis_pmc_->MarkRefreshTransformDirty();
+  }
+
+  // Compute the greatest displacement between hand bones. Both components share a skeletal mesh,
+  // so bone indices match.
+  int32 num_bones = FMath::Min(smc->GetNumBones(), dis_vis_pmc_->GetNumBones());
   float max_distance = 0.0f;
-  for (const FName& bone_name : bone_names) {
-    float distance = (smc->GetBoneLocation(bone_name, EBoneSpaces::WorldSpace) -
-        dis_vis_pmc_->GetBoneLocation(bone_name, EBoneSpaces::WorldSpace)).Size();
+  for (int32 i = 0; i < num_bones; i++) {
+    float distance = (smc->GetBoneTransform(i).GetLocation() -
+        dis_vis_pmc_->GetBoneTransform(i).GetLocation()).Size();
     max_distance = fmaxf(distance, max_distance);
   }
 
@@ -2574,35 +3265,39 @@ bool AHxHandActor::connectToCore() {
   }
 
   if (isLocallyControlled()) {
-    // Find a mocap system that we can use, starting with gloves connected to a Dk2AirController.
-    for (auto dk2_air_controller : hx_core_->getHaptxSystem().getDk2AirControllers()) {
-      std::map<int, std::shared_ptr<HaptxApi::HyleasSystem>> hyleas_systems;
-      if (dk2_air_controller != nullptr && dk2_air_controller->getHyleasSystems(&hyleas_systems) ==
-          HaptxApi::AirController::ReturnCode::SUCCESS) {
-        for (auto hs_it : hyleas_systems) {
-          if (hs_it.second != nullptr &&
-              hs_it.second->getRelativeDirection() == HaptxApi::RelativeDirection(hand_)) {
-            mocap_system_ = hs_it.second;
-            glove_ = hs_it.second->getGlove();
-            break;
+    // Scripted hands never claim hardware.
+    if (!scripted_input_) {
+      // Find a mocap system that we can use, starting with gloves connected to a Dk2AirController.
+      for (auto dk2_air_controller : hx_core_->getHaptxSystem().getDk2AirControllers()) {
+        std::map<int, std::shared_ptr<HaptxApi::HyleasSystem>> hyleas_systems;
+        if (dk2_air_controller != nullptr &&
+            dk2_air_controller->getHyleasSystems(&hyleas_systems) ==
+            HaptxApi::AirController::ReturnCode::SUCCESS) {
+          for (auto hs_it : hyleas_systems) {
+            if (hs_it.second != nullptr &&
+                hs_it.second->getRelativeDirection() == HaptxApi::RelativeDirection(hand_)) {
+              mocap_system_ = hs_it.second;
+              glove_ = hs_it.second->getGlove();
+              break;
+            }
           }
-        }
 
-        if (mocap_system_.lock() != nullptr) {
-          break;
+          if (mocap_system_.lock() != nullptr) {
+            break;
+          }
         }
       }
-    }
 
-    // If we didn't find a glove connected to an Air Controller, look for a glove connected
-    // elsewhere on the system.
-    if (mocap_system_.lock() == nullptr) {
-      for (auto hyleas_system : hx_core_->getHaptxSystem().getHyleasSystems()) {
-        if (hyleas_system != nullptr && hyleas_system->getRelativeDirection() ==
-            HaptxApi::RelativeDirection(hand_)) {
-          mocap_system_ = hyleas_system;
-          glove_ = hyleas_system->getGlove();
-          break;
+      // If we didn't find a glove connected to an Air Controller, look for a glove connected
+      // elsewhere on the system.
+      if (mocap_system_.lock() == nullptr) {
+        for (auto hyleas_system : hx_core_->getHaptxSystem().getHyleasSystems()) {
+          if (hyleas_system != nullptr && hyleas_system->getRelativeDirection() ==
+              HaptxApi::RelativeDirection(hand_)) {
+            mocap_system_ = hyleas_system;
+            glove_ = hyleas_system->getGlove();
+            break;
+          }
         }
       }
     }
@@ -2656,165 +3351,124 @@ void AHxHandActor::registerBones() {
     return;
   }
 
-  // Contact interpreter body registration.
-  // palm
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.palm).ci_body_id =
-      getBodyInstanceId(smc->GetBodyInstance(bone_names_.palm));
-  bone_data_from_bone_name_[bone_names_.palm].rigid_body_part = hand_ == ERelativeDirection::LEFT ?
+  // How each bone is registered with the CI and GD.
+  struct BoneRegistration {
+    // The bone being registered.
+    FName bone;
+    // The bone whose CI body this bone shares (itself if it has its own).
+    FName ci_body_bone;
+    // The rigid body part this bone represents in the CI.
+    HaptxApi::RigidBodyPart rigid_body_part;
+    // The bone whose GD body is this bone's parent, or NAME_None for the whole hand.
+    FName gd_parent_bone;
+    // Whether this bone shares its GD parent's body instead of being its child.
+    bool shares_gd_body;
+    // Whether this bone can engage contact damping.
+    bool can_engage_contact_damping;
+  };
+
+  const HaptxApi::RelativeDirection rel_dir = static_cast<HaptxApi::RelativeDirection>(hand_);
+  const HaptxApi::RigidBodyPart palm_part = hand_ == ERelativeDirection::LEFT ?
       HaptxApi::RigidBodyPart::LEFT_PALM : HaptxApi::RigidBodyPart::RIGHT_PALM;
+  auto medial_part = [rel_dir](HaptxApi::Finger finger) {
+    return HaptxApi::getRigidBodyPart(rel_dir, finger, HaptxApi::FingerBone::FB_MEDIAL);
+  };
+  // Proximal finger segments are treated as the same CI body as the palm, and medial and distal
+  // segments are treated as the same CI body. Thumb1 and the palm are treated as the same GD body
+  // to prevent objects from getting stuck between them. A bone's CI body and GD parent must appear
+  // before it.
+  const BoneRegistration registrations[] = {
+    {bone_names_.palm, bone_names_.palm, palm_part, NAME_None, false, true},
+    {bone_names_.thumb1, bone_names_.palm, palm_part, bone_names_.palm, true, true},
+    {bone_names_.index1, bone_names_.palm, palm_part, NAME_None, false, true},
+    {bone_names_.middle1, bone_names_.palm, palm_part, NAME_None, false, true},
+    {bone_names_.ring1, bone_names_.palm, palm_part, NAME_None, false, true},
+    {bone_names_.pinky1, bone_names_.palm, palm_part, NAME_None, false, true},
+    {bone_names_.thumb2, bone_names_.thumb2, medial_part(HaptxApi::Finger::F_THUMB), NAME_None,
+        false, false},
+    {bone_names_.thumb3, bone_names_.thumb2, medial_part(HaptxApi::Finger::F_THUMB),
+        bone_names_.thumb2, false, false},
+    {bone_names_.index2, bone_names_.index2, medial_part(HaptxApi::Finger::F_INDEX),
+        bone_names_.index1, false, false},
+    {bone_names_.index3, bone_names_.index2, medial_part(HaptxApi::Finger::F_INDEX),
+        bone_names_.index2, false, false},
+    {bone_names_.middle2, bone_names_.middle2, medial_part(HaptxApi::Finger::F_MIDDLE),
+        bone_names_.middle1, false, false},
+    {bone_names_.middle3, bone_names_.middle2, medial_part(HaptxApi::Finger::F_MIDDLE),
+        bone_names_.middle2, false, false},
+    {bone_names_.ring2, bone_names_.ring2, medial_part(HaptxApi::Finger::F_RING),
+        bone_names_.ring1, false, false},
+    {bone_names_.ring3, bone_names_.ring2, medial_part(HaptxApi::Finger::F_RING),
+        bone_names_.ring2, false, false},
+    {bone_names_.pinky2, bone_names_.pinky2, medial_part(HaptxApi::Finger::F_PINKY),
+        bone_names_.pinky1, false, false},
+    {bone_names_.pinky3, bone_names_.pinky2, medial_part(HaptxApi::Finger::F_PINKY),
+        bone_names_.pinky2, false, false}
+  };
+
+  bone_data_from_body_index_.Reset();
+  bone_data_from_body_index_.SetNum(smc->Bodies.Num());
+  contact_damping_body_indices_.Reset();
+  HaptxApi::GraspDetector& gd = hx_core_->getGraspDetector();
+  whole_hand_gd_body_id_ = gd.registerBody();
+  hx_core_->registerGdBody(whole_hand_gd_body_id_, smc, bone_names_.palm, true);
+  for (const BoneRegistration& registration : registrations) {
+    FBodyInstance* body = smc->GetBodyInstance(registration.bone);
+    FHxHandActorBoneData* ci_body_bone_data = getBoneData(registration.ci_body_bone);
+    if (body == nullptr || !bone_data_from_body_index_.IsValidIndex(body->InstanceBodyIndex)) {
+      AHxCoreActor::logError(FString::Printf(
+          TEXT("AHxHandActor::registerBones(): Bone %s has no body."),
+          *registration.bone.ToString()));
+      continue;
+    }
+    FHxHandActorBoneData& bone_data = bone_data_from_body_index_[body->InstanceBodyIndex];
+    bone_data.is_registered = true;
 
-  // Proximal finger segments are treated as the same body as the palm.
-  // thumb1
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.thumb1).ci_body_id =
-      bone_data_from_bone_name_[bone_names_.palm].ci_body_id;
-  bone_data_from_bone_name_[bone_names_.thumb1].rigid_body_part =
-      hand_ == ERelativeDirection::LEFT ?
-      HaptxApi::RigidBodyPart::LEFT_PALM : HaptxApi::RigidBodyPart::RIGHT_PALM;
+    // Contact interpreter body registration.
+    bone_data.ci_body_id = (registration.ci_body_bone == registration.bone ||
+        ci_body_bone_data == nullptr) ? getBodyInstanceId(body) : ci_body_bone_data->ci_body_id;
+    bone_data.rigid_body_part = registration.rigid_body_part;
+    hx_core_->registerBodyWithCi(bone_data.ci_body_id, smc, registration.bone,
+        registration.bone == bone_names_.palm ? palm_body_parameters_ : finger_body_parameters_,
+        bone_data.rigid_body_part);
+    bone_data.has_ci_body_id = true;
 
-  // index1
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.index1).ci_body_id =
-      bone_data_from_bone_name_[bone_names_.palm].ci_body_id;
-  bone_data_from_bone_name_[bone_names_.index1].rigid_body_part =
-      hand_ == ERelativeDirection::LEFT ?
-      HaptxApi::RigidBodyPart::LEFT_PALM : HaptxApi::RigidBodyPart::RIGHT_PALM;
+    // Grasp detector body registration.
+    FHxHandActorBoneData* gd_parent_bone_data = registration.gd_parent_bone.IsNone() ?
+        nullptr : getBoneData(registration.gd_parent_bone);
+    int64_t gd_parent_id = gd_parent_bone_data != nullptr ? gd_parent_bone_data->gd_body_id :
+        whole_hand_gd_body_id_;
+    bone_data.gd_body_id = registration.shares_gd_body ? gd_parent_id :
+        gd.registerBody(gd_parent_id);
+    // Bodies that share a GD body keep it registered under the original bone.
+    if (!registration.shares_gd_body) {
+      hx_core_->registerGdBody(bone_data.gd_body_id, smc, registration.bone);
+    }
+    bone_data.has_gd_body_id = true;
 
-  // middle1
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.middle1).ci_body_id =
-      bone_data_from_bone_name_[bone_names_.palm].ci_body_id;
-  bone_data_from_bone_name_[bone_names_.middle1].rigid_body_part = hand_ ==
-      ERelativeDirection::LEFT ?
-      HaptxApi::RigidBodyPart::LEFT_PALM : HaptxApi::RigidBodyPart::RIGHT_PALM;
+    bone_data.can_engage_contact_damping = registration.can_engage_contact_damping;
+    if (bone_data.can_engage_contact_damping && body->BodySetup.IsValid()) {
+      contact_damping_body_indices_.Add(body->InstanceBodyIndex);
+    }
+  }
+}
 
-  // ring1
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.ring1).ci_body_id =
-      bone_data_from_bone_name_[bone_names_.palm].ci_body_id;
-  bone_data_from_bone_name_[bone_names_.ring1].rigid_body_part = hand_ ==
-      ERelativeDirection::LEFT ?
-      HaptxApi::RigidBodyPart::LEFT_PALM : HaptxApi::RigidBodyPart::RIGHT_PALM;
+FHxHandActorBoneData* AHxHandActor::getBoneData(int32 body_index) {
+  if (!bone_data_from_body_index_.IsValidIndex(body_index)) {
+    return nullptr;
+  }
 
-  // pinky1
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.pinky1).ci_body_id =
-      bone_data_from_bone_name_[bone_names_.palm].ci_body_id;
-  bone_data_from_bone_name_[bone_names_.pinky1].rigid_body_part = hand_ ==
-      ERelativeDirection::LEFT ?
-      HaptxApi::RigidBodyPart::LEFT_PALM : HaptxApi::RigidBodyPart::RIGHT_PALM;
+  FHxHandActorBoneData& bone_data = bone_data_from_body_index_[body_index];
+  return bone_data.is_registered ? &bone_data : nullptr;
+}
 
-  // Medial and distal segments are treated as the same body
-  // thumb2 & thumb3
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.thumb2).ci_body_id =
-      getBodyInstanceId(smc->GetBodyInstance(bone_names_.thumb2));
-  bone_data_from_bone_name_[bone_names_.thumb2].rigid_body_part = HaptxApi::getRigidBodyPart(
-      static_cast<HaptxApi::RelativeDirection>(hand_), HaptxApi::Finger::F_THUMB,
-      HaptxApi::FingerBone::FB_MEDIAL);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.thumb3).ci_body_id =
-      bone_data_from_bone_name_[bone_names_.thumb2].ci_body_id;
-  bone_data_from_bone_name_[bone_names_.thumb3].rigid_body_part =
-      bone_data_from_bone_name_[bone_names_.thumb2].rigid_body_part;
-
-  // index2 & index3
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.index2).ci_body_id =
-      getBodyInstanceId(smc->GetBodyInstance(bone_names_.index2));
-  bone_data_from_bone_name_[bone_names_.index2].rigid_body_part = HaptxApi::getRigidBodyPart(
-      static_cast<HaptxApi::RelativeDirection>(hand_), HaptxApi::Finger::F_INDEX,
-      HaptxApi::FingerBone::FB_MEDIAL);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.index3).ci_body_id =
-      bone_data_from_bone_name_[bone_names_.index2].ci_body_id;
-  bone_data_from_bone_name_[bone_names_.index3].rigid_body_part =
-      bone_data_from_bone_name_[bone_names_.index2].rigid_body_part;
-
-  // middle2 & middle3
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.middle2).ci_body_id =
-      getBodyInstanceId(smc->GetBodyInstance(bone_names_.middle2));
-  bone_data_from_bone_name_[bone_names_.middle2].rigid_body_part = HaptxApi::getRigidBodyPart(
-      static_cast<HaptxApi::RelativeDirection>(hand_), HaptxApi::Finger::F_MIDDLE,
-      HaptxApi::FingerBone::FB_MEDIAL);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.middle3).ci_body_id =
-      bone_data_from_bone_name_[bone_names_.middle2].ci_body_id;
-  bone_data_from_bone_name_[bone_names_.middle3].rigid_body_part =
-      bone_data_from_bone_name_[bone_names_.middle2].rigid_body_part;
-
-  // ring2 & ring3
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.ring2).ci_body_id =
-      getBodyInstanceId(smc->GetBodyInstance(bone_names_.ring2));
-  bone_data_from_bone_name_[bone_names_.ring2].rigid_body_part = HaptxApi::getRigidBodyPart(
-      static_cast<HaptxApi::RelativeDirection>(hand_), HaptxApi::Finger::F_RING,
-      HaptxApi::FingerBone::FB_MEDIAL);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.ring3).ci_body_id =
-      bone_data_from_bone_name_[bone_names_.ring2].ci_body_id;
-  bone_data_from_bone_name_[bone_names_.ring3].rigid_body_part =
-      bone_data_from_bone_name_[bone_names_.ring2].rigid_body_part;
-
-  // pinky2 & pinky3
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.pinky2).ci_body_id =
-      getBodyInstanceId(smc->GetBodyInstance(bone_names_.pinky2));
-  bone_data_from_bone_name_[bone_names_.pinky2].rigid_body_part = HaptxApi::getRigidBodyPart(
-      static_cast<HaptxApi::RelativeDirection>(hand_), HaptxApi::Finger::F_PINKY,
-      HaptxApi::FingerBone::FB_MEDIAL);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.pinky3).ci_body_id =
-      bone_data_from_bone_name_[bone_names_.pinky2].ci_body_id;
-  bone_data_from_bone_name_[bone_names_.pinky3].rigid_body_part =
-      bone_data_from_bone_name_[bone_names_.pinky2].rigid_body_part;
-
-  for (auto& it : bone_data_from_bone_name_) {
-    hx_core_->registerBodyWithCi(it.Value.ci_body_id, smc, it.Key, it.Key ==
-        bone_names_.palm ? palm_body_parameters_ : finger_body_parameters_,
-        it.Value.rigid_body_part);
-    it.Value.has_ci_body_id = true;
-  }
-
-  // Define grasp detector interface body IDs.
-  HaptxApi::GraspDetector& gd = hx_core_->getGraspDetector();
-  whole_hand_gd_body_id_ = gd.registerBody();
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.palm).gd_body_id = gd.registerBody(
-      whole_hand_gd_body_id_);
-  // Thumb1 and the palm are treated as the same body to prevent objects from getting stuck
-  // between them.
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.thumb1).gd_body_id =
-      bone_data_from_bone_name_.FindOrAdd(bone_names_.palm).gd_body_id;
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.thumb2).gd_body_id =
-      gd.registerBody(whole_hand_gd_body_id_);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.thumb3).gd_body_id =
-      gd.registerBody(bone_data_from_bone_name_[bone_names_.thumb2].gd_body_id);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.index1).gd_body_id =
-      gd.registerBody(whole_hand_gd_body_id_);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.index2).gd_body_id =
-      gd.registerBody(bone_data_from_bone_name_[bone_names_.index1].gd_body_id);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.index3).gd_body_id =
-      gd.registerBody(bone_data_from_bone_name_[bone_names_.index2].gd_body_id);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.middle1).gd_body_id =
-      gd.registerBody(whole_hand_gd_body_id_);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.middle2).gd_body_id =
-      gd.registerBody(bone_data_from_bone_name_[bone_names_.middle1].gd_body_id);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.middle3).gd_body_id =
-      gd.registerBody(bone_data_from_bone_name_[bone_names_.middle2].gd_body_id);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.ring1).gd_body_id =
-      gd.registerBody(whole_hand_gd_body_id_);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.ring2).gd_body_id =
-      gd.registerBody(bone_data_from_bone_name_[bone_names_.ring1].gd_body_id);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.ring3).gd_body_id =
-      gd.registerBody(bone_data_from_bone_name_[bone_names_.ring2].gd_body_id);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.pinky1).gd_body_id =
-      gd.registerBody(whole_hand_gd_body_id_);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.pinky2).gd_body_id =
-      gd.registerBody(bone_data_from_bone_name_[bone_names_.pinky1].gd_body_id);
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.pinky3).gd_body_id =
-      gd.registerBody(bone_data_from_bone_name_[bone_names_.pinky2].gd_body_id);
-  hx_core_->registerGdBody(whole_hand_gd_body_id_, smc, bone_names_.palm, true);
-  for (auto &key_value : bone_data_from_bone_name_) {
-    hx_core_->registerGdBody(key_value.Value.gd_body_id, smc, key_value.Key);
-    key_value.Value.has_gd_body_id = true;
-  }
-  // Make sure the palm's bone is registered under its GD body Id, not thumb1's.
-  hx_core_->registerGdBody(bone_data_from_bone_name_[bone_names_.palm].gd_body_id, smc,
-      bone_names_.palm);
-
-  // Denote which bones are capable of engaging the contact damping algorithm.
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.palm).can_engage_contact_damping = true;
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.thumb1).can_engage_contact_damping = true;
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.index1).can_engage_contact_damping = true;
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.middle1).can_engage_contact_damping = true;
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.ring1).can_engage_contact_damping = true;
-  bone_data_from_bone_name_.FindOrAdd(bone_names_.pinky1).can_engage_contact_damping = true;
+FHxHandActorBoneData* AHxHandActor::getBoneData(FName bone_name) {
+  USkeletalMeshComponent* smc = GetSkeletalMeshComponent();
+  if (!IsValid(smc) || smc->GetPhysicsAsset() == nullptr) {
+    return nullptr;
+  }
+
+  return getBoneData(smc->GetPhysicsAsset()->FindBodyIndex(bone_name));
 }
 
 void AHxHandActor::registerRetractuators() {
@@ -0,0 +1,169 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#include <Haptx/Public/hx_oscillator_bank.h>
+#include <Haptx/Private/haptx_shared.h>
+#include <Haptx/Public/hx_benchmark_stats.h>
+
+DECLARE_STATS_GROUP_IF_PROFILING(TEXT("HxOscillatorBank"), STATGROUP_HxOscillatorBank,
+    STATCAT_Advanced)
+DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("advance"), STAT_advanceOscillators,
+    STATGROUP_HxOscillatorBank)
+DECLARE_DWORD_COUNTER_STAT_IF_PROFILING(TEXT("Samples precomputed"),
+    STAT_oscillatorHits, STATGROUP_HxOscillatorBank)
+DECLARE_DWORD_COUNTER_STAT_IF_PROFILING(TEXT("Samples computed on demand"),
+    STAT_oscillatorMisses, STATGROUP_HxOscillatorBank)
+
+//! The play time given to oscillators without a value [s]. No play time matches it.
+constexpr float NO_TIME_S = -1.0f;
+
+//! Samples reuse an oscillator's value when their play times differ by at most this many units in
+//! the last place. Play times are accumulated in single precision by the effect and by the
+//! contact interpreter separately, so they may round differently.
+constexpr float TIME_TOLERANCE_ULPS = 4.0f;
+
+//! Taylor series coefficients of sine, which is accurate to 4e-6 over [-pi/2, pi/2].
+constexpr float SINE_C3 = -1.0f / 6.0f;
+constexpr float SINE_C5 = 1.0f / 120.0f;
+constexpr float SINE_C7 = -1.0f / 5040.0f;
+constexpr float SINE_C9 = 1.0f / 362880.0f;
+
+std::vector<std::weak_ptr<HaptxApi::HapticEffect>> HxOscillatorBank::effects_;
+TArray<float> HxOscillatorBank::frequencies_Hz_;
+TArray<float> HxOscillatorBank::amplitudes_;
+TArray<float> HxOscillatorBank::phase_offsets_deg_;
+TArray<float> HxOscillatorBank::times_s_;
+TArray<float> HxOscillatorBank::folded_angles_rad_;
+TArray<float> HxOscillatorBank::values_;
+TArray<int32> HxOscillatorBank::free_oscillators_;
+
+int32 HxOscillatorBank::addOscillator(std::shared_ptr<HaptxApi::HapticEffect> effect,
+    float frequency_Hz, float amplitude, float phase_offset_deg) {
+  int32 oscillator = INDEX_NONE;
+  if (free_oscillators_.Num() > 0) {
+    oscillator = free_oscillators_.Pop(false);
+    effects_[oscillator] = effect;
+  }
+  else {
+    oscillator = frequencies_Hz_.Num();
+    effects_.push_back(effect);
+    frequencies_Hz_.AddUninitialized();
+    amplitudes_.AddUninitialized();
+    phase_offsets_deg_.AddUninitialized();
+    times_s_.AddUninitialized();
+    folded_angles_rad_.AddUninitialized();
+    values_.AddUninitialized();
+  }
+  frequencies_Hz_[oscillator] = frequency_Hz;
+  amplitudes_[oscillator] = amplitude;
+  phase_offsets_deg_[oscillator] = phase_offset_deg;
+  times_s_[oscillator] = NO_TIME_S;
+  folded_angles_rad_[oscillator] = 0.0f;
+  values_[oscillator] = 0.0f;
+  return oscillator;
+}
+
+void HxOscillatorBank::removeOscillator(int32 oscillator) {
+  if (!frequencies_Hz_.IsValidIndex(oscillator)) {
+    return;
+  }
+  effects_[oscillator].reset();
+  times_s_[oscillator] = NO_TIME_S;
+  free_oscillators_.Push(oscillator);
+}
+
+void HxOscillatorBank::advance(float delta_time_s) {
+  SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_advanceOscillators)
+
+  // Advance play times in a scalar pass, since reading them goes through each effect.
+  const int32 num_oscillators = frequencies_Hz_.Num();
+  for (int32 i = 0; i < num_oscillators; i++) {
+    std::shared_ptr<HaptxApi::HapticEffect> effect = effects_[i].lock();
+    if (effect == nullptr || !effect->isPlaying()) {
+      times_s_[i] = NO_TIME_S;
+      folded_angles_rad_[i] = 0.0f;
+      continue;
+    }
+    times_s_[i] = effect->getPlayTimeS() + delta_time_s;
+    folded_angles_rad_[i] = foldPhase(getPhaseRev(times_s_[i], frequencies_Hz_[i],
+        phase_offsets_deg_[i]));
+  }
+
+  // Then evaluate every oscillator four at a time.
+  const float* angles_rad = folded_angles_rad_.GetData();
+  const float* amplitudes = amplitudes_.GetData();
+  float* values = values_.GetData();
+  int32 i = 0;
+  for (; i + 4 <= num_oscillators; i += 4) {
+    VectorStore(VectorMultiply(VectorLoad(amplitudes + i),
+        approximateSine(VectorLoad(angles_rad + i))), values + i);
+  }
+  for (; i < num_oscillators; i++) {
+    values[i] = amplitudes[i] * approximateSine(angles_rad[i]);
+  }
+}
+
+float HxOscillatorBank::sample(int32 oscillator, float time_s, float frequency_Hz,
+    float amplitude, float phase_offset_deg) {
+  if (!frequencies_Hz_.IsValidIndex(oscillator)) {
+    return amplitude * approximateSine(foldPhase(getPhaseRev(time_s, frequency_Hz,
+        phase_offset_deg)));
+  }
+
+  // Parameters must match exactly, but play times only to within a few units in the last place.
+  const float time_tolerance_s =
+      TIME_TOLERANCE_ULPS * FLT_EPSILON * FMath::Max(1.0f, FMath::Abs(time_s));
+  const bool hit = times_s_[oscillator] >= 0.0f &&
+      FMath::Abs(time_s - times_s_[oscillator]) <= time_tolerance_s &&
+      frequency_Hz == frequencies_Hz_[oscillator] && amplitude == amplitudes_[oscillator] &&
+      phase_offset_deg == phase_offsets_deg_[oscillator];
+  if (HxBenchmarkStats::isEnabled()) {
+    HxBenchmarkStats::addOscillatorSample(hit);
+  }
+  if (hit) {
+    INC_DWORD_STAT_IF_PROFILING(STAT_oscillatorHits)
+  } else {
+    INC_DWORD_STAT_IF_PROFILING(STAT_oscillatorMisses)
+    frequencies_Hz_[oscillator] = frequency_Hz;
+    amplitudes_[oscillator] = amplitude;
+    phase_offsets_deg_[oscillator] = phase_offset_deg;
+    times_s_[oscillator] = time_s;
+    values_[oscillator] = amplitude * approximateSine(foldPhase(getPhaseRev(time_s,
+        frequency_Hz, phase_offset_deg)));
+  }
+  return values_[oscillator];
+}
+
+float HxOscillatorBank::getPhaseRev(float time_s, float frequency_Hz, float phase_offset_deg) {
+  // In single precision the product loses the fractional revolution once it grows large.
+  const double phase_rev = static_cast<double>(time_s) * frequency_Hz +
+      static_cast<double>(phase_offset_deg) * DEG_TO_RAD / REV_TO_RAD;
+  return static_cast<float>(phase_rev - FMath::FloorToDouble(phase_rev + 0.5));
+}
+
+float HxOscillatorBank::foldPhase(float phase_rev) {
+  // sin(2 pi x) is symmetric about x = 0.25 and x = -0.25.
+  const float abs_folded_rev = 0.25f - FMath::Abs(0.25f - FMath::Abs(phase_rev));
+  return FMath::Sign(phase_rev) * abs_folded_rev * REV_TO_RAD;
+}
+
+float HxOscillatorBank::approximateSine(float angle_rad) {
+  const float angle_rad_2 = angle_rad * angle_rad;
+  float sine = SINE_C9;
+  sine = sine * angle_rad_2 + SINE_C7;
+  sine = sine * angle_rad_2 + SINE_C5;
+  sine = sine * angle_rad_2 + SINE_C3;
+  sine = sine * angle_rad_2 + 1.0f;
+  return sine * angle_rad;
+}
+
+VectorRegister HxOscillatorBank::approximateSine(const VectorRegister& angle_rad) {
+  const VectorRegister angle_rad_2 = VectorMultiply(angle_rad, angle_rad);
+  VectorRegister sine = VectorSetFloat1(SINE_C9);
+  sine = VectorMultiplyAdd(sine, angle_rad_2, VectorSetFloat1(SINE_C7));
+  sine = VectorMultiplyAdd(sine, angle_rad_2, VectorSetFloat1(SINE_C5));
+  sine = VectorMultiplyAdd(sine, angle_rad_2, VectorSetFloat1(SINE_C3));
+  sine = VectorMultiplyAdd(sine, angle_rad_2, VectorOne());
+  return VectorMultiply(sine, angle_rad);
+}
@@ -3,11 +3,15 @@
 // The contents of this file are proprietary and confidential.
 
 #include <Haptx/Public/hx_patch_component.h>
+#include <Runtime/Core/Public/Async/ParallelFor.h>
+#include <Runtime/Core/Public/Misc/SecureHash.h>
 #include <Runtime/Engine/Classes/Engine/StaticMeshActor.h>
 #include <Runtime/Engine/Classes/Engine/World.h>
 #include <Runtime/Engine/Classes/GameFramework/Actor.h>
 #include <Runtime/Engine/Classes/Kismet/GameplayStatics.h>
 #include <Runtime/Engine/Classes/Kismet/KismetSystemLibrary.h>
+#include <Haptx/Public/hx_benchmark_stats.h>
+#include <Haptx/Public/hx_collision_uv_sampler.h>
 #include <Haptx/Public/hx_core_actor.h>
 #include <Haptx/Public/hx_patch_socket.h>
 #include <Haptx/Public/hx_physical_material.h>
@@ -20,9 +24,70 @@ DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("HxPatch::updateTraces - parentHit"),
     STAT_updateTraces_parentHit, STATGROUP_HxPatch)
 DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("HxPatch::updateTraces - visualizeTraces"),
     STAT_updateTraces_visualizeTraces, STATGROUP_HxPatch)
+DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("HxPatch::anyObjectsNearTraces"),
+    STAT_anyObjectsNearTraces, STATGROUP_HxPatch)
+DECLARE_DWORD_COUNTER_STAT_IF_PROFILING(TEXT("HxPatch::culled traces"),
+    STAT_culledTraces, STATGROUP_HxPatch)
+DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("HxPatch::resolveCachedTraces"),
+    STAT_resolveCachedTraces, STATGROUP_HxPatch)
+DECLARE_DWORD_COUNTER_STAT_IF_PROFILING(TEXT("HxPatch::cached traces"),
+    STAT_cachedTraces, STATGROUP_HxPatch)
+DECLARE_DWORD_COUNTER_STAT_IF_PROFILING(TEXT("HxPatch::duplicate trace samples"),
+    STAT_duplicateTraceSamples, STATGROUP_HxPatch)
+DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("HxPatch::scheduleTraces"),
+    STAT_scheduleTraces, STATGROUP_HxPatch)
+DECLARE_DWORD_COUNTER_STAT_IF_PROFILING(TEXT("HxPatch::unscheduled traces"),
+    STAT_unscheduledTraces, STATGROUP_HxPatch)
+DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("HxPatch::traceAnalytically"),
+    STAT_traceAnalytically, STATGROUP_HxPatch)
+DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("HxPatch::traceAnalytically - comparison scene queries"),
+    STAT_traceAnalytically_comparison, STATGROUP_HxPatch)
+DECLARE_DWORD_COUNTER_STAT_IF_PROFILING(TEXT("HxPatch::analytic traces"),
+    STAT_analyticTraces, STATGROUP_HxPatch)
+DECLARE_DWORD_COUNTER_STAT_IF_PROFILING(TEXT("HxPatch::analytic trace hit mismatches"),
+    STAT_analyticTraceHitMismatches, STATGROUP_HxPatch)
+DECLARE_DWORD_COUNTER_STAT_IF_PROFILING(TEXT("HxPatch::analytic trace distance mismatches"),
+    STAT_analyticTraceDistanceMismatches, STATGROUP_HxPatch)
+DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("HxPatch::traceInParallel"),
+    STAT_traceInParallel, STATGROUP_HxPatch)
 DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("HxPatch::visualizeTactileFeedbackOutput"),
     STAT_visualizeTactileFeedbackOutput, STATGROUP_HxPatch)
 
+// How far an analytic trace's hit may be from the scene query's, relative to the trace sphere's
+// radius, before it counts as a mismatch.
+static const float ANALYTIC_TRACE_DISTANCE_TOLERANCE = 0.25f;
+
+// Transforms that identify baked trace origins are rounded to these steps before they're hashed,
+// so that rounding noise from where the hand was in the world doesn't change the key.
+static const float TRACE_ORIGINS_KEY_LOCATION_STEP_CM = 0.01f;
+static const float TRACE_ORIGINS_KEY_UNIT_STEP = 1e-4f;
+
+// Formats a transform for a trace origins key, rounded to fixed steps.
+static FString toTraceOriginsKeyString(const FTransform& transform) {
+  const FVector location_cm = transform.GetLocation();
+  FQuat rotation = transform.GetRotation().GetNormalized();
+  // q and -q are the same rotation.
+  if (rotation.W < 0.0f) {
+    rotation = rotation * -1.0f;
+  }
+  const FVector scale = transform.GetScale3D();
+  auto round = [](float value, float step) { return FMath::RoundToInt(value / step); };
+  return FString::Printf(TEXT("%d %d %d %d %d %d %d %d %d %d"),
+      round(location_cm.X, TRACE_ORIGINS_KEY_LOCATION_STEP_CM),
+      round(location_cm.Y, TRACE_ORIGINS_KEY_LOCATION_STEP_CM),
+      round(location_cm.Z, TRACE_ORIGINS_KEY_LOCATION_STEP_CM),
+      round(rotation.X, TRACE_ORIGINS_KEY_UNIT_STEP),
+      round(rotation.Y, TRACE_ORIGINS_KEY_UNIT_STEP),
+      round(rotation.Z, TRACE_ORIGINS_KEY_UNIT_STEP),
+      round(rotation.W, TRACE_ORIGINS_KEY_UNIT_STEP),
+      round(scale.X, TRACE_ORIGINS_KEY_UNIT_STEP), round(scale.Y, TRACE_ORIGINS_KEY_UNIT_STEP),
+      round(scale.Z, TRACE_ORIGINS_KEY_UNIT_STEP));
+}
+
+// The radius of sampling sphere traces in centimeters.
+// TODO: Make this a configurable property.
+static const float SPHERE_TRACE_RADIUS_CM = 0.280625f;
+
 void FHxPatchSecondaryTickFunction::ExecuteTick(
     float DeltaTime,
     ELevelTick TickType,
@@ -125,18 +190,105 @@ void UHxPatchComponent::TickComponentSecondary(
 }
 
 void UHxPatchComponent::ignoreActor(AActor* actor) {
-  if (IsValid(actor)) {
+  if (!IsValid(actor)) {
+    return;
+  }
+
+  if (IsValid(hx_core_) && object_trace_query_params_.IsValid()) {
+    hx_core_->ignoreActorInTactileTraces(GetOwner(), actor);
+  } else {
     object_trace_ignore_actors_.Add(actor);
   }
 }
 
 void UHxPatchComponent::updateTraceOrigins(USkeletalMeshComponent* skeletal_mesh,
-    UStaticMesh* static_mesh) {
+    UStaticMesh* static_mesh, UHxPatchTraceOrigins* baked_trace_origins,
+    bool bake_trace_origins) {
   if (!IsValid(skeletal_mesh) || !IsValid(skeletal_mesh->SkeletalMesh) ||
       static_mesh == nullptr || !IsValid(GetWorld())) {
     return;
   }
 
+  // The transform of the bone this patch is attached to relative to the root bone in the skeletal
+  // mesh's base pose.
+  FTransform l_attach_bone;
+  if (!getRefPoseTransformRelativeToRoot(skeletal_mesh, GetAttachSocketName(), l_attach_bone)) {
+    AHxCoreActor::logError(FString::Printf(TEXT(
+        "UHxPatchComponent::updateTraceOrigins(): Invalid bone \"%s\" on skeletal mesh %s."),
+        *GetAttachSocketName().ToString(), *skeletal_mesh->GetFullName()));
+    return;
+  }
+
+  // Trace origins scale with the skeletal mesh, so relative to this patch they only depend on its
+  // scale relative to its attach bone.
+  const float patch_scale = GetRelativeTransform().GetScale3D().GetMax();
+  trace_origins_key_ = makeTraceOriginsKey(skeletal_mesh, static_mesh, l_attach_bone);
+  if (IsValid(baked_trace_origins)) {
+    TArray<bool> trace_origins_valid;
+    TArray<FTransform> l_trace_origins;
+    if (baked_trace_origins->findTraceOrigins(trace_origins_key_, static_mesh->GetLightingGuid(),
+        patch_scale, static_cast<int32>(tactor_data_.size()), trace_origins_valid,
+        l_trace_origins)) {
+      int32 i = 0;
+      for (auto& tactor_datum : tactor_data_) {
+        tactor_datum.trace_origin_valid = trace_origins_valid[i];
+        tactor_datum.l_trace_origin = l_trace_origins[i];
+        i++;
+      }
+      updateTraceBounds();
+      return;
+    } else if (!bake_trace_origins) {
+      UE_LOG(HaptX, Warning, TEXT(
+          "UHxPatchComponent::updateTraceOrigins(): %s has no baked trace origins near scale %f "
+          "in %s. Computing them live."), *GetName(), patch_scale,
+          *baked_trace_origins->GetPathName())
+    }
+  }
+
+  computeTraceOrigins(skeletal_mesh, static_mesh, l_attach_bone);
+  updateTraceBounds();
+
+  if (bake_trace_origins && GIsEditor && IsValid(baked_trace_origins)) {
+    FHxPatchTraceOriginsEntry entry;
+    entry.key = trace_origins_key_;
+    entry.patch_scale = patch_scale;
+    entry.static_mesh_guid = static_mesh->GetLightingGuid();
+    entry.trace_origins_valid.Reserve(static_cast<int32>(tactor_data_.size()));
+    entry.l_trace_origins.Reserve(static_cast<int32>(tactor_data_.size()));
+    for (const auto& tactor_datum : tactor_data_) {
+      entry.trace_origins_valid.Add(tactor_datum.trace_origin_valid);
+      entry.l_trace_origins.Add(tactor_datum.l_trace_origin);
+    }
+    baked_trace_origins->addEntry(entry);
+    AHxCoreActor::log(FString::Printf(TEXT(
+        "UHxPatchComponent::updateTraceOrigins(): Baked trace origins for %s at scale %f into "
+        "%s. Save it to keep them."), *GetName(), patch_scale,
+        *baked_trace_origins->GetPathName()));
+  }
+}
+
+FString UHxPatchComponent::makeTraceOriginsKey(USkeletalMeshComponent* skeletal_mesh,
+    UStaticMesh* static_mesh, const FTransform& l_attach_bone) const {
+  // Everything computeTraceOrigins() reads except scale and the static mesh's geometry, which
+  // entries track separately through its lighting GUID. Our relative transform is derived from
+  // world transforms by alignWithLocatingSocket(), so it's rounded along with the others.
+  FTransform l_patch = GetRelativeTransform();
+  l_patch.SetScale3D(FVector::OneVector);
+  FString key = FString::Printf(TEXT("%s|%s|%s|%s|%s|%f %f"),
+      *skeletal_mesh->SkeletalMesh->GetPathName(), *static_mesh->GetPathName(),
+      *GetAttachSocketName().ToString(), *toTraceOriginsKeyString(l_attach_bone),
+      *toTraceOriginsKeyString(l_patch), self_trace_increment_cm_, max_self_trace_offset_cm_);
+  for (const auto& tactor_datum : tactor_data_) {
+    key += FString::Printf(TEXT("|%d %s"), tactor_datum.tactor.id,
+        tactor_datum.callbacks == nullptr ? TEXT("null") :
+        *toTraceOriginsKeyString(tactor_datum.callbacks->getUnrealLocalTransform()));
+  }
+
+  return FMD5::HashAnsiString(*key);
+}
+
+void UHxPatchComponent::computeTraceOrigins(USkeletalMeshComponent* skeletal_mesh,
+    UStaticMesh* static_mesh, const FTransform& l_attach_bone) {
   // Generate a static mesh actor representing the skeletal mesh in its base pose.
   AStaticMeshActor* static_mesh_actor = GetWorld()->SpawnActor<AStaticMeshActor>(
       FVector::ZeroVector, FRotator::ZeroRotator, {});
@@ -151,15 +303,6 @@ void UHxPatchComponent::updateTraceOrigins(USkeletalMeshComponent* skeletal_mesh
 
   // The world transform of the root bone of the skeletal mesh.
   const FTransform w_root = static_mesh_actor->GetActorTransform();
-  // The transform of the bone this patch is attached to relative to the root bone in the skeletal
-  // mesh's base pose.
-  FTransform l_attach_bone;
-  if (!getRefPoseTransformRelativeToRoot(skeletal_mesh, GetAttachSocketName(), l_attach_bone)) {
-    AHxCoreActor::logError(FString::Printf(TEXT(
-        "UHxPatchComponent::updateTraceOrigins(): Invalid bone \"%s\" on skeletal mesh %s."),
-        *GetAttachSocketName().ToString(), *skeletal_mesh->GetFullName()));
-    return;
-  }
   // The transform of this patch relative to its attach bone.
   const FTransform l_patch = GetRelativeTransform();
   // The world transform of this patch on the static mesh.
@@ -212,6 +355,28 @@ void UHxPatchComponent::updateTraceOrigins(USkeletalMeshComponent* skeletal_mesh
   static_mesh_actor->Destroy();
 }
 
+void UHxPatchComponent::updateTraceBounds() {
+  // Bound the trace origins for broadphase culling.
+  FBox l_trace_origins_box(ForceInit);
+  num_valid_trace_origins_ = 0;
+  for (const auto& tactor_datum : tactor_data_) {
+    if (tactor_datum.trace_origin_valid) {
+      l_trace_origins_box += tactor_datum.l_trace_origin.GetLocation();
+      num_valid_trace_origins_++;
+    }
+  }
+  trace_bounds_valid_ = num_valid_trace_origins_ > 0;
+  trace_geometry_dirty_ = true;
+  l_trace_bounds_center_cm_ = l_trace_origins_box.GetCenter();
+  l_trace_bounds_radius_cm_ = 0.0f;
+  for (const auto& tactor_datum : tactor_data_) {
+    if (tactor_datum.trace_origin_valid) {
+      l_trace_bounds_radius_cm_ = FMath::Max(l_trace_bounds_radius_cm_,
+          FVector::Dist(l_trace_bounds_center_cm_, tactor_datum.l_trace_origin.GetLocation()));
+    }
+  }
+}
+
 void UHxPatchComponent::hardDisable() {
   AHxCoreActor::logRestartMessage();
   // Hard disable
@@ -274,6 +439,8 @@ void UHxPatchComponent::registerTactors() {
       std::shared_ptr<WeldedComponentCallbacks> callbacks =
           std::make_shared<WeldedComponentCallbacks>(this, NAME_None, unrealFromHx(it->transform));
       tactor_data_.emplace_back(*it, callbacks);
+      tactor_data_.back().trace_priority = hx_core_->getCoverageRegionTracePriority(
+          HAPTX_NAME_TO_FNAME(it->coverage_region).ToString());
 
       hx_core_->getContactInterpreter().registerTactor(peripheral_id_, *it,
           tactor_parameters_.unwrap(), bone_ci_body_id, callbacks);
@@ -282,26 +449,465 @@ void UHxPatchComponent::registerTactors() {
 }
 
 void UHxPatchComponent::configureTraceParameters() {
-  // If we're using the object type whitelist
-  if (hx_core_->allow_tactile_feedback_collision_type_whitelist_) {
-    // Add each type from the whitelist to the query parameters
-    for (auto type : hx_core_->tactile_feedback_collision_types_) {
-      object_trace_collision_type_whitelist_.Add(UEngineTypes::ConvertToObjectType(type));
-    }
+  // The core builds these once and shares them with every patch on our owner.
+  object_trace_object_params_ = &hx_core_->getTactileTraceObjectParams();
+  object_trace_query_params_ = hx_core_->getTactileTraceQueryParams(GetOwner(),
+      object_trace_complex_);
+  if (!object_trace_query_params_.IsValid()) {
+    AHxCoreActor::logError(TEXT(
+        "UHxPatchComponent::configureTraceParameters(): Invalid owner."));
+    hardDisable();
+    return;
   }
-  else {
-    for (EObjectTypeQuery type = ObjectTypeQuery1; type != ObjectTypeQuery_MAX; ++((int&)(type))) {
-      object_trace_collision_type_whitelist_.Add(type);
-    }
+
+  for (AActor* actor : object_trace_ignore_actors_) {
+    hx_core_->ignoreActorInTactileTraces(GetOwner(), actor);
   }
+  object_trace_ignore_actors_.Empty();
 }
 
 void UHxPatchComponent::updateTraces() {
   SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_updateTraces)
-  // The length and width [cm] to draw trace visualization boxes.
-  const float L_TRACE_BOX_LENGTH_WIDTH_CM = 0.25f;
-  // The thickness [cm] to draw trace visualization boxes.
-  const float L_TRACE_BOX_THICKNESS_CM = 0.125f;
+  HX_BENCHMARK_SCOPE(PATCH_TRACES)
+
+  UWorld* world = GetWorld();
+  if (!IsValid(hx_core_) || !IsValid(world)) {
+    return;
+  }
+
+  const float w_radius_cm = SPHERE_TRACE_RADIUS_CM * componentAverage(GetComponentScale());
+  const FCollisionShape sphere = FCollisionShape::MakeSphere(w_radius_cm);
+  const bool objects_nearby = anyObjectsNearTraces();
+  if (!objects_nearby) {
+    INC_DWORD_STAT_BY_IF_PROFILING(STAT_culledTraces, num_valid_trace_origins_ *
+        (l_object_trace_directions_.Num() + t_object_trace_directions_.Num()));
+  }
+
+  if (hx_core_->tactile_trace_mode_ != ETactileTraceMode::ASYNC) {
+    pending_async_traces_.Reset();
+  }
+
+  switch (hx_core_->tactile_trace_mode_) {
+  case ETactileTraceMode::ASYNC: {
+    // The world dispatched last frame's batch at the end of last frame, so its results are ready.
+    FTraceDatum trace_datum;
+    for (const HxPatchComponentTrace& trace : pending_async_traces_) {
+      const FHitResult* hit = nullptr;
+      if (world->QueryTraceData(trace.handle, trace_datum) && trace_datum.OutHits.Num() > 0 &&
+          trace_datum.OutHits[0].bBlockingHit) {
+        hit = &trace_datum.OutHits[0];
+      }
+      processTraceResult(trace, hit, w_radius_cm);
+    }
+
+    if (objects_nearby) {
+      computeTraces(pending_async_traces_);
+      resolveCachedTraces(pending_async_traces_);
+      scheduleTraces(pending_async_traces_);
+      traceAnalytically(pending_async_traces_);
+    } else {
+      pending_async_traces_.Reset();
+    }
+    for (HxPatchComponentTrace& trace : pending_async_traces_) {
+      trace.handle = world->AsyncSweepByObjectType(EAsyncTraceType::Single, trace.w_start_cm,
+          trace.w_end_cm, FQuat::Identity, *object_trace_object_params_, sphere,
+          *object_trace_query_params_);
+    }
+    break;
+  }
+  case ETactileTraceMode::PARALLEL: {
+    if (!objects_nearby) {
+      break;
+    }
+    // The core runs the traces of every patch together just before its update.
+    computeTraces(traces_);
+    resolveCachedTraces(traces_);
+    scheduleTraces(traces_);
+    traceAnalytically(traces_);
+    if (traces_.Num() > 0) {
+      hx_core_->queueParallelTraces(this);
+    }
+    break;
+  }
+  default: {
+    if (!objects_nearby) {
+      break;
+    }
+    computeTraces(traces_);
+    resolveCachedTraces(traces_);
+    scheduleTraces(traces_);
+    traceAnalytically(traces_);
+    FHitResult hit;
+    for (const HxPatchComponentTrace& trace : traces_) {
+      const bool is_hit = world->SweepSingleByObjectType(hit, trace.w_start_cm, trace.w_end_cm,
+          FQuat::Identity, *object_trace_object_params_, sphere, *object_trace_query_params_);
+      processTraceResult(trace, is_hit ? &hit : nullptr, w_radius_cm);
+    }
+    break;
+  }
+  }
+}
+
+void UHxPatchComponent::traceInParallel(
+    const TArray<TWeakObjectPtr<UHxPatchComponent>>& patches) {
+  SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_traceInParallel)
+  HX_BENCHMARK_SCOPE(PATCH_TRACES)
+
+  // One entry per trace of every patch so the queries spread evenly over worker threads.
+  struct ParallelTrace {
+    UHxPatchComponent* patch;
+    int32 trace_i;
+    FCollisionShape sphere;
+  };
+  TArray<ParallelTrace> parallel_traces;
+  UWorld* world = nullptr;
+  for (const TWeakObjectPtr<UHxPatchComponent>& patch_ptr : patches) {
+    UHxPatchComponent* patch = patch_ptr.Get();
+    if (!IsValid(patch) || !patch->is_enabled_ || !IsValid(patch->GetWorld())) {
+      continue;
+    }
+
+    world = patch->GetWorld();
+    patch->trace_hits_.SetNum(patch->traces_.Num(), false);
+    patch->trace_is_hit_.SetNum(patch->traces_.Num(), false);
+    const FCollisionShape sphere = FCollisionShape::MakeSphere(
+        SPHERE_TRACE_RADIUS_CM * componentAverage(patch->GetComponentScale()));
+    for (int32 i = 0; i < patch->traces_.Num(); i++) {
+      parallel_traces.Add({patch, i, sphere});
+    }
+  }
+
+  if (parallel_traces.Num() == 0 || world->GetPhysicsScene() == nullptr) {
+    return;
+  }
+
+  FPhysicsCommand::ExecuteRead(world->GetPhysicsScene(), [&]() {
+    ParallelFor(parallel_traces.Num(), [&](int32 i) {
+      const ParallelTrace& parallel_trace = parallel_traces[i];
+      UHxPatchComponent* patch = parallel_trace.patch;
+      const HxPatchComponentTrace& trace = patch->traces_[parallel_trace.trace_i];
+      patch->trace_is_hit_[parallel_trace.trace_i] = world->SweepSingleByObjectType(
+          patch->trace_hits_[parallel_trace.trace_i], trace.w_start_cm, trace.w_end_cm,
+          FQuat::Identity, *patch->object_trace_object_params_, parallel_trace.sphere,
+          *patch->object_trace_query_params_);
+    });
+  });
+
+  // Object registration and the contact interpreter aren't thread safe.
+  for (const ParallelTrace& parallel_trace : parallel_traces) {
+    UHxPatchComponent* patch = parallel_trace.patch;
+    const int32 i = parallel_trace.trace_i;
+    patch->processTraceResult(patch->traces_[i],
+        patch->trace_is_hit_[i] ? &patch->trace_hits_[i] : nullptr,
+        parallel_trace.sphere.GetSphereRadius());
+  }
+}
+
+void UHxPatchComponent::computeTraces(TArray<HxPatchComponentTrace>& traces) {
+  if (trace_geometry_dirty_ ||
+      num_tactor_trace_directions_ != t_object_trace_directions_.Num()) {
+    rebuildTraceGeometry();
+  }
+
+  const int32 num_l_directions = l_object_trace_directions_.Num();
+  const int32 num_t_directions = num_tactor_trace_directions_;
+  const int32 num_directions = num_l_directions + num_t_directions;
+  const int32 num_tactors = trace_tactors_.Num();
+  traces.SetNum(num_tactors * num_directions, false);
+  if (traces.Num() == 0) {
+    return;
+  }
+
+  // The patch has a uniform scale, so directions only need rotating and trace lengths only need
+  // scaling once.
+  const FMatrix w_patch = GetComponentTransform().ToMatrixWithScale();
+  const FMatrix w_patch_rotation = FQuatRotationMatrix(GetComponentQuat());
+  const float scale = componentAverage(GetComponentScale());
+  const float start_offset_cm = scale * (object_trace_offset_cm_ + SPHERE_TRACE_RADIUS_CM);
+  const float end_offset_cm = scale * object_trace_distance_cm_;
+
+  // Component trace directions are the same for every tactor.
+  TArray<FVector, TInlineAllocator<8>> w_l_directions;
+  w_l_directions.SetNum(num_l_directions);
+  for (int32 d = 0; d < num_l_directions; d++) {
+    w_l_directions[d] =
+        w_patch_rotation.TransformVector(l_object_trace_directions_[d].GetSafeNormal());
+  }
+
+  for (int32 t = 0; t < num_tactors; t++) {
+    const FVector w_origin_cm = w_patch.TransformPosition(l_trace_origins_cm_[t]);
+    const FVector* l_t_directions = l_tactor_trace_directions_.GetData() + t * num_t_directions;
+    HxPatchComponentTrace* tactor_traces = traces.GetData() + t * num_directions;
+    for (int32 d = 0; d < num_directions; d++) {
+      const FVector w_direction = d < num_l_directions ? w_l_directions[d] :
+          w_patch_rotation.TransformVector(l_t_directions[d - num_l_directions]);
+      HxPatchComponentTrace& trace = tactor_traces[d];
+      trace.tactor_datum = trace_tactors_[t];
+      trace.direction_i = d;
+      trace.w_origin_cm = w_origin_cm;
+      trace.w_direction = w_direction;
+      trace.w_start_cm = w_origin_cm - start_offset_cm * w_direction;
+      trace.w_end_cm = w_origin_cm + end_offset_cm * w_direction;
+      trace.handle = FTraceHandle();
+    }
+  }
+}
+
+void UHxPatchComponent::rebuildTraceGeometry() {
+  const int32 num_directions =
+      l_object_trace_directions_.Num() + t_object_trace_directions_.Num();
+  trace_tactors_.Reset();
+  l_trace_origins_cm_.Reset();
+  l_tactor_trace_directions_.Reset();
+  for (auto& tactor_datum : tactor_data_) {
+    if (!tactor_datum.trace_origin_valid) {
+      continue;
+    }
+
+    trace_tactors_.Add(&tactor_datum);
+    l_trace_origins_cm_.Add(tactor_datum.l_trace_origin.GetLocation());
+    for (const FVector& t_direction : t_object_trace_directions_) {
+      l_tactor_trace_directions_.Add(
+          tactor_datum.l_trace_origin.TransformVector(t_direction).GetSafeNormal());
+    }
+    if (tactor_datum.trace_caches.Num() != num_directions) {
+      tactor_datum.trace_caches.Reset();
+      tactor_datum.trace_caches.SetNum(num_directions);
+    }
+  }
+  num_tactor_trace_directions_ = t_object_trace_directions_.Num();
+  trace_geometry_dirty_ = false;
+}
+
+void UHxPatchComponent::resolveCachedTraces(TArray<HxPatchComponentTrace>& traces) {
+  SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_resolveCachedTraces)
+
+  if (!cache_object_traces_) {
+    return;
+  }
+
+  const float w_radius_cm = SPHERE_TRACE_RADIUS_CM * componentAverage(GetComponentScale());
+  int32 num_uncached = 0;
+  for (int32 i = 0; i < traces.Num(); i++) {
+    if (!tryResolveCachedTrace(traces[i], w_radius_cm, true)) {
+      traces[num_uncached++] = traces[i];
+    }
+  }
+
+  INC_DWORD_STAT_BY_IF_PROFILING(STAT_cachedTraces, traces.Num() - num_uncached);
+  traces.SetNum(num_uncached, false);
+}
+
+bool UHxPatchComponent::tryResolveCachedTrace(const HxPatchComponentTrace& trace,
+    float w_radius_cm, bool require_steady) {
+  HxPatchComponentTraceCache* cache =
+      trace.tactor_datum->trace_caches.IsValidIndex(trace.direction_i) ?
+      &trace.tactor_datum->trace_caches[trace.direction_i] : nullptr;
+  if (cache == nullptr || !cache->valid) {
+    return false;
+  }
+
+  UPrimitiveComponent* comp = cache->component.Get();
+  cache->valid = IsValid(comp);
+  // A direction whose asynchronous result was processed this frame has already been sampled, so
+  // neither steady nor unscheduled traces may fall back on it.
+  if (!cache->valid || cache->traced_frame == GFrameCounter || (require_steady &&
+      GFrameCounter - cache->frame >= static_cast<uint64>(trace_cache_max_frames_))) {
+    return false;
+  }
+
+  FTransform w_body = comp->GetSocketTransform(cache->bone);
+  w_body.SetScale3D(FVector::OneVector);
+  const FVector w_body_position_cm = w_body.GetLocation();
+  cache->valid = FVector::DistSquared(w_body_position_cm, cache->w_body_position_cm) <=
+      FMath::Square(trace_cache_teleport_distance_cm_);
+  cache->w_body_position_cm = w_body_position_cm;
+  if (!cache->valid) {
+    return false;
+  }
+
+  if (require_steady && (FVector::DistSquared(w_body.InverseTransformPosition(trace.w_origin_cm),
+      cache->o_origin_cm) > FMath::Square(trace_cache_max_translation_cm_) ||
+      FVector::DotProduct(w_body.InverseTransformVectorNoScale(trace.w_direction),
+      cache->o_direction) <
+      FMath::Cos(FMath::DegreesToRadians(trace_cache_max_rotation_deg_)))) {
+    return false;
+  }
+
+  FHitResult hit;
+  hit.bBlockingHit = true;
+  hit.Component = comp;
+  hit.Actor = comp->GetOwner();
+  hit.BoneName = cache->bone;
+  hit.TraceStart = trace.w_start_cm;
+  hit.TraceEnd = trace.w_end_cm;
+  hit.Location = w_body.TransformPosition(cache->o_location_cm);
+  hit.ImpactPoint = w_body.TransformPosition(cache->o_impact_point_cm);
+  hit.Normal = w_body.TransformVectorNoScale(cache->o_normal);
+  hit.ImpactNormal = w_body.TransformVectorNoScale(cache->o_impact_normal);
+  hit.Distance = cache->distance_cm;
+  hit.FaceIndex = cache->face_index;
+  processTraceResult(trace, &hit, w_radius_cm, true);
+  return true;
+}
+
+void UHxPatchComponent::scheduleTraces(TArray<HxPatchComponentTrace>& traces) {
+  SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_scheduleTraces)
+
+  if (!hx_core_->isTactileTraceBudgetEnabled() || traces.Num() == 0) {
+    return;
+  }
+
+  const float scale = componentAverage(GetComponentScale());
+  const float w_reach_cm = scale * object_trace_distance_cm_;
+  trace_priorities_.SetNum(traces.Num(), false);
+  for (int32 i = 0; i < traces.Num(); i++) {
+    trace_priorities_[i] = getTracePriority(traces[i], w_reach_cm);
+  }
+
+  const int32 num_scheduled = hx_core_->claimTactileTraces(trace_priorities_);
+  if (num_scheduled >= traces.Num()) {
+    return;
+  }
+
+  trace_schedule_.Reset();
+  for (int32 i = 0; i < traces.Num(); i++) {
+    trace_schedule_.Emplace(trace_priorities_[i], i);
+  }
+  trace_schedule_.Sort([](const TPair<float, int32>& a, const TPair<float, int32>& b) {
+    return a.Key > b.Key;
+  });
+
+  // Traces that miss out fall back on their last hit, however stale, rather than losing contact.
+  // Directions already sampled this frame are left alone.
+  const float w_radius_cm = SPHERE_TRACE_RADIUS_CM * scale;
+  scheduled_traces_.Reset();
+  for (int32 i = 0; i < trace_schedule_.Num(); i++) {
+    const HxPatchComponentTrace& trace = traces[trace_schedule_[i].Value];
+    if (i < num_scheduled) {
+      scheduled_traces_.Add(trace);
+    } else {
+      tryResolveCachedTrace(trace, w_radius_cm, false);
+    }
+  }
+
+  INC_DWORD_STAT_BY_IF_PROFILING(STAT_unscheduledTraces, traces.Num() - num_scheduled);
+  Swap(traces, scheduled_traces_);
+}
+
+float UHxPatchComponent::getTracePriority(const HxPatchComponentTrace& trace,
+    float w_reach_cm) const {
+  const HxPatchComponentTactorData& tactor_datum = *trace.tactor_datum;
+  float priority = tactor_datum.trace_priority;
+
+  if (tactor_datum.last_contact_frame > 0u && GFrameCounter - tactor_datum.last_contact_frame <=
+      static_cast<uint64>(hx_core_->recent_contact_frames_)) {
+    priority *= hx_core_->recent_contact_trace_priority_scale_;
+  }
+
+  if (w_nearby_object_bounds_.Num() > 0 && w_reach_cm > 0.0f) {
+    float min_distance_squared_cm2 = MAX_flt;
+    for (const FBox& w_bounds : w_nearby_object_bounds_) {
+      min_distance_squared_cm2 = FMath::Min(min_distance_squared_cm2,
+          w_bounds.ComputeSquaredDistanceToPoint(trace.w_origin_cm));
+    }
+    priority /= 1.0f + FMath::Sqrt(min_distance_squared_cm2) / w_reach_cm;
+  }
+
+  if (tactor_datum.trace_caches.IsValidIndex(trace.direction_i)) {
+    const uint64 traced_frame = tactor_datum.trace_caches[trace.direction_i].traced_frame;
+    if (traced_frame > 0u && GFrameCounter > traced_frame + 1u) {
+      priority *= 1.0f + hx_core_->unscheduled_trace_priority_growth_ *
+          static_cast<float>(GFrameCounter - traced_frame - 1u);
+    }
+  }
+
+  return priority;
+}
+
+bool UHxPatchComponent::anyObjectsNearTraces() {
+  SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_anyObjectsNearTraces)
+
+  w_nearby_object_bounds_.Reset();
+  analytic_traces_ready_ = false;
+  const bool needs_overlaps = IsValid(hx_core_) &&
+      (hx_core_->isTactileTraceBudgetEnabled() || hx_core_->analytic_tactile_traces_);
+  if (!trace_bounds_valid_ || (!cull_object_traces_ && !needs_overlaps)) {
+    return true;
+  }
+
+  // Every trace starts and ends within this distance of its origin [cm].
+  const float l_trace_reach_cm = FMath::Max(object_trace_distance_cm_,
+      object_trace_offset_cm_ + SPHERE_TRACE_RADIUS_CM) + SPHERE_TRACE_RADIUS_CM;
+  const FVector w_center_cm = GetComponentTransform().TransformPosition(l_trace_bounds_center_cm_);
+  const float w_radius_cm = GetComponentScale().GetAbsMax() *
+      (l_trace_bounds_radius_cm_ + l_trace_reach_cm);
+  if (!needs_overlaps) {
+    return GetWorld()->OverlapAnyTestByObjectType(w_center_cm, FQuat::Identity,
+        *object_trace_object_params_, FCollisionShape::MakeSphere(w_radius_cm),
+        *object_trace_query_params_);
+  }
+
+  // Trace scheduling prioritizes tactors by their distance from what's nearby, and analytic traces
+  // only test what's nearby.
+  nearby_overlaps_.Reset();
+  GetWorld()->OverlapMultiByObjectType(nearby_overlaps_, w_center_cm, FQuat::Identity,
+      *object_trace_object_params_, FCollisionShape::MakeSphere(w_radius_cm),
+      *object_trace_query_params_);
+  for (const FOverlapResult& overlap : nearby_overlaps_) {
+    UPrimitiveComponent* comp = overlap.GetComponent();
+    if (IsValid(comp)) {
+      w_nearby_object_bounds_.Add(comp->Bounds.GetBox());
+    }
+  }
+  if (hx_core_->analytic_tactile_traces_) {
+    analytic_trace_sampler_.gather(nearby_overlaps_, object_trace_complex_);
+    analytic_traces_ready_ = true;
+  }
+  return !cull_object_traces_ || nearby_overlaps_.Num() > 0;
+}
+
+void UHxPatchComponent::traceAnalytically(TArray<HxPatchComponentTrace>& traces) {
+  SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_traceAnalytically)
+
+  if (!analytic_traces_ready_ || !hx_core_->analytic_tactile_traces_) {
+    return;
+  }
+
+  const FCollisionShape sphere = FCollisionShape::MakeSphere(
+      SPHERE_TRACE_RADIUS_CM * componentAverage(GetComponentScale()));
+  const bool compare = hx_core_->compare_analytic_tactile_traces_;
+  FHitResult hit;
+  FHitResult scene_hit;
+  for (const HxPatchComponentTrace& trace : traces) {
+    const bool is_hit = analytic_trace_sampler_.sweep(trace.w_start_cm, trace.w_end_cm, sphere,
+        hit);
+
+    if (compare) {
+      bool is_scene_hit = false;
+      {
+        SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_traceAnalytically_comparison)
+        is_scene_hit = GetWorld()->SweepSingleByObjectType(scene_hit, trace.w_start_cm,
+            trace.w_end_cm, FQuat::Identity, *object_trace_object_params_, sphere,
+            *object_trace_query_params_);
+      }
+      if (is_hit != is_scene_hit || (is_hit && hit.Component != scene_hit.Component)) {
+        INC_DWORD_STAT_IF_PROFILING(STAT_analyticTraceHitMismatches)
+      } else if (is_hit && FMath::Abs(hit.Distance - scene_hit.Distance) >
+          ANALYTIC_TRACE_DISTANCE_TOLERANCE * sphere.GetSphereRadius()) {
+        INC_DWORD_STAT_IF_PROFILING(STAT_analyticTraceDistanceMismatches)
+      }
+    }
+
+    processTraceResult(trace, is_hit ? &hit : nullptr, sphere.GetSphereRadius());
+  }
+
+  INC_DWORD_STAT_BY_IF_PROFILING(STAT_analyticTraces, traces.Num());
+  traces.Reset();
+}
+
+void UHxPatchComponent::processTraceResult(const HxPatchComponentTrace& trace,
+    const FHitResult* hit, float w_radius_cm, bool is_cached) {
   // The thickness to draw traces.
   const float L_TRACE_THICKNESS_CM = 0.07f;
   // The color to draw with if we hit an object.
@@ -312,112 +918,101 @@ void UHxPatchComponent::updateTraces() {
   FColor TACTOR_COLOR = DEBUG_WHITE;
   // The radius to draw the sphere at the true tactor location.
   float TACTOR_RADIUS_CM = 0.1f;
-  // The radius of sampling sphere traces in centimeters.
-  // TODO: Make this a configurable property.
-  const float SPHERE_TRACE_RADIUS_CM = 0.280625f;
 
-  if (!IsValid(hx_core_)) {
+  if (trace.tactor_datum == nullptr) {
     return;
   }
 
-  // This array will hold the complete set of ray traces in world space.
-  TArray<FVector> w_trace_directions;
-  w_trace_directions.SetNum(l_object_trace_directions_.Num() + t_object_trace_directions_.Num());
-  // Populate the component trace section of the array.
-  for (int i = 0; i < l_object_trace_directions_.Num(); i++) {
-    w_trace_directions[i] = GetComponentTransform().TransformVector(
-        l_object_trace_directions_[i]).GetSafeNormal();
+  // Each trace direction reports at most one sample per frame.
+  HxPatchComponentTraceCache* cache =
+      trace.tactor_datum->trace_caches.IsValidIndex(trace.direction_i) ?
+      &trace.tactor_datum->trace_caches[trace.direction_i] : nullptr;
+  if (cache != nullptr) {
+    if (cache->sampled_frame == GFrameCounter) {
+      INC_DWORD_STAT_IF_PROFILING(STAT_duplicateTraceSamples);
+      return;
+    }
+    cache->sampled_frame = GFrameCounter;
   }
 
-  for (const auto& tactor_datum : tactor_data_) {
-    const HaptxApi::Tactor& tactor = tactor_datum.tactor;
-
-    if (!tactor_datum.trace_origin_valid) {
-      continue;
+  int64_t object_id;
+  bool object_hit = false;
+  if (hit != nullptr && hx_core_->tryRegisterObjectWithCi(hit->Component.Get(), hit->BoneName,
+      false, object_id)) {
+    SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_updateTraces_objectHit)
+    object_hit = true;
+
+    const float distance = FMath::Max(0.0f, FVector::DotProduct(
+        hit->ImpactPoint - trace.w_origin_cm, trace.w_direction));
+    uv_coordinates_.clear();
+    if (object_trace_uv_channels_.Num() > 0 &&
+        HxCollisionUvSampler::sample(*hit, object_trace_uv_channels_, uvs_)) {
+      for (const FVector2D& uv : uvs_) {
+        uv_coordinates_.push_back(FVECTOR2D_TO_VECTOR2D(uv));
+      }
+    }
+    hx_core_->getContactInterpreter().addSampleResult(
+        peripheral_id_,
+        trace.tactor_datum->tactor.id,
+        hxFromUnrealVector(trace.w_direction),
+        object_id,
+        hxFromUnrealLength(distance),
+        hxFromUnrealLength(hit->Location),
+        hxFromUnrealVector(hit->Normal),
+        uv_coordinates_);
+
+    if (visualize_traces_) {
+      // Draw the point where the object was hit.
+      HxDebugDrawSystem::sphere(
+          GetOwner(),
+          trace.w_start_cm + (hit->Distance * trace.w_direction),
+          w_radius_cm, OBJECT_HIT_COLOR);
     }
+  }
 
-    // Cached trace origin information from self trace.
-    const FTransform w_trace_origin = UKismetMathLibrary::ComposeTransforms(
-        tactor_datum.l_trace_origin, GetComponentTransform());
-    const FVector w_trace_origin_pos_cm = w_trace_origin.GetLocation();
-
-    // Populate the tactor trace section of the array.
-    for (int i = 0; i < t_object_trace_directions_.Num(); i++) {
-      w_trace_directions[l_object_trace_directions_.Num() + i] =
-          w_trace_origin.TransformVector(t_object_trace_directions_[i]).GetSafeNormal();
-    }
-
-    for (const auto& w_trace_direction : w_trace_directions) {
-      // Object trace characterization.
-      const FVector w_object_trace_start_cm = w_trace_origin_pos_cm -
-          GetComponentScale() * w_trace_direction *
-          (object_trace_offset_cm_ + SPHERE_TRACE_RADIUS_CM);
-      const FVector w_object_trace_end_cm = w_trace_origin_pos_cm +
-          object_trace_distance_cm_ * GetComponentScale() * w_trace_direction;
-      const float scaled_sphere_trace_radius_cm = SPHERE_TRACE_RADIUS_CM *
-          componentAverage(GetComponentScale());
-
-      // Perform a sphere trace looking for nearby objects.
-      int64_t object_id;
-      bool object_hit = false;
-      FHitResult object_trace_hit_result;
-      if (UKismetSystemLibrary::SphereTraceSingleForObjects(this, w_object_trace_start_cm,
-          w_object_trace_end_cm, scaled_sphere_trace_radius_cm, object_trace_collision_type_whitelist_,
-          object_trace_complex_, object_trace_ignore_actors_,EDrawDebugTrace::None,
-          object_trace_hit_result, true) &&
-          hx_core_->tryRegisterObjectWithCi(object_trace_hit_result.Component.Get(),
-          object_trace_hit_result.BoneName, false,  object_id)) {
-        SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_updateTraces_objectHit)
-        object_hit = true;
-
-        const float distance = FMath::Max(0.0f, FVector::DotProduct(
-            object_trace_hit_result.ImpactPoint - w_trace_origin_pos_cm, w_trace_direction));
-        std::vector<HaptxApi::Vector2D> uv_coordinates;
-        uv_coordinates.reserve(object_trace_uv_channels_.Num());
-        for (int32 uv_channel : object_trace_uv_channels_) {
-          FVector2D uv = FVector2D::ZeroVector;
-          if (UGameplayStatics::FindCollisionUV(object_trace_hit_result, uv_channel, uv)) {
-            uv_coordinates.push_back(FVECTOR2D_TO_VECTOR2D(uv));
-          }
-        }
-        hx_core_->getContactInterpreter().addSampleResult(
-            peripheral_id_,
-            tactor.id,
-            hxFromUnrealVector(w_trace_direction),
-            object_id,
-            hxFromUnrealLength(distance),
-            hxFromUnrealLength(object_trace_hit_result.Location),
-            hxFromUnrealVector(object_trace_hit_result.Normal),
-            uv_coordinates);
-
-        if (visualize_traces_) {
-          // Draw the point where the object was hit.
-          HxDebugDrawSystem::sphere(
-              GetOwner(),
-              w_object_trace_start_cm + (object_trace_hit_result.Distance * w_trace_direction),
-              scaled_sphere_trace_radius_cm, OBJECT_HIT_COLOR);
-        }
-      }
+  if (object_hit) {
+    trace.tactor_datum->last_contact_frame = GFrameCounter;
+  }
+
+  if (!is_cached && cache != nullptr) {
+    cache->traced_frame = GFrameCounter;
+    cache->valid = object_hit &&
+        (cache_object_traces_ || hx_core_->isTactileTraceBudgetEnabled());
+    if (cache->valid) {
+      UPrimitiveComponent* comp = hit->Component.Get();
+      FTransform w_body = comp->GetSocketTransform(hit->BoneName);
+      w_body.SetScale3D(FVector::OneVector);
+      cache->component = comp;
+      cache->bone = hit->BoneName;
+      cache->frame = GFrameCounter;
+      cache->w_body_position_cm = w_body.GetLocation();
+      cache->o_origin_cm = w_body.InverseTransformPosition(trace.w_origin_cm);
+      cache->o_direction = w_body.InverseTransformVectorNoScale(trace.w_direction);
+      cache->o_location_cm = w_body.InverseTransformPosition(hit->Location);
+      cache->o_impact_point_cm = w_body.InverseTransformPosition(hit->ImpactPoint);
+      cache->o_normal = w_body.InverseTransformVectorNoScale(hit->Normal);
+      cache->o_impact_normal = w_body.InverseTransformVectorNoScale(hit->ImpactNormal);
+      cache->distance_cm = hit->Distance;
+      cache->face_index = hit->FaceIndex;
+    }
+  }
 
-      if (visualize_traces_) {
-        const FColor draw_color = object_hit ? OBJECT_HIT_COLOR : OBJECT_MISS_COLOR;
+  if (visualize_traces_) {
+    const FColor draw_color = object_hit ? OBJECT_HIT_COLOR : OBJECT_MISS_COLOR;
 
-        // Draw a line representing the trace toward objects.
-        HxDebugDrawSystem::line(GetOwner(), w_object_trace_start_cm, w_object_trace_end_cm,
-            draw_color, L_TRACE_THICKNESS_CM);
+    // Draw a line representing the trace toward objects.
+    HxDebugDrawSystem::line(GetOwner(), trace.w_start_cm, trace.w_end_cm, draw_color,
+        L_TRACE_THICKNESS_CM);
 
-        // Draw a sphere representing the trace origin.
-        HxDebugDrawSystem::sphere(GetOwner(), w_trace_origin_pos_cm, scaled_sphere_trace_radius_cm,
-            draw_color);
+    // Draw a sphere representing the trace origin.
+    HxDebugDrawSystem::sphere(GetOwner(), trace.w_origin_cm, w_radius_cm, draw_color);
 
-        if (tactor_datum.callbacks != nullptr) {
-          const FTransform w_tactor = tactor_datum.callbacks->getUnrealWorldTransform();
+    if (trace.tactor_datum->callbacks != nullptr) {
+      const FTransform w_tactor = trace.tactor_datum->callbacks->getUnrealWorldTransform();
 
-          // Draw the true tactor location for completeness.
-          HxDebugDrawSystem::sphere(GetOwner(), w_tactor.GetLocation(), TACTOR_RADIUS_CM,
-              TACTOR_COLOR);
-        }
-      }
+      // Draw the true tactor location for completeness.
+      HxDebugDrawSystem::sphere(GetOwner(), w_tactor.GetLocation(), TACTOR_RADIUS_CM,
+          TACTOR_COLOR);
     }
   }
 }
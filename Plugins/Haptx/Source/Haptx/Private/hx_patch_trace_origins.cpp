@@ -0,0 +1,84 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#include <Haptx/Public/hx_patch_trace_origins.h>
+
+UHxPatchTraceOrigins::UHxPatchTraceOrigins(const FObjectInitializer& ObjectInitializer) :
+    Super(ObjectInitializer), max_scale_error_(0.001f), max_interpolation_scale_span_(0.1f) {}
+
+bool UHxPatchTraceOrigins::findTraceOrigins(const FString& key, const FGuid& static_mesh_guid,
+    float patch_scale, int32 num_tactors, TArray<bool>& trace_origins_valid,
+    TArray<FTransform>& l_trace_origins) const {
+  if (patch_scale <= 0.0f) {
+    return false;
+  }
+
+  const FHxPatchTraceOriginsEntry* nearest_entry = nullptr;
+  float nearest_scale_error = max_scale_error_;
+  // The entries with the nearest scales below and above patch_scale.
+  const FHxPatchTraceOriginsEntry* lower_entry = nullptr;
+  const FHxPatchTraceOriginsEntry* upper_entry = nullptr;
+  for (const FHxPatchTraceOriginsEntry& entry : entries_) {
+    if (entry.key != key || entry.trace_origins_valid.Num() != num_tactors ||
+        entry.l_trace_origins.Num() != num_tactors) {
+      continue;
+    }
+#if WITH_EDITORONLY_DATA
+    // Cooked meshes don't keep their lighting GUID.
+    if (entry.static_mesh_guid != static_mesh_guid) {
+      continue;
+    }
+#endif
+
+    const float scale_error = FMath::Abs(entry.patch_scale - patch_scale) / patch_scale;
+    if (scale_error <= nearest_scale_error) {
+      nearest_entry = &entry;
+      nearest_scale_error = scale_error;
+    }
+    if (entry.patch_scale <= patch_scale &&
+        (lower_entry == nullptr || entry.patch_scale > lower_entry->patch_scale)) {
+      lower_entry = &entry;
+    }
+    if (entry.patch_scale >= patch_scale &&
+        (upper_entry == nullptr || entry.patch_scale < upper_entry->patch_scale)) {
+      upper_entry = &entry;
+    }
+  }
+
+  if (nearest_entry != nullptr) {
+    trace_origins_valid = nearest_entry->trace_origins_valid;
+    l_trace_origins = nearest_entry->l_trace_origins;
+    return true;
+  }
+
+  // Without an entry within max_scale_error_, patch_scale lies strictly between these.
+  if (lower_entry == nullptr || upper_entry == nullptr ||
+      (upper_entry->patch_scale - lower_entry->patch_scale) / patch_scale >
+      max_interpolation_scale_span_) {
+    return false;
+  }
+
+  const float alpha = (patch_scale - lower_entry->patch_scale) /
+      (upper_entry->patch_scale - lower_entry->patch_scale);
+  trace_origins_valid.SetNum(num_tactors);
+  l_trace_origins.SetNum(num_tactors);
+  for (int32 i = 0; i < num_tactors; i++) {
+    trace_origins_valid[i] =
+        lower_entry->trace_origins_valid[i] && upper_entry->trace_origins_valid[i];
+    l_trace_origins[i].Blend(lower_entry->l_trace_origins[i], upper_entry->l_trace_origins[i],
+        alpha);
+  }
+  return true;
+}
+
+void UHxPatchTraceOrigins::addEntry(const FHxPatchTraceOriginsEntry& entry) {
+  entries_.RemoveAll([&entry](const FHxPatchTraceOriginsEntry& existing_entry) {
+    return existing_entry.key == entry.key && existing_entry.patch_scale == entry.patch_scale &&
+        existing_entry.static_mesh_guid == entry.static_mesh_guid;
+  });
+  entries_.Add(entry);
+#if WITH_EDITOR
+  MarkPackageDirty();
+#endif
+}
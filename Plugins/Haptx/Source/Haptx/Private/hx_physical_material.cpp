@@ -11,6 +11,7 @@ UHxPhysicalMaterial::UHxPhysicalMaterial(const FObjectInitializer& ObjectInitial
 	disable_tactile_feedback_(false), override_force_feedback_enabled_(false),
 	force_feedback_enabled_(true), override_base_contact_tolerance_(false),
 	base_contact_tolerance_cm_(0.0f), override_compliance_(false), compliance_cm_cn_(0.0f),
+	sample_uvs_(false),
 	override_grasping_enabled_(false), grasping_enabled_(true), override_grasp_threshold_(false),
 	grasp_threshold_(0.f), override_grasp_drives_(false), override_grasp_linear_limit_(false), override_grasp_cone_limit_(false),
 	override_grasp_twist_limit_(false), override_contact_damping_enabled_(false),
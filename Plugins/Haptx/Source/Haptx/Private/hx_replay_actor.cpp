@@ -0,0 +1,713 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#include <Haptx/Public/hx_replay_actor.h>
+#include <Runtime/Core/Public/Misc/Compression.h>
+#include <Runtime/Core/Public/Misc/FileHelper.h>
+#include <Runtime/Core/Public/Misc/Paths.h>
+#include <Runtime/Core/Public/Serialization/MemoryReader.h>
+#include <Runtime/Core/Public/Serialization/MemoryWriter.h>
+#include <Runtime/Engine/Classes/Components/SphereComponent.h>
+#include <Runtime/Engine/Public/EngineUtils.h>
+#include <Haptx/Private/haptx_shared.h>
+
+DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("recordFrame"), STAT_recordFrame, STATGROUP_AHxReplayActor)
+DECLARE_CYCLE_STAT_IF_PROFILING(TEXT("updatePlayback"), STAT_updatePlayback,
+    STATGROUP_AHxReplayActor)
+
+namespace {
+  //! Identifies a HaptX replay file ("HXRP").
+  constexpr uint32 REPLAY_MAGIC = 0x50525848;
+
+  //! The version of the replay file format. Increment whenever the format changes.
+  constexpr int32 REPLAY_VERSION = 1;
+
+  //! The directory replays are saved in, relative to the project's Saved directory.
+  const TCHAR* REPLAY_DIRECTORY = TEXT("HaptxReplays");
+
+  //! The extension of replay files.
+  const TCHAR* REPLAY_EXTENSION = TEXT(".hxreplay");
+
+  //! The fewest bytes a body pose takes in a replay.
+  constexpr int64 MIN_POSE_SIZE = sizeof(FVector) + sizeof(FQuat);
+
+  //! Checks a count read from an archive against the bytes left in it so that a truncated or
+  //! corrupt replay can't request more memory than it could possibly describe.
+  //!
+  //! @param ar The archive the count was read from.
+  //! @param count The count.
+  //! @param min_element_size The fewest bytes each counted element takes in the archive.
+  //!
+  //! @returns @p count if the archive could hold that many elements, otherwise 0 after marking
+  //! @p ar as errored.
+  int32 validateCount(FArchive& ar, int32 count, int64 min_element_size) {
+    if (ar.IsError() || count < 0 ||
+        static_cast<int64>(count) * min_element_size > ar.TotalSize() - ar.Tell()) {
+      ar.SetError();
+      return 0;
+    }
+    return count;
+  }
+
+  //! Serializes an array as its count followed by each element, validating the count when
+  //! loading.
+  //!
+  //! @param ar The archive to serialize with.
+  //! @param array The array to serialize.
+  //! @param min_element_size The fewest bytes each element takes in the archive.
+  template <typename T>
+  void serializeArray(FArchive& ar, TArray<T>& array, int64 min_element_size) {
+    int32 num = array.Num();
+    ar << num;
+    if (ar.IsLoading()) {
+      array.SetNum(validateCount(ar, num, min_element_size));
+    }
+    for (T& element : array) {
+      ar << element;
+    }
+  }
+
+  //! Serializes a body pose.
+  //!
+  //! @param ar The archive to serialize with.
+  //! @param pose The pose to serialize.
+  void serializePose(FArchive& ar, HxReplayBodyPose& pose) {
+    ar << pose.w_position_cm;
+    ar << pose.w_orient;
+  }
+
+  //! Serializes a frame.
+  //!
+  //! @param ar The archive to serialize with.
+  //! @param frame The frame to serialize.
+  void serializeFrame(FArchive& ar, HxReplayFrame& frame) {
+    ar << frame.time_s;
+
+    int32 num_hands = frame.hands.Num();
+    ar << num_hands;
+    if (ar.IsLoading()) {
+      frame.hands.SetNum(validateCount(ar, num_hands,
+          sizeof(int32) + MIN_POSE_SIZE + 2 * sizeof(int32)));
+    }
+    for (HxReplayHandFrame& hand : frame.hands) {
+      ar << hand.hand_id;
+      ar << hand.targets.w_middle1_pos_cm;
+      ar << hand.targets.w_middle1_orient;
+      serializeArray(ar, hand.targets.l_joint_orients, sizeof(FQuat));
+
+      int32 num_bodies = hand.w_body_poses.Num();
+      ar << num_bodies;
+      if (ar.IsLoading()) {
+        hand.w_body_poses.SetNum(validateCount(ar, num_bodies, MIN_POSE_SIZE));
+      }
+      for (HxReplayBodyPose& pose : hand.w_body_poses) {
+        serializePose(ar, pose);
+      }
+    }
+
+    int32 num_objects = frame.objects.Num();
+    ar << num_objects;
+    if (ar.IsLoading()) {
+      frame.objects.SetNum(validateCount(ar, num_objects, 2 * sizeof(int32) + MIN_POSE_SIZE));
+    }
+    for (HxReplayObjectFrame& object : frame.objects) {
+      ar << object.object_id;
+      ar << object.body_index;
+      serializePose(ar, object.w_pose);
+    }
+  }
+
+  //! Gets the body of an object that a replay refers to.
+  //!
+  //! @param comp The object's component.
+  //! @param body_index The index of the body in the component.
+  //!
+  //! @returns The body, or nullptr if it doesn't exist.
+  FBodyInstance* getReplayBody(UPrimitiveComponent* comp, int32 body_index) {
+    USkeletalMeshComponent* smc = Cast<USkeletalMeshComponent>(comp);
+    if (IsValid(smc)) {
+      return getBodyInstance(smc, smc->GetBoneName(body_index));
+    } else {
+      return getBodyInstance(comp, NAME_None);
+    }
+  }
+}
+
+AHxReplayActor::AHxReplayActor() : replay_name_(TEXT("replay")), record_rate_hz_(30.0f),
+    record_objects_(true), record_grasp_events_(true), playback_rate_(1.0f),
+    loop_playback_(false), on_replay_grasp_(), on_replay_release_(), is_recording_(false),
+    is_playing_back_(false), recording_start_time_s_(0.0f), time_of_last_record_s_(0.0f),
+    num_recorded_frames_(0), recording_payload_(), recorded_grasp_events_(), hx_core_(nullptr),
+    hand_id_from_hand_(), object_id_from_comp_(), hand_infos_(), object_paths_(),
+    playback_frames_(), playback_grasp_events_(), playback_time_s_(0.0f), playback_frame_i_(0),
+    playback_grasp_event_i_(0), playback_hands_(), playback_objects_(),
+    comps_simulating_before_playback_(), smcs_blending_for_playback_() {
+  PrimaryActorTick.bCanEverTick = true;
+}
+
+void AHxReplayActor::Tick(float DeltaTime) {
+  Super::Tick(DeltaTime);
+
+  if (is_recording_) {
+    float time_s = GetWorld()->GetTimeSeconds() - recording_start_time_s_;
+    if (time_s - time_of_last_record_s_ >= 1.0f / FMath::Max(record_rate_hz_, 1.0f)) {
+      time_of_last_record_s_ = time_s;
+      recordFrame();
+    }
+  }
+
+  if (is_playing_back_ && playback_frames_.Num() > 0) {
+    playback_time_s_ += DeltaTime * playback_rate_;
+    float end_time_s = playback_frames_.Last().time_s;
+    if (playback_time_s_ > end_time_s) {
+      if (loop_playback_ && end_time_s > 0.0f) {
+        playback_time_s_ = FMath::Fmod(playback_time_s_, end_time_s);
+        playback_frame_i_ = 0;
+        playback_grasp_event_i_ = 0;
+      } else {
+        playback_time_s_ = end_time_s;
+      }
+    }
+    updatePlayback();
+  }
+}
+
+void AHxReplayActor::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+  if (is_recording_) {
+    stopRecording();
+  }
+  stopPlayback();
+
+  Super::EndPlay(EndPlayReason);
+}
+
+void AHxReplayActor::startRecording() {
+  stopPlayback();
+  if (is_recording_) {
+    return;
+  }
+
+  UWorld* world = GetWorld();
+  if (!IsValid(world)) {
+    return;
+  }
+
+  recording_payload_.Reset();
+  recorded_grasp_events_.Reset();
+  hand_id_from_hand_.Reset();
+  object_id_from_comp_.Reset();
+  hand_infos_.Reset();
+  object_paths_.Reset();
+  num_recorded_frames_ = 0;
+  recording_start_time_s_ = world->GetTimeSeconds();
+  time_of_last_record_s_ = 0.0f;
+
+  if (record_grasp_events_) {
+    hx_core_ = AHxCoreActor::getAndMaintainPseudoSingleton(world);
+    if (IsValid(hx_core_)) {
+      hx_core_->on_grasp_.AddUniqueDynamic(this, &AHxReplayActor::onGrasp);
+      hx_core_->on_release_.AddUniqueDynamic(this, &AHxReplayActor::onRelease);
+    }
+  }
+
+  is_recording_ = true;
+  recordFrame();
+}
+
+bool AHxReplayActor::stopRecording() {
+  if (!is_recording_) {
+    return false;
+  }
+  is_recording_ = false;
+
+  if (IsValid(hx_core_)) {
+    hx_core_->on_grasp_.RemoveDynamic(this, &AHxReplayActor::onGrasp);
+    hx_core_->on_release_.RemoveDynamic(this, &AHxReplayActor::onRelease);
+  }
+  hx_core_ = nullptr;
+
+  // The tables are only complete once recording stops, so they're written ahead of the frames
+  // here rather than as frames are recorded.
+  TArray<uint8> payload;
+  FMemoryWriter payload_writer(payload);
+  int32 num_hands = hand_infos_.Num();
+  payload_writer << num_hands;
+  for (HxReplayHandInfo& hand_info : hand_infos_) {
+    uint8 hand = static_cast<uint8>(hand_info.hand);
+    payload_writer << hand_info.class_path;
+    payload_writer << hand;
+  }
+  payload_writer << object_paths_;
+  int32 num_grasp_events = recorded_grasp_events_.Num();
+  payload_writer << num_grasp_events;
+  for (HxReplayGraspEvent& grasp_event : recorded_grasp_events_) {
+    payload_writer << grasp_event.time_s;
+    payload_writer << grasp_event.object_id;
+    payload_writer << grasp_event.is_grasp;
+  }
+  payload_writer << num_recorded_frames_;
+  payload.Append(recording_payload_);
+  recording_payload_.Empty();
+
+  TArray<uint8> file;
+  FMemoryWriter file_writer(file);
+  uint32 magic = REPLAY_MAGIC;
+  int32 version = REPLAY_VERSION;
+  int32 uncompressed_size = payload.Num();
+  file_writer << magic;
+  file_writer << version;
+  file_writer << uncompressed_size;
+  int32 header_size = file.Num();
+  int32 compressed_size = FCompression::CompressMemoryBound(NAME_Zlib, uncompressed_size);
+  file.AddUninitialized(compressed_size);
+  if (!FCompression::CompressMemory(NAME_Zlib, file.GetData() + header_size, compressed_size,
+      payload.GetData(), uncompressed_size)) {
+    AHxCoreActor::logError(TEXT("AHxReplayActor::stopRecording(): Failed to compress replay."));
+    return false;
+  }
+  file.SetNum(header_size + compressed_size);
+
+  FString path = getReplayFilePath();
+  if (!FFileHelper::SaveArrayToFile(file, *path)) {
+    AHxCoreActor::logError(FString::Printf(
+        TEXT("AHxReplayActor::stopRecording(): Failed to write replay to %s."), *path));
+    return false;
+  }
+
+  AHxCoreActor::log(FString::Printf(TEXT("Saved replay with %d frames to %s."),
+      num_recorded_frames_, *path));
+  return true;
+}
+
+bool AHxReplayActor::isRecording() const {
+  return is_recording_;
+}
+
+bool AHxReplayActor::startPlayback() {
+  if (is_recording_) {
+    stopRecording();
+  }
+  stopPlayback();
+
+  FString path = getReplayFilePath();
+  TArray<uint8> file;
+  if (!FFileHelper::LoadFileToArray(file, *path)) {
+    AHxCoreActor::logError(FString::Printf(
+        TEXT("AHxReplayActor::startPlayback(): Failed to read replay from %s."), *path));
+    return false;
+  }
+
+  FMemoryReader file_reader(file);
+  uint32 magic = 0u;
+  int32 version = 0;
+  int32 uncompressed_size = 0;
+  file_reader << magic;
+  file_reader << version;
+  file_reader << uncompressed_size;
+  // No zlib stream inflates by more than a factor of about 1032.
+  const int64 max_uncompressed_size = 1032 * (file_reader.TotalSize() - file_reader.Tell());
+  if (file_reader.IsError() || magic != REPLAY_MAGIC || version != REPLAY_VERSION ||
+      uncompressed_size < 0 || uncompressed_size > max_uncompressed_size) {
+    AHxCoreActor::logError(FString::Printf(
+        TEXT("AHxReplayActor::startPlayback(): %s isn't a replay of a supported version."),
+        *path));
+    return false;
+  }
+
+  int32 header_size = static_cast<int32>(file_reader.Tell());
+  TArray<uint8> payload;
+  payload.SetNumUninitialized(uncompressed_size);
+  if (!FCompression::UncompressMemory(NAME_Zlib, payload.GetData(), uncompressed_size,
+      file.GetData() + header_size, file.Num() - header_size)) {
+    AHxCoreActor::logError(FString::Printf(
+        TEXT("AHxReplayActor::startPlayback(): Failed to decompress %s."), *path));
+    return false;
+  }
+
+  FMemoryReader payload_reader(payload);
+  int32 num_hands = 0;
+  payload_reader << num_hands;
+  // Each hand is a class path's length and a handedness.
+  hand_infos_.SetNum(validateCount(payload_reader, num_hands, sizeof(int32) + sizeof(uint8)));
+  for (HxReplayHandInfo& hand_info : hand_infos_) {
+    uint8 hand = 0u;
+    payload_reader << hand_info.class_path;
+    payload_reader << hand;
+    hand_info.hand = static_cast<ERelativeDirection>(hand);
+  }
+  serializeArray(payload_reader, object_paths_, sizeof(int32));
+  int32 num_grasp_events = 0;
+  payload_reader << num_grasp_events;
+  // Archives store bools in 32 bits.
+  playback_grasp_events_.SetNum(validateCount(payload_reader, num_grasp_events,
+      sizeof(float) + sizeof(int32) + sizeof(uint32)));
+  for (HxReplayGraspEvent& grasp_event : playback_grasp_events_) {
+    payload_reader << grasp_event.time_s;
+    payload_reader << grasp_event.object_id;
+    payload_reader << grasp_event.is_grasp;
+  }
+  int32 num_frames = 0;
+  payload_reader << num_frames;
+  playback_frames_.SetNum(validateCount(payload_reader, num_frames,
+      sizeof(float) + 2 * sizeof(int32)));
+  for (HxReplayFrame& frame : playback_frames_) {
+    if (payload_reader.IsError()) {
+      break;
+    }
+    serializeFrame(payload_reader, frame);
+  }
+
+  if (payload_reader.IsError() || playback_frames_.Num() == 0) {
+    AHxCoreActor::logError(FString::Printf(
+        TEXT("AHxReplayActor::startPlayback(): %s is empty or corrupt."), *path));
+    hand_infos_.Empty();
+    object_paths_.Empty();
+    playback_frames_.Empty();
+    playback_grasp_events_.Empty();
+    return false;
+  }
+
+  spawnPlaybackHands();
+  resolvePlaybackObjects();
+  playback_time_s_ = 0.0f;
+  playback_frame_i_ = 0;
+  playback_grasp_event_i_ = 0;
+  is_playing_back_ = true;
+  updatePlayback();
+  return true;
+}
+
+void AHxReplayActor::stopPlayback() {
+  if (!is_playing_back_) {
+    return;
+  }
+  is_playing_back_ = false;
+
+  for (AHxHandActor* hand : playback_hands_) {
+    if (IsValid(hand)) {
+      hand->Destroy();
+    }
+  }
+  playback_hands_.Empty();
+
+  for (UPrimitiveComponent* comp : comps_simulating_before_playback_) {
+    if (IsValid(comp)) {
+      comp->SetSimulatePhysics(true);
+    }
+  }
+  comps_simulating_before_playback_.Empty();
+  for (USkeletalMeshComponent* smc : smcs_blending_for_playback_) {
+    if (IsValid(smc)) {
+      smc->bBlendPhysics = false;
+    }
+  }
+  smcs_blending_for_playback_.Empty();
+  playback_objects_.Empty();
+  playback_frames_.Empty();
+  playback_grasp_events_.Empty();
+}
+
+bool AHxReplayActor::isPlayingBack() const {
+  return is_playing_back_;
+}
+
+FString AHxReplayActor::getReplayFilePath() const {
+  return FPaths::Combine(FPaths::ProjectSavedDir(), REPLAY_DIRECTORY,
+      replay_name_ + REPLAY_EXTENSION);
+}
+
+void AHxReplayActor::recordFrame() {
+  SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_recordFrame)
+
+  UWorld* world = GetWorld();
+  if (!IsValid(world)) {
+    return;
+  }
+
+  HxReplayFrame frame;
+  frame.time_s = world->GetTimeSeconds() - recording_start_time_s_;
+
+  // Objects may be in more than one hand's physics authority zone.
+  TSet<TPair<int32, int32>> recorded_object_bodies;
+  TArray<FRigidBodyState> w_body_states;
+  TArray<FObjectPhysicsState> w_object_states;
+  for (TActorIterator<AHxHandActor> it(world); it; ++it) {
+    AHxHandActor* hand = *it;
+    if (!IsValid(hand) || !hand->is_enabled_ || hand->is_replay_puppet_) {
+      continue;
+    }
+
+    USkeletalMeshComponent* smc = hand->GetSkeletalMeshComponent();
+    if (!IsValid(smc)) {
+      continue;
+    }
+
+    hand->getPhysicsStates(w_body_states, w_object_states);
+    int32 hand_frame_i = frame.hands.AddDefaulted();
+    HxReplayHandFrame& hand_frame = frame.hands[hand_frame_i];
+    hand_frame.hand_id = getRecordedHandId(hand);
+    hand_frame.targets = hand->physics_state_.targets;
+    hand_frame.w_body_poses.SetNum(w_body_states.Num());
+    for (int32 i = 0; i < w_body_states.Num(); i++) {
+      hand_frame.w_body_poses[i].w_position_cm = w_body_states[i].Position;
+      hand_frame.w_body_poses[i].w_orient = w_body_states[i].Quaternion;
+    }
+
+    if (!record_objects_) {
+      continue;
+    }
+
+    for (const FObjectPhysicsState& w_object_state : w_object_states) {
+      if (!IsValid(w_object_state.component)) {
+        continue;
+      }
+
+      int32 object_id = getRecordedObjectId(w_object_state.component);
+      TPair<int32, int32> key(object_id, w_object_state.body_index);
+      if (recorded_object_bodies.Contains(key)) {
+        continue;
+      }
+      recorded_object_bodies.Add(key);
+
+      int32 object_frame_i = frame.objects.AddDefaulted();
+      HxReplayObjectFrame& object_frame = frame.objects[object_frame_i];
+      object_frame.object_id = object_id;
+      object_frame.body_index = w_object_state.body_index;
+      object_frame.w_pose.w_position_cm = w_object_state.state.Position;
+      object_frame.w_pose.w_orient = w_object_state.state.Quaternion;
+    }
+  }
+
+  FMemoryWriter payload_writer(recording_payload_, false, true);
+  serializeFrame(payload_writer, frame);
+  num_recorded_frames_++;
+}
+
+void AHxReplayActor::onGrasp(UPrimitiveComponent* component) {
+  recordGraspEvent(component, true);
+}
+
+void AHxReplayActor::onRelease(UPrimitiveComponent* component) {
+  recordGraspEvent(component, false);
+}
+
+void AHxReplayActor::recordGraspEvent(UPrimitiveComponent* component, bool is_grasp) {
+  if (!is_recording_ || !IsValid(component)) {
+    return;
+  }
+
+  HxReplayGraspEvent grasp_event;
+  grasp_event.time_s = GetWorld()->GetTimeSeconds() - recording_start_time_s_;
+  grasp_event.object_id = getRecordedObjectId(component);
+  grasp_event.is_grasp = is_grasp;
+  recorded_grasp_events_.Add(grasp_event);
+}
+
+int32 AHxReplayActor::getRecordedObjectId(UPrimitiveComponent* component) {
+  int32* object_id = object_id_from_comp_.Find(component);
+  if (object_id != nullptr) {
+    return *object_id;
+  }
+
+  int32 new_object_id = object_paths_.Add(component->GetPathName(component->GetWorld()));
+  object_id_from_comp_.Add(component, new_object_id);
+  return new_object_id;
+}
+
+int32 AHxReplayActor::getRecordedHandId(AHxHandActor* hand) {
+  int32* hand_id = hand_id_from_hand_.Find(hand);
+  if (hand_id != nullptr) {
+    return *hand_id;
+  }
+
+  HxReplayHandInfo hand_info;
+  hand_info.class_path = hand->GetClass()->GetPathName();
+  hand_info.hand = hand->hand_;
+  int32 new_hand_id = hand_infos_.Add(hand_info);
+  hand_id_from_hand_.Add(hand, new_hand_id);
+  return new_hand_id;
+}
+
+void AHxReplayActor::spawnPlaybackHands() {
+  UWorld* world = GetWorld();
+  if (!IsValid(world)) {
+    return;
+  }
+
+  playback_hands_.Reset();
+  playback_hands_.SetNumZeroed(hand_infos_.Num());
+  for (int32 i = 0; i < hand_infos_.Num(); i++) {
+    const HxReplayHandInfo& hand_info = hand_infos_[i];
+    UClass* hand_class = LoadClass<AHxHandActor>(nullptr, *hand_info.class_path);
+    if (hand_class == nullptr) {
+      AHxCoreActor::logWarning(FString::Printf(TEXT(
+          "AHxReplayActor::spawnPlaybackHands(): Failed to load hand class %s. "
+          "It won't be played back."), *hand_info.class_path));
+      continue;
+    }
+
+    FTransform w_spawn_transform = GetActorTransform();
+    AHxHandActor* hand = world->SpawnActorDeferred<AHxHandActor>(hand_class, w_spawn_transform,
+        this, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+    if (!IsValid(hand)) {
+      continue;
+    }
+    hand->hand_ = hand_info.hand;
+    hand->scripted_input_ = true;
+    hand->is_replay_puppet_ = true;
+    // Puppets only exist where playback was started, so clients have no use for them.
+    hand->SetReplicates(false);
+    // Playback hands must not claim authority over, or push, anything in the world.
+    if (IsValid(hand->PhysicsAuthorityZone)) {
+      hand->PhysicsAuthorityZone->SetGenerateOverlapEvents(false);
+      hand->PhysicsAuthorityZone->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    }
+    hand->FinishSpawning(w_spawn_transform);
+
+    // Bones only blend in body poses while collision includes physics, so ignore every channel
+    // instead of disabling physics collision.
+    USkeletalMeshComponent* smc = hand->GetSkeletalMeshComponent();
+    if (IsValid(smc)) {
+      smc->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+      smc->SetCollisionResponseToAllChannels(ECR_Ignore);
+    }
+    hand->setPhysicsLodKinematic(true);
+    playback_hands_[i] = hand;
+  }
+}
+
+void AHxReplayActor::resolvePlaybackObjects() {
+  UWorld* world = GetWorld();
+  if (!IsValid(world)) {
+    return;
+  }
+
+  int32 num_missing = 0;
+  playback_objects_.Reset();
+  playback_objects_.SetNumZeroed(object_paths_.Num());
+  for (int32 i = 0; i < object_paths_.Num(); i++) {
+    UPrimitiveComponent* comp = FindObject<UPrimitiveComponent>(world, *object_paths_[i]);
+    if (!IsValid(comp)) {
+      num_missing++;
+      continue;
+    }
+
+    if (comp->IsSimulatingPhysics()) {
+      comp->SetSimulatePhysics(false);
+      comps_simulating_before_playback_.Add(comp);
+    }
+    // Skeletal meshes are posed through their bodies, which their bones only follow while
+    // blending physics.
+    USkeletalMeshComponent* smc = Cast<USkeletalMeshComponent>(comp);
+    if (IsValid(smc) && !smc->bBlendPhysics) {
+      smc->bBlendPhysics = true;
+      smcs_blending_for_playback_.Add(smc);
+    }
+    playback_objects_[i] = comp;
+  }
+
+  if (num_missing > 0) {
+    AHxCoreActor::logWarning(FString::Printf(TEXT(
+        "AHxReplayActor::resolvePlaybackObjects(): %d recorded objects weren't found in this "
+        "world and won't be played back."), num_missing));
+  }
+}
+
+void AHxReplayActor::updatePlayback() {
+  SCOPE_CYCLE_COUNTER_IF_PROFILING(STAT_updatePlayback)
+
+  if (playback_frames_.Num() == 0) {
+    return;
+  }
+
+  while (playback_frame_i_ + 1 < playback_frames_.Num() &&
+      playback_frames_[playback_frame_i_ + 1].time_s <= playback_time_s_) {
+    playback_frame_i_++;
+  }
+  const HxReplayFrame& frame_a = playback_frames_[playback_frame_i_];
+  const HxReplayFrame& frame_b =
+      playback_frames_[FMath::Min(playback_frame_i_ + 1, playback_frames_.Num() - 1)];
+  float alpha = frame_b.time_s > frame_a.time_s ? FMath::Clamp(
+      (playback_time_s_ - frame_a.time_s) / (frame_b.time_s - frame_a.time_s), 0.0f, 1.0f) :
+      0.0f;
+
+  for (const HxReplayHandFrame& hand_a : frame_a.hands) {
+    AHxHandActor* hand = playback_hands_.IsValidIndex(hand_a.hand_id) ?
+        playback_hands_[hand_a.hand_id] : nullptr;
+    if (!IsValid(hand)) {
+      continue;
+    }
+
+    const HxReplayHandFrame* hand_b = frame_b.hands.FindByPredicate(
+        [&](const HxReplayHandFrame& hand_frame) { return hand_frame.hand_id == hand_a.hand_id; });
+    if (hand_b == nullptr || hand_b->w_body_poses.Num() != hand_a.w_body_poses.Num()) {
+      hand_b = &hand_a;
+    }
+
+    // Velocities are left at zero; the hand is kinematic.
+    FHandPhysicsState state;
+    state.targets = FHandPhysicsTargets::interpolate(hand_a.targets, hand_b->targets, alpha);
+    state.w_body_states.SetNum(hand_a.w_body_poses.Num());
+    for (int32 i = 0; i < hand_a.w_body_poses.Num(); i++) {
+      state.w_body_states[i].Position = FMath::Lerp(hand_a.w_body_poses[i].w_position_cm,
+          hand_b->w_body_poses[i].w_position_cm, alpha);
+      state.w_body_states[i].Quaternion = FQuat::Slerp(hand_a.w_body_poses[i].w_orient,
+          hand_b->w_body_poses[i].w_orient, alpha);
+    }
+    hand->updatePhysicsState(state);
+  }
+
+  RigidBodyStateBatch object_batch;
+  object_batch.reset(frame_a.objects.Num());
+  for (const HxReplayObjectFrame& object_a : frame_a.objects) {
+    UPrimitiveComponent* comp = playback_objects_.IsValidIndex(object_a.object_id) ?
+        playback_objects_[object_a.object_id] : nullptr;
+    if (!IsValid(comp)) {
+      continue;
+    }
+
+    const HxReplayObjectFrame* object_b = frame_b.objects.FindByPredicate(
+        [&](const HxReplayObjectFrame& object_frame) {
+          return object_frame.object_id == object_a.object_id &&
+              object_frame.body_index == object_a.body_index;
+        });
+    if (object_b == nullptr) {
+      object_b = &object_a;
+    }
+
+    FRigidBodyState object_state;
+    object_state.Position = FMath::Lerp(object_a.w_pose.w_position_cm,
+        object_b->w_pose.w_position_cm, alpha);
+    object_state.Quaternion = FQuat::Slerp(object_a.w_pose.w_orient, object_b->w_pose.w_orient,
+        alpha);
+
+    // Posing a kinematic body only moves its physics actor, so single body components are moved
+    // as a whole.
+    if (!comp->IsA<USkeletalMeshComponent>()) {
+      comp->SetWorldLocationAndRotation(object_state.Position, object_state.Quaternion, false,
+          nullptr, ETeleportType::TeleportPhysics);
+      continue;
+    }
+
+    FBodyInstance* body = getReplayBody(comp, object_a.body_index);
+    if (body == nullptr || !body->IsValidBodyInstance()) {
+      continue;
+    }
+    object_batch.add(body, object_state);
+  }
+  writeRigidBodyStates(object_batch);
+
+  while (playback_grasp_event_i_ < playback_grasp_events_.Num() &&
+      playback_grasp_events_[playback_grasp_event_i_].time_s <= playback_time_s_) {
+    const HxReplayGraspEvent& grasp_event = playback_grasp_events_[playback_grasp_event_i_];
+    playback_grasp_event_i_++;
+    UPrimitiveComponent* comp = playback_objects_.IsValidIndex(grasp_event.object_id) ?
+        playback_objects_[grasp_event.object_id] : nullptr;
+    if (grasp_event.is_grasp) {
+      on_replay_grasp_.Broadcast(comp);
+    } else {
+      on_replay_release_.Broadcast(comp);
+    }
+  }
+}
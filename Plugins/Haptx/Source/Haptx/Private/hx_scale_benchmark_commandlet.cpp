@@ -0,0 +1,492 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#include <Haptx/Public/hx_scale_benchmark_commandlet.h>
+#include <Runtime/Core/Public/Misc/FileHelper.h>
+#include <Runtime/Core/Public/Misc/Paths.h>
+#include <Runtime/Engine/Classes/Components/StaticMeshComponent.h>
+#include <Runtime/Engine/Classes/Engine/CollisionProfile.h>
+#include <Runtime/Engine/Classes/Engine/Engine.h>
+#include <Runtime/Engine/Classes/Engine/StaticMesh.h>
+#include <Runtime/Engine/Classes/Engine/StaticMeshActor.h>
+#include <Runtime/Engine/Classes/Engine/World.h>
+#include <Runtime/Engine/Classes/GameFramework/Pawn.h>
+#include <Runtime/Engine/Public/EngineUtils.h>
+#include <Runtime/Json/Public/Serialization/JsonSerializer.h>
+#include <Runtime/Json/Public/Serialization/JsonWriter.h>
+#include <Haptx/Public/hx_benchmark_stats.h>
+#include <Haptx/Public/hx_patch_component.h>
+#include <Haptx/Public/hx_wave_object_effect_component.h>
+#include <Haptx/Public/hx_wave_spatial_effect_component.h>
+
+namespace {
+  //! The distance between neighboring hand pairs [cm].
+  constexpr float PAIR_SPACING_CM = 300.0f;
+  //! The distance between the hands in a pair [cm].
+  constexpr float HAND_SPACING_CM = 30.0f;
+  //! The height of the table top [cm].
+  constexpr float TABLE_HEIGHT_CM = 80.0f;
+  //! The closest the hands get to the table top [cm].
+  constexpr float HAND_LOW_HEIGHT_CM = 8.0f;
+  //! The furthest the hands get from the table top [cm].
+  constexpr float HAND_HIGH_HEIGHT_CM = 30.0f;
+  //! How much each hand's spawn yaw differs from the previous hand's, so that hands are created
+  //! at different world poses [deg].
+  constexpr float HAND_SPAWN_YAW_STEP_DEG = 37.0f;
+  //! The duration of one reach, grasp, lift and release [s].
+  constexpr float CYCLE_DURATION_S = 4.0f;
+  //! The size of the graspable objects [cm].
+  constexpr float OBJECT_SIZE_CM = 6.0f;
+  //! The radius of spatial effects' bounding volumes [cm].
+  constexpr float SPATIAL_EFFECT_RADIUS_CM = 5.0f;
+  //! How far spatial effects are scattered beyond the tables [cm].
+  constexpr float SPATIAL_EFFECT_SPREAD_CM = 100.0f;
+  //! The height spatial effects are scattered up to [cm].
+  constexpr float SPATIAL_EFFECT_MAX_HEIGHT_CM = 150.0f;
+  //! Seeds spatial effect placement so every pass is laid out the same way.
+  constexpr int32 SPATIAL_EFFECT_SEED = 2020;
+  //! The frequency of the first wave object effect on each object. Each one after it is this much
+  //! higher so that they don't share samples [Hz].
+  constexpr float WAVE_OBJECT_EFFECT_FREQUENCY_HZ = 10.0f;
+}
+
+UHxScaleBenchmarkCommandlet::UHxScaleBenchmarkCommandlet(
+    const FObjectInitializer& object_initializer) : Super(object_initializer), map_(),
+    hand_class_(nullptr), warmup_frames_(90), frames_(900), frame_rate_hz_(90.0f),
+    index_spatial_effects_(true), w_origin_cm_from_hand_() {
+  IsClient = false;
+  IsEditor = false;
+  IsServer = false;
+  LogToConsole = true;
+}
+
+int32 UHxScaleBenchmarkCommandlet::Main(const FString& Params) {
+  FString hand_pairs_string = TEXT("1,2,4,8,16,32");
+  FString spatial_effects_string = TEXT("0");
+  FString wave_object_effects_string = TEXT("0");
+  FString hand_class_path = TEXT("/haptx/HaptxHand_BP.HaptxHand_BP_C");
+  FString output_path = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Haptx"),
+      TEXT("scale_benchmark.json"));
+  FParse::Value(*Params, TEXT("Map="), map_);
+  FParse::Value(*Params, TEXT("HandPairs="), hand_pairs_string);
+  FParse::Value(*Params, TEXT("HandClass="), hand_class_path);
+  FParse::Value(*Params, TEXT("Output="), output_path);
+  FParse::Value(*Params, TEXT("WarmupFrames="), warmup_frames_);
+  FParse::Value(*Params, TEXT("Frames="), frames_);
+  FParse::Value(*Params, TEXT("FrameRate="), frame_rate_hz_);
+  FParse::Value(*Params, TEXT("SpatialEffects="), spatial_effects_string);
+  FParse::Bool(*Params, TEXT("SpatialEffectIndex="), index_spatial_effects_);
+  FParse::Value(*Params, TEXT("WaveObjectEffects="), wave_object_effects_string);
+  if (frames_ <= 0 || warmup_frames_ < 0 || frame_rate_hz_ <= 0.0f) {
+    UE_LOG(HaptX, Error, TEXT("UHxScaleBenchmarkCommandlet::Main(): Invalid frame settings."))
+    return 1;
+  }
+
+  hand_class_ = LoadClass<AHxHandActor>(nullptr, *hand_class_path);
+  if (hand_class_ == nullptr) {
+    UE_LOG(HaptX, Warning,
+        TEXT("UHxScaleBenchmarkCommandlet::Main(): Failed to load %s. Using AHxHandActor."),
+        *hand_class_path)
+    hand_class_ = AHxHandActor::StaticClass();
+  }
+
+  TArray<int32> spatial_effect_counts;
+  TArray<FString> spatial_effect_strings;
+  spatial_effects_string.ParseIntoArray(spatial_effect_strings, TEXT(","));
+  for (const FString& spatial_effect_string : spatial_effect_strings) {
+    int32 num_spatial_effects = FCString::Atoi(*spatial_effect_string);
+    if (num_spatial_effects < 0) {
+      UE_LOG(HaptX, Warning,
+          TEXT("UHxScaleBenchmarkCommandlet::Main(): Skipping invalid spatial effect count %s."),
+          *spatial_effect_string)
+      continue;
+    }
+    spatial_effect_counts.Add(num_spatial_effects);
+  }
+  if (spatial_effect_counts.Num() == 0) {
+    spatial_effect_counts.Add(0);
+  }
+
+  TArray<int32> wave_object_effect_counts;
+  TArray<FString> wave_object_effect_strings;
+  wave_object_effects_string.ParseIntoArray(wave_object_effect_strings, TEXT(","));
+  for (const FString& wave_object_effect_string : wave_object_effect_strings) {
+    int32 num_wave_object_effects = FCString::Atoi(*wave_object_effect_string);
+    if (num_wave_object_effects < 0) {
+      UE_LOG(HaptX, Warning, TEXT(
+          "UHxScaleBenchmarkCommandlet::Main(): Skipping invalid wave object effect count %s."),
+          *wave_object_effect_string)
+      continue;
+    }
+    wave_object_effect_counts.Add(num_wave_object_effects);
+  }
+  if (wave_object_effect_counts.Num() == 0) {
+    wave_object_effect_counts.Add(0);
+  }
+
+  TArray<FString> hand_pair_strings;
+  hand_pairs_string.ParseIntoArray(hand_pair_strings, TEXT(","));
+  TArray<TSharedPtr<FJsonValue>> passes;
+  for (const FString& hand_pair_string : hand_pair_strings) {
+    int32 num_hand_pairs = FCString::Atoi(*hand_pair_string);
+    if (num_hand_pairs <= 0) {
+      UE_LOG(HaptX, Warning,
+          TEXT("UHxScaleBenchmarkCommandlet::Main(): Skipping invalid hand pair count %s."),
+          *hand_pair_string)
+      continue;
+    }
+
+    for (int32 num_spatial_effects : spatial_effect_counts) {
+      for (int32 num_wave_object_effects : wave_object_effect_counts) {
+        UE_LOG(HaptX, Display, TEXT(
+            "UHxScaleBenchmarkCommandlet::Main(): Running %d hand pair(s) with %d spatial "
+            "effect(s) and %d wave object effect(s) per object."), num_hand_pairs,
+            num_spatial_effects, num_wave_object_effects)
+        TSharedPtr<FJsonObject> pass = runPass(num_hand_pairs, num_spatial_effects,
+            num_wave_object_effects);
+        if (!pass.IsValid()) {
+          return 1;
+        }
+        passes.Add(MakeShared<FJsonValueObject>(pass));
+      }
+    }
+  }
+
+  TSharedPtr<FJsonObject> root = MakeShared<FJsonObject>();
+  root->SetStringField(TEXT("map"), map_);
+  root->SetStringField(TEXT("hand_class"), hand_class_->GetPathName());
+  root->SetStringField(TEXT("cpu"), FPlatformMisc::GetCPUBrand());
+  root->SetNumberField(TEXT("frame_rate_hz"), frame_rate_hz_);
+  root->SetNumberField(TEXT("warmup_frames"), warmup_frames_);
+  root->SetNumberField(TEXT("frames"), frames_);
+  root->SetBoolField(TEXT("spatial_effect_index"), index_spatial_effects_);
+  root->SetArrayField(TEXT("passes"), passes);
+
+  FString json;
+  TSharedRef<TJsonWriter<>> writer = TJsonWriterFactory<>::Create(&json);
+  if (!FJsonSerializer::Serialize(root.ToSharedRef(), writer) ||
+      !FFileHelper::SaveStringToFile(json, *output_path)) {
+    UE_LOG(HaptX, Error, TEXT("UHxScaleBenchmarkCommandlet::Main(): Failed to write %s."),
+        *output_path)
+    return 1;
+  }
+
+  UE_LOG(HaptX, Display, TEXT("UHxScaleBenchmarkCommandlet::Main(): Wrote %s."), *output_path)
+  return 0;
+}
+
+TSharedPtr<FJsonObject> UHxScaleBenchmarkCommandlet::runPass(int32 num_hand_pairs,
+    int32 num_spatial_effects, int32 num_wave_object_effects) {
+  UWorld* world = createWorld();
+  if (world == nullptr) {
+    return nullptr;
+  }
+
+  // Spatial effects pick up the setting when they register with the core.
+  AHxCoreActor* core = AHxCoreActor::getAndMaintainPseudoSingleton(world);
+  if (IsValid(core)) {
+    core->index_spatial_effects_ = index_spatial_effects_;
+  }
+
+  // Lay hand pairs out on a square grid far enough apart that they don't interact.
+  TArray<AHxHandActor*> hands;
+  int32 grid_width = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(num_hand_pairs)));
+  for (int32 i = 0; i < num_hand_pairs; i++) {
+    FVector w_origin_cm = PAIR_SPACING_CM * FVector(i % grid_width, i / grid_width, 0.0f);
+    spawnObjects(world, w_origin_cm, num_wave_object_effects);
+    spawnHandPair(world, w_origin_cm, hands);
+  }
+  const FVector w_grid_max_cm = PAIR_SPACING_CM * FVector(grid_width - 1, grid_width - 1, 0.0f);
+  spawnSpatialEffects(world, num_spatial_effects, FBox(
+      FVector(-SPATIAL_EFFECT_SPREAD_CM, -SPATIAL_EFFECT_SPREAD_CM, 0.0f),
+      w_grid_max_cm + FVector(SPATIAL_EFFECT_SPREAD_CM, SPATIAL_EFFECT_SPREAD_CM,
+      SPATIAL_EFFECT_MAX_HEIGHT_CM)));
+
+  const float delta_time_s = 1.0f / frame_rate_hz_;
+  double world_tick_s = 0.0;
+  double max_world_tick_s = 0.0;
+  HxBenchmarkStats::reset();
+  HxBenchmarkStats::setEnabled(false);
+  for (int32 frame = 0; frame < warmup_frames_ + frames_; frame++) {
+    if (frame == warmup_frames_) {
+      HxBenchmarkStats::reset();
+      HxBenchmarkStats::setEnabled(true);
+    }
+
+    driveHands(hands, frame * delta_time_s);
+    double start_s = FPlatformTime::Seconds();
+    world->Tick(LEVELTICK_All, delta_time_s);
+    double tick_s = FPlatformTime::Seconds() - start_s;
+    GFrameCounter++;
+
+    if (frame >= warmup_frames_) {
+      world_tick_s += tick_s;
+      max_world_tick_s = FMath::Max(max_world_tick_s, tick_s);
+    }
+  }
+  HxBenchmarkStats::setEnabled(false);
+  const bool trace_origins_keys_match = checkTraceOriginsKeys(hands);
+
+  // Hands can disable themselves, for example if they fail to find a peripheral.
+  int32 num_enabled_hands = 0;
+  for (AHxHandActor* hand : hands) {
+    if (IsValid(hand) && hand->is_enabled_) {
+      num_enabled_hands++;
+    }
+  }
+
+  TSharedPtr<FJsonObject> pass = MakeShared<FJsonObject>();
+  pass->SetNumberField(TEXT("hand_pairs"), num_hand_pairs);
+  pass->SetNumberField(TEXT("enabled_hands"), num_enabled_hands);
+  pass->SetNumberField(TEXT("spatial_effects"), num_spatial_effects);
+  pass->SetNumberField(TEXT("wave_object_effects"), num_wave_object_effects);
+  pass->SetBoolField(TEXT("trace_origins_keys_match"), trace_origins_keys_match);
+  pass->SetNumberField(TEXT("world_tick_avg_ms"), 1000.0 * world_tick_s / frames_);
+  pass->SetNumberField(TEXT("world_tick_max_ms"), 1000.0 * max_world_tick_s);
+  for (int i = 0; i < static_cast<int>(HxBenchmarkStat::LAST); i++) {
+    HxBenchmarkStat stat = static_cast<HxBenchmarkStat>(i);
+    pass->SetNumberField(FString::Printf(TEXT("%s_avg_ms"), HxBenchmarkStats::toString(stat)),
+        1000.0 * HxBenchmarkStats::getTime(stat) / frames_);
+  }
+  pass->SetNumberField(TEXT("physics_state_bytes_per_s"),
+      HxBenchmarkStats::getPhysicsStateBytes() * frame_rate_hz_ / frames_);
+  const int64 oscillator_hits = HxBenchmarkStats::getOscillatorHits();
+  const int64 oscillator_misses = HxBenchmarkStats::getOscillatorMisses();
+  pass->SetNumberField(TEXT("oscillator_hits"), oscillator_hits);
+  pass->SetNumberField(TEXT("oscillator_misses"), oscillator_misses);
+  if (oscillator_hits + oscillator_misses > 0) {
+    pass->SetNumberField(TEXT("oscillator_hit_rate"), static_cast<double>(oscillator_hits) /
+        (oscillator_hits + oscillator_misses));
+  }
+  HxBenchmarkStats::reset();
+
+  w_origin_cm_from_hand_.Empty();
+  destroyWorld(world);
+  return pass;
+}
+
+UWorld* UHxScaleBenchmarkCommandlet::createWorld() {
+  UWorld* world = nullptr;
+  if (map_.IsEmpty()) {
+    world = UWorld::CreateWorld(EWorldType::Game, false);
+  } else {
+    UPackage* package = LoadPackage(nullptr, *map_, LOAD_None);
+    world = package != nullptr ? UWorld::FindWorldInPackage(package) : nullptr;
+    if (world == nullptr) {
+      UE_LOG(HaptX, Error, TEXT("UHxScaleBenchmarkCommandlet::createWorld(): Failed to load %s."),
+          *map_)
+      return nullptr;
+    }
+    world->WorldType = EWorldType::Game;
+    world->AddToRoot();
+    if (!world->bIsWorldInitialized) {
+      world->InitWorld();
+    }
+  }
+
+  FWorldContext& world_context = GEngine->CreateNewWorldContext(EWorldType::Game);
+  world_context.SetCurrentWorld(world);
+  FURL url;
+  world->SetGameMode(url);
+  world->InitializeActorsForPlay(url);
+  world->BeginPlay();
+  return world;
+}
+
+void UHxScaleBenchmarkCommandlet::destroyWorld(UWorld* world) {
+  // Destroying actors ends play for them, which among other things releases the core's
+  // pseudo-singleton for the next pass.
+  for (TActorIterator<AActor> it(world); it; ++it) {
+    world->DestroyActor(*it);
+  }
+
+  GEngine->DestroyWorldContext(world);
+  if (world->IsRooted()) {
+    world->RemoveFromRoot();
+  }
+  world->DestroyWorld(false);
+  CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+void UHxScaleBenchmarkCommandlet::spawnObjects(UWorld* world, const FVector& w_origin_cm,
+    int32 num_wave_object_effects) {
+  UStaticMesh* cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+  UStaticMesh* sphere = LoadObject<UStaticMesh>(nullptr,
+      TEXT("/Engine/BasicShapes/Sphere.Sphere"));
+  if (cube == nullptr || sphere == nullptr) {
+    UE_LOG(HaptX, Error,
+        TEXT("UHxScaleBenchmarkCommandlet::spawnObjects(): Failed to load engine shapes."))
+    return;
+  }
+
+  // The engine's basic shapes are 100 cm across.
+  static constexpr float SHAPE_SIZE_CM = 100.0f;
+  auto spawn = [world, num_wave_object_effects](UStaticMesh* mesh, const FVector& w_location_cm,
+      const FVector& size_cm, bool simulate) {
+    AStaticMeshActor* actor = world->SpawnActor<AStaticMeshActor>(w_location_cm,
+        FRotator::ZeroRotator);
+    if (!IsValid(actor)) {
+      return;
+    }
+    UStaticMeshComponent* smc = actor->GetStaticMeshComponent();
+    smc->SetMobility(simulate ? EComponentMobility::Movable : EComponentMobility::Static);
+    smc->SetStaticMesh(mesh);
+    smc->SetWorldScale3D(size_cm / SHAPE_SIZE_CM);
+    smc->SetCollisionProfileName(simulate ? UCollisionProfile::PhysicsActor_ProfileName :
+        UCollisionProfile::BlockAll_ProfileName);
+    smc->SetSimulatePhysics(simulate);
+    if (!simulate) {
+      return;
+    }
+
+    // Registering begins play for the effects, which starts them looping.
+    for (int32 i = 0; i < num_wave_object_effects; i++) {
+      UHxWaveObjectEffectComponent* effect = NewObject<UHxWaveObjectEffectComponent>(actor);
+      effect->frequency_Hz_ = (i + 1) * WAVE_OBJECT_EFFECT_FREQUENCY_HZ;
+      effect->RegisterComponent();
+      if (!effect->addToObject(smc)) {
+        UE_LOG(HaptX, Error, TEXT(
+            "UHxScaleBenchmarkCommandlet::spawnObjects(): Failed to add wave object effect."))
+      }
+    }
+  };
+
+  // A table top under the pair, with one box and one ball under each hand.
+  const FVector table_size_cm(60.0f, 2.0f * HAND_SPACING_CM + 40.0f, 4.0f);
+  spawn(cube, w_origin_cm + FVector(0.0f, 0.0f, TABLE_HEIGHT_CM - 0.5f * table_size_cm.Z),
+      table_size_cm, false);
+  for (float side : {-1.0f, 1.0f}) {
+    FVector w_hand_origin_cm = w_origin_cm + FVector(0.0f, side * HAND_SPACING_CM,
+        TABLE_HEIGHT_CM + 0.5f * OBJECT_SIZE_CM);
+    spawn(cube, w_hand_origin_cm + FVector(-0.75f * OBJECT_SIZE_CM, 0.0f, 0.0f),
+        FVector(OBJECT_SIZE_CM), true);
+    spawn(sphere, w_hand_origin_cm + FVector(0.75f * OBJECT_SIZE_CM, 0.0f, 0.0f),
+        FVector(OBJECT_SIZE_CM), true);
+  }
+}
+
+void UHxScaleBenchmarkCommandlet::spawnHandPair(UWorld* world, const FVector& w_origin_cm,
+    TArray<AHxHandActor*>& hands) {
+  APawn* pawn = world->SpawnActor<APawn>(APawn::StaticClass(), FTransform(w_origin_cm));
+  AHxBenchmarkController* controller = world->SpawnActor<AHxBenchmarkController>();
+  if (!IsValid(pawn) || !IsValid(controller)) {
+    UE_LOG(HaptX, Error,
+        TEXT("UHxScaleBenchmarkCommandlet::spawnHandPair(): Failed to spawn pawn."))
+    return;
+  }
+  controller->Possess(pawn);
+
+  for (ERelativeDirection side : {ERelativeDirection::LEFT, ERelativeDirection::RIGHT}) {
+    FVector w_hand_origin_cm = w_origin_cm + FVector(0.0f,
+        (side == ERelativeDirection::LEFT ? -1.0f : 1.0f) * HAND_SPACING_CM, 0.0f);
+    // Scripted input sets the pose on the first tick. Until then each hand has a different world
+    // pose, which checkTraceOriginsKeys() relies on.
+    FTransform w_spawn(FRotator(0.0f, HAND_SPAWN_YAW_STEP_DEG * hands.Num(), 0.0f),
+        w_hand_origin_cm + FVector(0.0f, 0.0f, TABLE_HEIGHT_CM + HAND_HIGH_HEIGHT_CM));
+    AHxHandActor* hand = world->SpawnActorDeferred<AHxHandActor>(hand_class_, w_spawn, pawn,
+        pawn, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+    if (!IsValid(hand)) {
+      UE_LOG(HaptX, Error,
+          TEXT("UHxScaleBenchmarkCommandlet::spawnHandPair(): Failed to spawn hand."))
+      continue;
+    }
+    hand->hand_ = side;
+    hand->scripted_input_ = true;
+    hand->FinishSpawning(w_spawn);
+    w_origin_cm_from_hand_.Add(hand, w_hand_origin_cm);
+    hands.Add(hand);
+  }
+}
+
+void UHxScaleBenchmarkCommandlet::spawnSpatialEffects(UWorld* world, int32 num_spatial_effects,
+    const FBox& w_region_cm) {
+  FRandomStream random(SPATIAL_EFFECT_SEED);
+  for (int32 i = 0; i < num_spatial_effects; i++) {
+    AActor* actor = world->SpawnActor<AActor>();
+    if (!IsValid(actor)) {
+      UE_LOG(HaptX, Error,
+          TEXT("UHxScaleBenchmarkCommandlet::spawnSpatialEffects(): Failed to spawn actor."))
+      return;
+    }
+
+    UHxWaveSpatialEffectComponent* effect = NewObject<UHxWaveSpatialEffectComponent>(actor);
+    effect->setBoundingVolume(UHxSphereBoundingVolume::newSphereBoundingVolume(effect,
+        SPATIAL_EFFECT_RADIUS_CM));
+    actor->SetRootComponent(effect);
+    effect->SetWorldLocation(FVector(random.FRandRange(w_region_cm.Min.X, w_region_cm.Max.X),
+        random.FRandRange(w_region_cm.Min.Y, w_region_cm.Max.Y),
+        random.FRandRange(w_region_cm.Min.Z, w_region_cm.Max.Z)));
+    effect->RegisterComponent();
+  }
+}
+
+bool UHxScaleBenchmarkCommandlet::checkTraceOriginsKeys(const TArray<AHxHandActor*>& hands) {
+  // Hands on the same side share a configuration, so each of their patches should have found the
+  // same key in UHxPatchTraceOrigins wherever the hand spawned.
+  bool keys_match = true;
+  TMap<FString, FString> key_from_patch;
+  for (AHxHandActor* hand : hands) {
+    if (!IsValid(hand)) {
+      continue;
+    }
+
+    TArray<UHxPatchComponent*> patches;
+    hand->GetComponents<UHxPatchComponent>(patches);
+    for (UHxPatchComponent* patch : patches) {
+      const FString& key = patch->getTraceOriginsKey();
+      if (key.IsEmpty()) {
+        continue;
+      }
+
+      const FString patch_id = FString::Printf(TEXT("%s %s"),
+          hand->getHand() == ERelativeDirection::LEFT ? TEXT("left") : TEXT("right"),
+          *patch->GetName());
+      const FString* first_key = key_from_patch.Find(patch_id);
+      if (first_key == nullptr) {
+        key_from_patch.Add(patch_id, key);
+      } else if (*first_key != key) {
+        keys_match = false;
+        UE_LOG(HaptX, Error, TEXT(
+            "UHxScaleBenchmarkCommandlet::checkTraceOriginsKeys(): The %s patch's trace origins "
+            "key depends on where its hand spawned."), *patch_id)
+      }
+    }
+  }
+  return keys_match;
+}
+
+void UHxScaleBenchmarkCommandlet::driveHands(const TArray<AHxHandActor*>& hands,
+    float time_s) {
+  // Reach down, close, lift, then open, switching gestures every cycle.
+  int32 cycle = FMath::FloorToInt(time_s / CYCLE_DURATION_S);
+  float phase = FMath::Fmod(time_s, CYCLE_DURATION_S) / CYCLE_DURATION_S * 4.0f;
+  float height_cm = HAND_HIGH_HEIGHT_CM;
+  float trigger_value = 0.0f;
+  if (phase < 1.0f) {
+    height_cm = FMath::Lerp(HAND_HIGH_HEIGHT_CM, HAND_LOW_HEIGHT_CM, phase);
+  } else if (phase < 2.0f) {
+    height_cm = HAND_LOW_HEIGHT_CM;
+    trigger_value = phase - 1.0f;
+  } else if (phase < 3.0f) {
+    height_cm = FMath::Lerp(HAND_LOW_HEIGHT_CM, HAND_HIGH_HEIGHT_CM, phase - 2.0f);
+    trigger_value = 1.0f;
+  } else {
+    trigger_value = 4.0f - phase;
+  }
+  HaptxApi::Gesture gesture =
+      static_cast<HaptxApi::Gesture>(cycle % static_cast<int>(HaptxApi::Gesture::LAST));
+
+  for (AHxHandActor* hand : hands) {
+    const FVector* w_hand_origin_cm = w_origin_cm_from_hand_.Find(hand);
+    if (!IsValid(hand) || w_hand_origin_cm == nullptr) {
+      continue;
+    }
+
+    // Palms face the table.
+    FQuat w_orient = FRotator(0.0f, 0.0f,
+        hand->getHand() == ERelativeDirection::LEFT ? 90.0f : -90.0f).Quaternion();
+    hand->setScriptedInput(FTransform(w_orient, *w_hand_origin_cm +
+        FVector(0.0f, 0.0f, TABLE_HEIGHT_CM + height_cm)), gesture, trigger_value);
+  }
+}
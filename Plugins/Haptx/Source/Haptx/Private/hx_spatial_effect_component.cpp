@@ -19,6 +19,10 @@ void UHxSpatialEffectComponent::setBoundingVolume(UHxBoundingVolume* bounding_vo
   }
 }
 
+std::shared_ptr<HaptxApi::SpatialEffect> UHxSpatialEffectComponent::getSpatialEffect() const {
+  return spatial_effect_;
+}
+
 void UHxSpatialEffectComponent::BeginPlay() {
   spatial_effect_ = std::make_shared<HxUnrealSpatialEffect>(this);
   callbacks_ = std::make_shared<WeldedComponentCallbacks>(this, NAME_None);
@@ -29,7 +33,7 @@ void UHxSpatialEffectComponent::BeginPlay() {
 
   AHxCoreActor* core = AHxCoreActor::getAndMaintainPseudoSingleton(GetWorld());
   if (IsValid(core)) {
-    core->getContactInterpreter().registerSpatialEffect(spatial_effect_);
+    core->registerSpatialEffect(this);
   } else {
     UE_LOG(HaptX, Error, TEXT(
         "UHxSpatialEffectComponent::BeginPlay(): Failed to get handle to core."))
@@ -44,7 +48,7 @@ void UHxSpatialEffectComponent::EndPlay(EEndPlayReason::Type EndPlayReason) {
   AHxCoreActor* core = AHxCoreActor::getAndMaintainPseudoSingleton(GetWorld());
   if (IsValid(core)) {
     if (spatial_effect_ != nullptr) {
-      core->getContactInterpreter().unregisterSpatialEffect(spatial_effect_->getId());
+      core->unregisterSpatialEffect(this);
     } else {
       UE_LOG(HaptX, Error, TEXT(
           "UHxSpatialEffectComponent::EndPlay(): Null internal effect."))
@@ -0,0 +1,224 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#include <Haptx/Public/hx_spatial_effect_index.h>
+#include <Haptx/Public/hx_bounding_volumes.h>
+#include <Haptx/Public/hx_spatial_effect_component.h>
+
+//! Effects whose bounds cover more cells than this are kept out of the grid.
+constexpr int64 MAX_CELLS_PER_EFFECT = 64;
+
+//! Queries covering more cells than this test every effect instead of visiting cells.
+constexpr int64 MAX_CELLS_PER_QUERY = 512;
+
+HxSpatialEffectIndex::HxSpatialEffectIndex() : cell_size_cm_(50.0f), entry_from_effect_(),
+    effects_(), effects_from_cell_(), oversized_effects_() {}
+
+void HxSpatialEffectIndex::setCellSizeCm(float cell_size_cm) {
+  cell_size_cm = FMath::Max(cell_size_cm, KINDA_SMALL_NUMBER);
+  if (cell_size_cm == cell_size_cm_) {
+    return;
+  }
+
+  cell_size_cm_ = cell_size_cm;
+  effects_from_cell_.Reset();
+  oversized_effects_.Reset();
+  for (auto& it : entry_from_effect_) {
+    bin(it.Value);
+    insert(it.Key, it.Value);
+  }
+}
+
+void HxSpatialEffectIndex::addEffect(UHxSpatialEffectComponent* effect) {
+  if (!IsValid(effect) || entry_from_effect_.Contains(effect)) {
+    return;
+  }
+
+  Entry& entry = entry_from_effect_.Add(effect);
+  entry.effect = effect;
+  getWorldBounds(effect, entry.w_bounds_cm);
+  bin(entry);
+  insert(effect, entry);
+  effects_.Add(effect);
+}
+
+void HxSpatialEffectIndex::removeEffect(UHxSpatialEffectComponent* effect) {
+  const Entry* entry = entry_from_effect_.Find(effect);
+  if (entry == nullptr) {
+    return;
+  }
+
+  erase(effect, *entry);
+  entry_from_effect_.Remove(effect);
+  effects_.RemoveSingleSwap(effect);
+}
+
+bool HxSpatialEffectIndex::containsEffect(UHxSpatialEffectComponent* effect) const {
+  return entry_from_effect_.Contains(effect);
+}
+
+const TArray<UHxSpatialEffectComponent*>& HxSpatialEffectIndex::getEffects() const {
+  return effects_;
+}
+
+void HxSpatialEffectIndex::update() {
+  for (auto it = entry_from_effect_.CreateIterator(); it; ++it) {
+    UHxSpatialEffectComponent* effect = it.Key();
+    Entry& entry = it.Value();
+    if (!entry.effect.IsValid()) {
+      erase(effect, entry);
+      effects_.RemoveSingleSwap(effect);
+      it.RemoveCurrent();
+      continue;
+    }
+
+    Entry updated_entry = entry;
+    updated_entry.w_bounds_cm = FBox(ForceInit);
+    getWorldBounds(effect, updated_entry.w_bounds_cm);
+    bin(updated_entry);
+
+    // Most effects stay within the same cells from frame to frame.
+    if (updated_entry.is_oversized != entry.is_oversized ||
+        updated_entry.min_cell != entry.min_cell || updated_entry.max_cell != entry.max_cell) {
+      erase(effect, entry);
+      insert(effect, updated_entry);
+    }
+    entry = updated_entry;
+  }
+}
+
+void HxSpatialEffectIndex::findEffects(const FBox& w_box_cm,
+    TSet<UHxSpatialEffectComponent*>& effects) const {
+  if (!w_box_cm.IsValid) {
+    return;
+  }
+
+  auto overlaps = [this, &w_box_cm](UHxSpatialEffectComponent* effect) {
+    const Entry* entry = entry_from_effect_.Find(effect);
+    return entry != nullptr && (!entry->w_bounds_cm.IsValid ||
+        entry->w_bounds_cm.Intersect(w_box_cm));
+  };
+
+  for (UHxSpatialEffectComponent* effect : oversized_effects_) {
+    if (overlaps(effect)) {
+      effects.Add(effect);
+    }
+  }
+
+  const FIntVector min_cell = getCell(w_box_cm.Min);
+  const FIntVector max_cell = getCell(w_box_cm.Max);
+  if (countCells(min_cell, max_cell) > MAX_CELLS_PER_QUERY) {
+    for (UHxSpatialEffectComponent* effect : effects_) {
+      if (overlaps(effect)) {
+        effects.Add(effect);
+      }
+    }
+    return;
+  }
+
+  for (int32 x = min_cell.X; x <= max_cell.X; x++) {
+    for (int32 y = min_cell.Y; y <= max_cell.Y; y++) {
+      for (int32 z = min_cell.Z; z <= max_cell.Z; z++) {
+        const TArray<UHxSpatialEffectComponent*>* cell_effects =
+            effects_from_cell_.Find(FIntVector(x, y, z));
+        if (cell_effects == nullptr) {
+          continue;
+        }
+        for (UHxSpatialEffectComponent* effect : *cell_effects) {
+          if (!effects.Contains(effect) && overlaps(effect)) {
+            effects.Add(effect);
+          }
+        }
+      }
+    }
+  }
+}
+
+bool HxSpatialEffectIndex::getWorldBounds(const UHxSpatialEffectComponent* effect,
+    FBox& w_bounds_cm) {
+  if (!IsValid(effect)) {
+    return false;
+  }
+
+  // Custom bounding volume types can't be bounded here, so they're treated as unbounded.
+  FBox l_bounds_cm(ForceInit);
+  UHxBoundingVolume* bounding_volume = effect->getBoundingVolume();
+  if (const UHxSphereBoundingVolume* sphere = Cast<UHxSphereBoundingVolume>(bounding_volume)) {
+    l_bounds_cm = FBox::BuildAABB(sphere->getCenterPositionCm(),
+        FVector(sphere->getRadiusCm()));
+  } else if (const UHxBoxBoundingVolume* box = Cast<UHxBoxBoundingVolume>(bounding_volume)) {
+    l_bounds_cm = FBox(box->getMinimaCm(), box->getMaximaCm());
+  } else {
+    return false;
+  }
+
+  // Bounding volumes are placed by the effect's simulation callbacks, which may or may not carry
+  // the component's scale, so cover both.
+  const FTransform& w_transform = effect->GetComponentTransform();
+  w_bounds_cm = l_bounds_cm.TransformBy(w_transform) + l_bounds_cm.TransformBy(
+      FTransform(w_transform.GetRotation(), w_transform.GetLocation()));
+  return true;
+}
+
+FIntVector HxSpatialEffectIndex::getCell(const FVector& w_position_cm) const {
+  return FIntVector(FMath::FloorToInt(w_position_cm.X / cell_size_cm_),
+      FMath::FloorToInt(w_position_cm.Y / cell_size_cm_),
+      FMath::FloorToInt(w_position_cm.Z / cell_size_cm_));
+}
+
+int64 HxSpatialEffectIndex::countCells(const FIntVector& min_cell, const FIntVector& max_cell) {
+  return static_cast<int64>(max_cell.X - min_cell.X + 1) *
+      static_cast<int64>(max_cell.Y - min_cell.Y + 1) *
+      static_cast<int64>(max_cell.Z - min_cell.Z + 1);
+}
+
+void HxSpatialEffectIndex::bin(Entry& entry) const {
+  if (!entry.w_bounds_cm.IsValid) {
+    entry.is_oversized = true;
+    entry.min_cell = FIntVector(0, 0, 0);
+    entry.max_cell = FIntVector(-1, -1, -1);
+    return;
+  }
+
+  entry.min_cell = getCell(entry.w_bounds_cm.Min);
+  entry.max_cell = getCell(entry.w_bounds_cm.Max);
+  entry.is_oversized = countCells(entry.min_cell, entry.max_cell) > MAX_CELLS_PER_EFFECT;
+}
+
+void HxSpatialEffectIndex::insert(UHxSpatialEffectComponent* effect, const Entry& entry) {
+  if (entry.is_oversized) {
+    oversized_effects_.Add(effect);
+    return;
+  }
+
+  for (int32 x = entry.min_cell.X; x <= entry.max_cell.X; x++) {
+    for (int32 y = entry.min_cell.Y; y <= entry.max_cell.Y; y++) {
+      for (int32 z = entry.min_cell.Z; z <= entry.max_cell.Z; z++) {
+        effects_from_cell_.FindOrAdd(FIntVector(x, y, z)).Add(effect);
+      }
+    }
+  }
+}
+
+void HxSpatialEffectIndex::erase(UHxSpatialEffectComponent* effect, const Entry& entry) {
+  if (entry.is_oversized) {
+    oversized_effects_.RemoveSingleSwap(effect);
+    return;
+  }
+
+  for (int32 x = entry.min_cell.X; x <= entry.max_cell.X; x++) {
+    for (int32 y = entry.min_cell.Y; y <= entry.max_cell.Y; y++) {
+      for (int32 z = entry.min_cell.Z; z <= entry.max_cell.Z; z++) {
+        const FIntVector cell(x, y, z);
+        TArray<UHxSpatialEffectComponent*>* cell_effects = effects_from_cell_.Find(cell);
+        if (cell_effects != nullptr) {
+          cell_effects->RemoveSingleSwap(effect);
+          if (cell_effects->Num() == 0) {
+            effects_from_cell_.Remove(cell);
+          }
+        }
+      }
+    }
+  }
+}
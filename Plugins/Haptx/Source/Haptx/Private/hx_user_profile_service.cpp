@@ -0,0 +1,149 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#include <Haptx/Public/hx_user_profile_service.h>
+#include <Runtime/Core/Public/Async/Async.h>
+#include <Haptx/Private/haptx_shared.h>
+#include <Haptx/Public/ihaptx.h>
+
+namespace {
+  //! Compares the fields of two profiles that the hands read.
+  //!
+  //! @param a The first profile.
+  //! @param b The second profile.
+  //!
+  //! @returns True if the hands would load @p a and @p b the same way.
+  bool isSameProfile(const HaptxApi::UserProfile& a, const HaptxApi::UserProfile& b) {
+    if (a.sex != b.sex || a.skin_tone != b.skin_tone ||
+        a.getBasicHandDimsValueM(HaptxApi::BHD_LENGTH) !=
+        b.getBasicHandDimsValueM(HaptxApi::BHD_LENGTH) ||
+        a.getBasicHandDimsValueM(HaptxApi::BHD_BREADTH) !=
+        b.getBasicHandDimsValueM(HaptxApi::BHD_BREADTH)) {
+      return false;
+    }
+
+    for (int f_i = 0; f_i < HaptxApi::F_LAST; f_i++) {
+      for (int fb_i = 0; fb_i < HaptxApi::FB_LAST; fb_i++) {
+        if (a.finger_bone_lengths_m[f_i][fb_i] != b.finger_bone_lengths_m[f_i][fb_i]) {
+          return false;
+        }
+      }
+      for (HaptxApi::RelativeDirection rel_dir : {HaptxApi::RelativeDirection::RD_LEFT,
+          HaptxApi::RelativeDirection::RD_RIGHT}) {
+        if (VECTOR3D_TO_FVECTOR(a.mcp3_joint1_pos_offsets_m[rel_dir][f_i]) !=
+            VECTOR3D_TO_FVECTOR(b.mcp3_joint1_pos_offsets_m[rel_dir][f_i])) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+}
+
+HxUserProfileService HxUserProfileService::ups_;
+
+HxUserProfileService::HxUserProfileService() : is_loaded_(false), is_loading_(false),
+    has_active_profile_(false), user_profile_(), username_(), hand_length_m_(0.0f),
+    hand_width_m_(0.0f), middle_finger_length_m_(0.0f), on_user_profile_changed_() {}
+
+void HxUserProfileService::requestLoad() {
+  if (!ups_.is_loaded_) {
+    beginLoad();
+  }
+}
+
+void HxUserProfileService::refresh() {
+  beginLoad();
+}
+
+bool HxUserProfileService::isLoaded() {
+  return ups_.is_loaded_;
+}
+
+bool HxUserProfileService::hasActiveProfile() {
+  return ups_.has_active_profile_;
+}
+
+const HaptxApi::UserProfile& HxUserProfileService::getUserProfile() {
+  return ups_.user_profile_;
+}
+
+const FString& HxUserProfileService::getUsername() {
+  return ups_.username_;
+}
+
+float HxUserProfileService::getHandLengthM() {
+  return ups_.hand_length_m_;
+}
+
+float HxUserProfileService::getHandWidthM() {
+  return ups_.hand_width_m_;
+}
+
+float HxUserProfileService::getMiddleFingerLengthM() {
+  return ups_.middle_finger_length_m_;
+}
+
+FOnHxUserProfileChanged& HxUserProfileService::onUserProfileChanged() {
+  return ups_.on_user_profile_changed_;
+}
+
+void HxUserProfileService::beginLoad() {
+  if (ups_.is_loading_) {
+    return;
+  }
+  ups_.is_loading_ = true;
+
+  Async(EAsyncExecution::ThreadPool, []() {
+    TSharedRef<LoadResult, ESPMode::ThreadSafe> result =
+        MakeShared<LoadResult, ESPMode::ThreadSafe>();
+    std::wstring active_username;
+    result->success = HaptxApi::UserProfileDatabase::getActiveUsername(&active_username) &&
+        HaptxApi::UserProfileDatabase::getUserProfile(active_username, &result->user_profile);
+    if (result->success) {
+      result->username = active_username.c_str();
+    } else {
+      result->user_profile = HaptxApi::UserProfile();
+    }
+
+    AsyncTask(ENamedThreads::GameThread, [result]() {
+      applyLoadResult(*result);
+    });
+  });
+}
+
+void HxUserProfileService::applyLoadResult(const LoadResult& result) {
+  ups_.is_loading_ = false;
+
+  const HaptxApi::UserProfile& profile = result.user_profile;
+  float hand_length_m = result.success ?
+      profile.getBasicHandDimsValueM(HaptxApi::BHD_LENGTH) : 0.0f;
+  float hand_width_m = result.success ?
+      profile.getBasicHandDimsValueM(HaptxApi::BHD_BREADTH) : 0.0f;
+  float middle_finger_length_m =
+      profile.finger_bone_lengths_m[HaptxApi::Finger::F_MIDDLE][HaptxApi::FingerBone::FB_PROXIMAL] +
+      profile.finger_bone_lengths_m[HaptxApi::Finger::F_MIDDLE][HaptxApi::FingerBone::FB_MEDIAL] +
+      profile.finger_bone_lengths_m[HaptxApi::Finger::F_MIDDLE][HaptxApi::FingerBone::FB_DISTAL];
+
+  // Reloading a profile restarts the hands' slip compensation and resizes them, so only do it
+  // when something they read has changed.
+  bool changed = !ups_.is_loaded_ || ups_.has_active_profile_ != result.success ||
+      ups_.username_ != result.username || !isSameProfile(ups_.user_profile_, profile);
+  if (!changed) {
+    return;
+  }
+
+  if (!result.success) {
+    UE_LOG(HaptX, Warning,
+        TEXT("HxUserProfileService: Failed to load the active user profile. Using the default profile instead."))
+  }
+  ups_.is_loaded_ = true;
+  ups_.has_active_profile_ = result.success;
+  ups_.user_profile_ = profile;
+  ups_.username_ = result.username;
+  ups_.hand_length_m_ = hand_length_m;
+  ups_.hand_width_m_ = hand_width_m;
+  ups_.middle_finger_length_m_ = middle_finger_length_m;
+  ups_.on_user_profile_changed_.Broadcast();
+}
@@ -6,20 +6,27 @@
 
 UHxWaveDirectEffectComponent::UHxWaveDirectEffectComponent() : frequency_Hz_(10.f),
     amplitude_cm_(0.5f), invert_oscillation_(false), input_phase_offset_deg_(0.f),
-    output_displacement_offset_cm_(0.f), duration_s_(1.f) {
+    output_displacement_offset_cm_(0.f), duration_s_(1.f), oscillator_(INDEX_NONE) {
   is_looping_ = true;
 }
 
 void UHxWaveDirectEffectComponent::BeginPlay() {
   Super::BeginPlay();
   updateDuration();
+  oscillator_ = HxOscillatorBank::addOscillator(getEffectInternal(), frequency_Hz_,
+      amplitude_cm_, input_phase_offset_deg_);
+}
+
+void UHxWaveDirectEffectComponent::EndPlay(EEndPlayReason::Type EndPlayReason) {
+  Super::EndPlay(EndPlayReason);
+  HxOscillatorBank::removeOscillator(oscillator_);
+  oscillator_ = INDEX_NONE;
 }
 
 float UHxWaveDirectEffectComponent::getDisplacementM(
     const HaptxApi::DirectEffect::DirectInfo& direct_info) const {
-  float wave_output_cm = evaluateSineWave(direct_info.time_s, frequency_Hz_,
-      input_phase_offset_deg_);
-  wave_output_cm *= amplitude_cm_;
+  float wave_output_cm = HxOscillatorBank::sample(oscillator_, direct_info.time_s,
+      frequency_Hz_, amplitude_cm_, input_phase_offset_deg_);
   if (invert_oscillation_) {
     wave_output_cm *= -1.f;
   }
@@ -6,20 +6,27 @@
 
 UHxWaveObjectEffectComponent::UHxWaveObjectEffectComponent() : frequency_Hz_(10.f),
     amplitude_cN_(10000.f), invert_oscillation_(false), input_phase_offset_deg_(0.f),
-    output_force_offset_cN_(0.f), duration_s_(1.f) {
+    output_force_offset_cN_(0.f), duration_s_(1.f), oscillator_(INDEX_NONE) {
   is_looping_ = true;
 }
 
 void UHxWaveObjectEffectComponent::BeginPlay() {
   Super::BeginPlay();
   updateDuration();
+  oscillator_ = HxOscillatorBank::addOscillator(getEffectInternal(), frequency_Hz_,
+      amplitude_cN_, input_phase_offset_deg_);
+}
+
+void UHxWaveObjectEffectComponent::EndPlay(EEndPlayReason::Type EndPlayReason) {
+  Super::EndPlay(EndPlayReason);
+  HxOscillatorBank::removeOscillator(oscillator_);
+  oscillator_ = INDEX_NONE;
 }
 
 float UHxWaveObjectEffectComponent::getForceN(
     const HaptxApi::ObjectEffect::ContactInfo& contact_info) const {
-  float wave_output_cN = evaluateSineWave(contact_info.time_s, frequency_Hz_,
-      input_phase_offset_deg_);
-  wave_output_cN *= amplitude_cN_;
+  float wave_output_cN = HxOscillatorBank::sample(oscillator_, contact_info.time_s,
+      frequency_Hz_, amplitude_cN_, input_phase_offset_deg_);
   if (invert_oscillation_) {
     wave_output_cN *= -1.f;
   }
@@ -0,0 +1,163 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#pragma once
+
+#include <Runtime/Core/Public/CoreMinimal.h>
+#include <Runtime/Engine/Classes/Engine/EngineTypes.h>
+#include <Runtime/Engine/Public/CollisionQueryParams.h>
+#include <Runtime/Engine/Public/WorldCollision.h>
+
+class UBodySetup;
+class UPrimitiveComponent;
+struct FBodyInstance;
+struct FKConvexElem;
+
+//! @brief Sweeps tactor trace spheres directly against the simple collision of nearby bodies.
+//!
+//! gather() flattens the sphere, capsule, box and convex elements of every body found by a
+//! broadphase overlap into world space arrays, and sweep() tests a trace against all of them in
+//! one pass without a scene query. Bodies whose traces would hit triangle meshes instead (complex
+//! collision, or convex hulls too large to bound with planes cheaply) are swept individually
+//! with UPrimitiveComponent::SweepComponent().
+//!
+//! Boxes and convex hulls are inflated by the sweep radius with flat faces rather than rounded
+//! edges, so sweeps that graze their edges and corners hit slightly early.
+//!
+//! Must only be used from the game thread.
+class HAPTX_API HxAnalyticTraceSampler {
+ public:
+  //! Gathers the collision of the bodies in a set of overlaps, replacing anything gathered
+  //! before.
+  //!
+  //! @param overlaps The overlaps.
+  //! @param trace_complex Whether traces would be complex if they were scene queries.
+  void gather(const TArray<FOverlapResult>& overlaps, bool trace_complex);
+
+  //! Sweeps a sphere against everything gathered.
+  //!
+  //! @param w_start_cm Where the sweep starts [cm].
+  //! @param w_end_cm Where the sweep ends [cm].
+  //! @param sphere The sphere to sweep.
+  //! @param [out] hit The nearest hit, if there is one.
+  //!
+  //! @returns Whether anything was hit.
+  bool sweep(const FVector& w_start_cm, const FVector& w_end_cm, const FCollisionShape& sphere,
+      FHitResult& hit) const;
+
+ private:
+  //! A body whose elements have been gathered.
+  struct Body {
+    //! The body's component.
+    TWeakObjectPtr<UPrimitiveComponent> component{};
+
+    //! The body's bone.
+    FName bone{NAME_None};
+  };
+
+  //! Convex hull faces relative to their element.
+  struct ConvexPlanes {
+    //! The number of hull vertices the faces were built from, or INDEX_NONE if they haven't been
+    //! built.
+    int32 num_vertices{INDEX_NONE};
+
+    //! The faces, with normals pointing out of the hull. Empty if the hull was too large or
+    //! degenerate.
+    TArray<FPlane> planes{};
+  };
+
+  //! Gathers the elements of one body.
+  //!
+  //! @param component The body's component.
+  //! @param body The body.
+  //! @param w_body The body's world transform.
+  void gatherBody(UPrimitiveComponent* component, FBodyInstance* body, const FTransform& w_body);
+
+  //! Gets the faces of a convex element, building them if necessary.
+  //!
+  //! @param body_setup The body setup the element belongs to.
+  //! @param elem_i The index of the element.
+  //! @param elem The element.
+  //!
+  //! @returns The faces, or nullptr if there are too many vertices to build them cheaply.
+  static const TArray<FPlane>* getConvexPlanes(UBodySetup* body_setup, int32 elem_i,
+      const FKConvexElem& elem);
+
+  //! Fills in a hit found by sweep().
+  //!
+  //! @param body_i The index of the body that was hit.
+  //! @param w_start_cm Where the sweep starts [cm].
+  //! @param w_end_cm Where the sweep ends [cm].
+  //! @param w_direction The sweep direction.
+  //! @param w_radius_cm The sweep radius [cm].
+  //! @param distance_cm How far along the sweep the hit is [cm].
+  //! @param w_normal The surface normal at the hit.
+  //! @param [out] hit The hit.
+  void makeHit(int32 body_i, const FVector& w_start_cm, const FVector& w_end_cm,
+      const FVector& w_direction, float w_radius_cm, float distance_cm, const FVector& w_normal,
+      FHitResult& hit) const;
+
+  //! Whether traces would be complex if they were scene queries.
+  bool trace_complex_{false};
+
+  //! Gathered bodies.
+  TArray<Body> bodies_;
+
+  //! Bodies gathered so far, to skip duplicate overlaps.
+  TSet<const FBodyInstance*> gathered_bodies_;
+
+  //! Components swept individually.
+  TArray<TWeakObjectPtr<UPrimitiveComponent>> complex_components_;
+
+  //! Sphere centers [cm].
+  TArray<FVector> w_sphere_centers_cm_;
+
+  //! Sphere radii [cm].
+  TArray<float> w_sphere_radii_cm_;
+
+  //! The body of each sphere.
+  TArray<int32> sphere_bodies_;
+
+  //! Capsule centers [cm].
+  TArray<FVector> w_capsule_centers_cm_;
+
+  //! Capsule axes.
+  TArray<FVector> w_capsule_axes_;
+
+  //! Half the length of each capsule's axis segment [cm].
+  TArray<float> w_capsule_half_lengths_cm_;
+
+  //! Capsule radii [cm].
+  TArray<float> w_capsule_radii_cm_;
+
+  //! The body of each capsule.
+  TArray<int32> capsule_bodies_;
+
+  //! Box centers [cm].
+  TArray<FVector> w_box_centers_cm_;
+
+  //! Box orientations.
+  TArray<FQuat> w_box_orients_;
+
+  //! Box half extents [cm].
+  TArray<FVector> w_box_half_extents_cm_;
+
+  //! The body of each box.
+  TArray<int32> box_bodies_;
+
+  //! World faces of every convex hull, stored contiguously.
+  TArray<FPlane> w_convex_planes_cm_;
+
+  //! The index of each hull's first face in #w_convex_planes_cm_.
+  TArray<int32> convex_first_planes_;
+
+  //! The number of faces of each hull.
+  TArray<int32> convex_num_planes_;
+
+  //! The body of each hull.
+  TArray<int32> convex_bodies_;
+
+  //! Convex hull faces by body setup and element index, shared by every sampler.
+  static TMap<TPair<TWeakObjectPtr<UBodySetup>, int32>, ConvexPlanes> convex_planes_;
+};
@@ -0,0 +1,136 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#pragma once
+
+#include <Runtime/Core/Public/CoreMinimal.h>
+#include <Runtime/Core/Public/HAL/PlatformTime.h>
+
+//! The plugin subsystems timed by HxBenchmarkStats.
+enum class HxBenchmarkStat : uint8 {
+  //! AHxHandActor primary and secondary ticks.
+  HAND_TICK,
+  //! UHxPatchComponent tactor traces.
+  PATCH_TRACES,
+  //! The AHxCoreActor contact interpreter commit and hardware render.
+  CORE_UPDATE,
+  //! AHxCoreActor grasp detection and grasp constraint updates.
+  GRASP_UPDATE,
+  //! AHxCoreActor spatial effect indexing and registration.
+  SPATIAL_EFFECTS,
+  //! The number of stats.
+  LAST
+};
+
+//! @brief Lightweight timers for measuring how the plugin scales.
+//!
+//! Unlike the stats enabled by PROFILING these are always compiled in, and cost a single branch
+//! while disabled. They exist to serve UHxScaleBenchmarkCommandlet, and are only accurate on the
+//! game thread.
+class HAPTX_API HxBenchmarkStats {
+ public:
+  //! Whether timers are currently recording.
+  //!
+  //! @returns True if timers are currently recording.
+  static bool isEnabled() {
+    return is_enabled_;
+  }
+
+  //! Starts or stops recording.
+  //!
+  //! @param enabled Whether timers should record.
+  static void setEnabled(bool enabled);
+
+  //! Clears all recorded values.
+  static void reset();
+
+  //! Adds time to a stat.
+  //!
+  //! @param stat The stat to add to.
+  //! @param time_s The time to add [s].
+  static void addTime(HxBenchmarkStat stat, double time_s);
+
+  //! Adds to the number of bytes of physics state the plugin would have sent over the network.
+  //!
+  //! @param num_bytes The number of bytes to add.
+  static void addPhysicsStateBytes(int64 num_bytes);
+
+  //! Counts a HxOscillatorBank sample.
+  //!
+  //! @param hit Whether the sample used a value precomputed by HxOscillatorBank::advance().
+  static void addOscillatorSample(bool hit);
+
+  //! Gets the total time recorded for a stat.
+  //!
+  //! @param stat The stat of interest.
+  //!
+  //! @returns The total time recorded for @p stat [s].
+  static double getTime(HxBenchmarkStat stat);
+
+  //! Gets the total number of physics state bytes recorded.
+  //!
+  //! @returns The total number of physics state bytes recorded.
+  static int64 getPhysicsStateBytes();
+
+  //! Gets the number of oscillator samples recorded that used precomputed values.
+  //!
+  //! @returns The number of oscillator samples recorded that used precomputed values.
+  static int64 getOscillatorHits();
+
+  //! Gets the number of oscillator samples recorded that were computed on demand.
+  //!
+  //! @returns The number of oscillator samples recorded that were computed on demand.
+  static int64 getOscillatorMisses();
+
+  //! Gets a stat's name.
+  //!
+  //! @param stat The stat of interest.
+  //!
+  //! @returns The name of @p stat.
+  static const TCHAR* toString(HxBenchmarkStat stat);
+
+ private:
+  //! Whether timers are currently recording.
+  static bool is_enabled_;
+
+  //! The total time recorded for each stat [s].
+  static double time_s_[static_cast<int>(HxBenchmarkStat::LAST)];
+
+  //! The total number of physics state bytes recorded.
+  static int64 physics_state_bytes_;
+
+  //! The number of oscillator samples recorded that used precomputed values.
+  static int64 oscillator_hits_;
+
+  //! The number of oscillator samples recorded that were computed on demand.
+  static int64 oscillator_misses_;
+};
+
+//! Adds the lifetime of this object to a stat if HxBenchmarkStats is recording.
+class HxScopedBenchmarkTimer {
+ public:
+  //! Starts timing.
+  //!
+  //! @param stat The stat to add to.
+  explicit HxScopedBenchmarkTimer(HxBenchmarkStat stat) : stat_(stat),
+      start_time_s_(HxBenchmarkStats::isEnabled() ? FPlatformTime::Seconds() : -1.0) {}
+
+  //! Stops timing.
+  ~HxScopedBenchmarkTimer() {
+    if (start_time_s_ >= 0.0) {
+      HxBenchmarkStats::addTime(stat_, FPlatformTime::Seconds() - start_time_s_);
+    }
+  }
+
+ private:
+  //! The stat to add to.
+  HxBenchmarkStat stat_;
+
+  //! When timing started [s], or a negative value if HxBenchmarkStats wasn't recording.
+  double start_time_s_;
+};
+
+//! Times the rest of the enclosing scope under a HxBenchmarkStat.
+#define HX_BENCHMARK_SCOPE(stat) \
+    HxScopedBenchmarkTimer hx_benchmark_timer_##stat(HxBenchmarkStat::stat);
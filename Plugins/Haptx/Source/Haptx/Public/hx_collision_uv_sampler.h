@@ -0,0 +1,102 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#pragma once
+
+#include <Runtime/Core/Public/CoreMinimal.h>
+#include <Runtime/Engine/Classes/Engine/EngineTypes.h>
+
+class UPrimitiveComponent;
+class UStaticMesh;
+class UWorld;
+
+//! @brief Samples texture coordinates at tactor trace hits without project-wide UV support.
+//!
+//! UGameplayStatics::FindCollisionUV() requires bSupportUVFromHitResults, which keeps UV data for
+//! the collision of every mesh in the project. This sampler instead builds a compact table of
+//! triangle positions and UVs for a static mesh the first time a hit on it needs UVs, and only for
+//! meshes whose UHxPhysicalMaterial sets UHxPhysicalMaterial::sample_uvs_. Tables are built from
+//! the mesh's CPU copy of its collision LOD, so those meshes need "Allow CPU Access" in cooked
+//! builds. Tables are dropped when a world is cleaned up, and entries for destroyed components
+//! and meshes are pruned as new ones are added.
+//!
+//! Must only be used from the game thread.
+class HAPTX_API HxCollisionUvSampler {
+ public:
+  //! Samples UVs at a hit.
+  //!
+  //! @param hit A hit from a complex trace that returned its face index.
+  //! @param uv_channels The UV channels to sample.
+  //! @param [out] uvs Emptied, then populated with one UV for each channel that could be sampled.
+  //!
+  //! @returns Whether any UVs were sampled.
+  static bool sample(const FHitResult& hit, const TArray<int32>& uv_channels,
+      TArray<FVector2D>& uvs);
+
+ private:
+  //! Hidden default constructor.
+  HxCollisionUvSampler();
+
+  //! The triangles of a mesh's collision LOD with their UVs.
+  struct MeshUvTable {
+    //! The number of UV channels in #uvs.
+    int32 num_uv_channels{0};
+
+    //! The number of triangles.
+    int32 num_faces{0};
+
+    //! Three component space corner positions per triangle in collision face order [cm].
+    TArray<FVector> l_positions_cm{};
+
+    //! Corner UVs indexed by (face * 3 + corner) * #num_uv_channels + channel.
+    TArray<FVector2D> uvs{};
+  };
+
+  //! The table a component samples from.
+  struct ComponentEntry {
+    //! The static mesh the table was built from.
+    TWeakObjectPtr<UStaticMesh> mesh{};
+
+    //! The table, or null if the component doesn't sample UVs.
+    TSharedPtr<const MeshUvTable> table{};
+  };
+
+  //! Gets the table a component samples from, building it if necessary.
+  //!
+  //! @param component The component.
+  //!
+  //! @returns The table, or nullptr if the component doesn't sample UVs.
+  static const MeshUvTable* getTable(UPrimitiveComponent* component);
+
+  //! Builds the table for a mesh.
+  //!
+  //! @param mesh The mesh.
+  //!
+  //! @returns The table, or null if the mesh's CPU data isn't available.
+  static TSharedPtr<const MeshUvTable> buildTable(UStaticMesh* mesh);
+
+  //! Removes the entries of destroyed components and meshes once the tables have doubled in size
+  //! since they were last pruned.
+  static void pruneIfGrown();
+
+  //! Drops all tables so they don't outlive the world they were built for.
+  //!
+  //! @param world The world being cleaned up.
+  //! @param session_ended Whether the play session ended.
+  //! @param cleanup_resources Whether the world's resources are being cleaned up.
+  static void onWorldCleanup(UWorld* world, bool session_ended, bool cleanup_resources);
+
+  //! Tables by mesh, shared by every component using the mesh.
+  static TMap<TWeakObjectPtr<UStaticMesh>, TSharedPtr<const MeshUvTable>> table_from_mesh_;
+
+  //! Tables by component.
+  static TMap<TWeakObjectPtr<UPrimitiveComponent>, ComponentEntry> entry_from_component_;
+
+  //! The number of entries in #entry_from_component_ and #table_from_mesh_ after they were last
+  //! pruned.
+  static int32 num_entries_after_prune_;
+
+  //! The handle of #onWorldCleanup() bound to FWorldDelegates::OnWorldCleanup.
+  static FDelegateHandle world_cleanup_handle_;
+};
@@ -10,6 +10,7 @@
 #include <Runtime/Engine/Classes/Components/SphereComponent.h>
 #include <Runtime/Engine/Classes/GameFramework/Actor.h>
 #include <Runtime/Engine/Classes/PhysicsEngine/PhysicsConstraintComponent.h>
+#include <Runtime/Engine/Public/CollisionQueryParams.h>
 #include <HaptxApi/contact_interpreter.h>
 #include <HaptxApi/grasp_detector.h>
 #include <HaptxApi/haptx_system.h>
@@ -18,6 +19,7 @@
 #include <Haptx/Public/contact_interpreter_parameters.h>
 #include <Haptx/Public/hx_on_screen_log.h>
 #include <Haptx/Public/hx_physical_material.h>
+#include <Haptx/Public/hx_spatial_effect_index.h>
 #include <Haptx/Public/ihaptx.h>
 #include "hx_core_actor.generated.h"
 
@@ -52,6 +54,19 @@ enum class EPhysicsAuthorityMode : uint8 {
   SERVER     UMETA(DisplayName = "Server")
 };
 
+//! How @link UHxPatchComponent UHxPatchComponents @endlink run their tactor traces.
+UENUM(BlueprintType)
+enum class ETactileTraceMode : uint8 {
+  //! Each patch sweeps its tactors one at a time on the game thread.
+  SYNCHRONOUS  UMETA(DisplayName = "Synchronous"),
+  //! Each patch submits its sweeps to the world's async trace batch. Results reach the contact
+  //! interpreter one frame later.
+  ASYNC        UMETA(DisplayName = "Async"),
+  //! The core sweeps the tactors of all patches across worker threads under one physics scene
+  //! read lock just before its update. Results reach the contact interpreter the same frame.
+  PARALLEL     UMETA(DisplayName = "Parallel")
+};
+
 //! @brief Represents parameters used in the grasp visualizer.
 //!
 //! This struct only exists for organizational purposes in the details panel.
@@ -427,6 +442,83 @@ public:
   bool tryRegisterObjectWithCi(UPrimitiveComponent* comp, FName bone,
       bool register_again, int64_t& object_id);
 
+  //! Queues a patch whose traces should be run in parallel with those of other patches before
+  //! the next contact interpreter update.
+  //!
+  //! @param patch The patch.
+  void queueParallelTraces(class UHxPatchComponent* patch);
+
+  //! Queues a hand whose buffered contacts should be flushed before the next contact interpreter
+  //! and grasp detector update.
+  //!
+  //! @param hand The hand.
+  void queueContactFlush(class AHxHandActor* hand);
+
+  //! @brief Gets the object type parameters shared by every patch's tactor traces.
+  //!
+  //! Built from #tactile_feedback_collision_types_ the first time they're needed. The returned
+  //! reference stays valid for the life of this actor.
+  //!
+  //! @returns The object type parameters.
+  const FCollisionObjectQueryParams& getTactileTraceObjectParams();
+
+  //! Rebuilds the parameters returned by getTactileTraceObjectParams(). Call after changing
+  //! #allow_tactile_feedback_collision_type_whitelist_ or #tactile_feedback_collision_types_.
+  void updateTactileTraceObjectParams();
+
+  //! @brief Gets the query parameters shared by the tactor traces of every patch on an actor.
+  //!
+  //! The actor itself and any actors passed to ignoreActorInTactileTraces() are ignored.
+  //!
+  //! @param owner The actor the patches are on.
+  //! @param trace_complex Whether the traces are complex.
+  //!
+  //! @returns The query parameters, or nullptr if @p owner is invalid.
+  TSharedPtr<const FCollisionQueryParams> getTactileTraceQueryParams(AActor* owner,
+      bool trace_complex);
+
+  //! Ignores an actor in the tactor traces of every patch on another actor.
+  //!
+  //! @param owner The actor the patches are on.
+  //! @param actor The actor to ignore.
+  void ignoreActorInTactileTraces(AActor* owner, AActor* actor);
+
+  //! Whether patches share the per-frame trace budget in #tactile_trace_budget_.
+  //!
+  //! @returns Whether patches share a trace budget.
+  bool isTactileTraceBudgetEnabled() const;
+
+  //! Gets the trace priority of tactors in a coverage region from
+  //! #coverage_region_trace_priorities_.
+  //!
+  //! @param coverage_region The coverage region.
+  //!
+  //! @returns The largest priority whose key is part of @p coverage_region, or 1 if none are.
+  float getCoverageRegionTracePriority(const FString& coverage_region) const;
+
+  //! @brief Claims traces from this frame's shared trace budget.
+  //!
+  //! Every claim counts toward the demand used to set next frame's priority threshold, so
+  //! traces compete with those of other patches by priority rather than by tick order.
+  //!
+  //! @param priorities The priority of each trace the patch wants to run this frame.
+  //!
+  //! @returns How many of the patch's highest priority traces it may run.
+  int32 claimTactileTraces(const TArray<float>& priorities);
+
+  //! @brief Registers a spatial effect with the contact interpreter.
+  //!
+  //! If #index_spatial_effects_ is set the effect is only registered while its bounding volume
+  //! overlaps a body registered with registerBodyWithCi().
+  //!
+  //! @param effect The effect. Must have begun play.
+  void registerSpatialEffect(class UHxSpatialEffectComponent* effect);
+
+  //! Unregisters a spatial effect registered with registerSpatialEffect().
+  //!
+  //! @param effect The effect.
+  void unregisterSpatialEffect(class UHxSpatialEffectComponent* effect);
+
   //! Associates a component/bone with a HaptxApi::ContactInterpreter body ID.
   //!
   //! Any independently moving part of an UHxHandComponent may be associated with its own
@@ -641,6 +733,108 @@ public:
       meta = (editcondition = "allow_tactile_feedback_collision_type_whitelist_"))
   TArray<TEnumAsByte<ECollisionChannel>> tactile_feedback_collision_types_;
 
+  //! @brief How patches run their tactor traces.
+  //!
+  //! Async traces are an opt-in trade-off: they run alongside the rest of the frame and take the
+  //! traces off the game thread, but every tactile sample reaches the contact interpreter a frame
+  //! late. Parallel traces keep the latency of synchronous traces while spreading them over
+  //! worker threads.
+
+  // How patches run their tactor traces. Async traces add a frame of tactile latency.
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Contact Interpreter")
+  ETactileTraceMode tactile_trace_mode_ = ETactileTraceMode::SYNCHRONOUS;
+
+  //! @brief Whether patches sweep tactor traces directly against the simple collision of bodies
+  //! found by their broadphase overlap instead of running scene queries.
+  //!
+  //! Suits scenes whose tactile targets have sphere, capsule, box or convex collision. Bodies
+  //! whose traces would hit triangle meshes are swept individually. Takes precedence over
+  //! #tactile_trace_mode_ since the sweeps are cheap enough to run synchronously.
+
+  // Whether patches sweep tactor traces directly against the simple collision of nearby bodies
+  // instead of running scene queries.
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Contact Interpreter")
+  bool analytic_tactile_traces_ = false;
+
+  //! @brief Whether to also run scene queries for analytic tactor traces and count where they
+  //! disagree.
+  //!
+  //! Disagreements and the time spent on each kind of trace are reported in the HxPatch stats
+  //! group. Analytic results are still the ones used.
+
+  // Whether to also run scene queries for analytic tactor traces and count where they disagree.
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Contact Interpreter",
+      meta = (editcondition = "analytic_tactile_traces_"))
+  bool compare_analytic_tactile_traces_ = false;
+
+  //! @brief The number of tactor traces all patches may run per frame combined, or 0 for no
+  //! limit.
+  //!
+  //! When limited, traces are scheduled by priority. A trace's priority is its coverage region's
+  //! priority (see #coverage_region_trace_priorities_), raised by recent contact and by how long
+  //! it has gone unscheduled, and lowered by its distance from objects found by the patch's
+  //! broadphase overlap. Unscheduled traces reuse their last hit when they have one.
+
+  // The number of tactor traces all patches may run per frame combined, or 0 for no limit.
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Contact Interpreter",
+      meta = (UIMin = "0", ClampMin = "0"))
+  int32 tactile_trace_budget_ = 0;
+
+  //! @brief Whether spatial effects are only registered with the contact interpreter while their
+  //! bounding volumes overlap a hand.
+  //!
+  //! The contact interpreter tests every registered spatial effect against every tactor. With
+  //! this set spatial effects are indexed in a grid (see HxSpatialEffectIndex), and each frame only
+  //! those whose bounds overlap the bounds of a hand body are registered. Effects that aren't
+  //! registered are advanced here so their play time is unaffected. Unbounded effects are always
+  //! registered.
+
+  // Whether spatial effects are only registered with the contact interpreter while their bounding
+  // volumes overlap a hand.
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Contact Interpreter")
+  bool index_spatial_effects_ = true;
+
+  //! The edge length of the grid cells spatial effects are indexed in [cm].
+
+  // The edge length of the grid cells spatial effects are indexed in [cm].
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Contact Interpreter",
+      meta = (UIMin = "1.0", ClampMin = "1.0", editcondition = "index_spatial_effects_"))
+  float spatial_effect_index_cell_size_cm_ = 50.0f;
+
+  //! @brief The trace priority of tactors whose coverage region contains each key.
+  //!
+  //! Tactors in no listed region have a priority of 1.
+
+  // The trace priority of tactors whose coverage region contains each key.
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Contact Interpreter")
+  TMap<FString, float> coverage_region_trace_priorities_ = {
+      {TEXT("_TIP"), 4.0f}, {TEXT("_DISTAL"), 2.0f}, {TEXT("_PALM"), 0.5f}};
+
+  //! The factor by which trace priority is multiplied for tactors that recently made contact.
+
+  // The factor by which trace priority is multiplied for tactors that recently made contact.
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Contact Interpreter",
+      meta = (UIMin = "1.0", ClampMin = "1.0"))
+  float recent_contact_trace_priority_scale_ = 4.0f;
+
+  //! How many frames after its last contact a tactor counts as having recently made contact.
+
+  // How many frames after its last contact a tactor counts as having recently made contact.
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Contact Interpreter",
+      meta = (UIMin = "0", ClampMin = "0"))
+  int32 recent_contact_frames_ = 30;
+
+  //! @brief How much trace priority grows for each frame a trace goes unscheduled, relative to
+  //! its base priority.
+  //!
+  //! Keeps low priority traces from starving.
+
+  // How much trace priority grows for each frame a trace goes unscheduled, relative to its base
+  // priority.
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Contact Interpreter",
+      meta = (UIMin = "0.0", ClampMin = "0.0"))
+  float unscheduled_trace_priority_growth_ = 0.1f;
+
   //! @brief Whether to allow the #force_feedback_collision_types_ whitelist to be used.
   //!
   //! If disabled, all object types are accepted (so #force_feedback_collision_types_ won't be used
@@ -816,6 +1010,15 @@ protected:
   UPROPERTY(EditAnywhere, Category = "Networking", Replicated)
   EPhysicsAuthorityMode physics_authority_mode_;
 
+  //! @brief How often [s] to check in the background whether the active user profile has changed.
+  //!
+  //! Hands update themselves whenever it does. A value of 0 only loads the profile once.
+
+  // How often [s] to check in the background whether the active user profile has changed. A value
+  // of 0 only loads the profile once.
+  UPROPERTY(EditAnywhere, Category = "User Profile", meta = (ClampMin = "0.0", UIMin = "0.0"))
+  float user_profile_refresh_period_s_;
+
   //! @brief True to enable on-screen logging.
   //!
   //! Determines whether messages get rendered on-screen.
@@ -961,6 +1164,9 @@ private:
   //! The amount of time that has passed in the physics simulation since the last Tick().
   float physics_delta_time_s_{0.0f};
 
+  //! The world time [s] at which the user profile was last refreshed.
+  float time_of_last_user_profile_refresh_s_{0.0f};
+
   //! A map of grasp-capable body Ids to information associated with them for grasping.
   TMap<int64, FGraspBodyInfo> gd_body_id_to_component_and_bone_;
 
@@ -1006,6 +1212,72 @@ private:
   //! Populated with Log messages from HaptxApi.
   std::deque<HaptxApi::LogMessage> haptx_log_messages_;
 
+  //! Patches whose traces will be run in parallel before the next contact interpreter update.
+  TArray<TWeakObjectPtr<class UHxPatchComponent>> patches_awaiting_parallel_traces_;
+
+  //! Hands whose buffered contacts will be flushed before the next contact interpreter update.
+  TArray<TWeakObjectPtr<class AHxHandActor>> hands_awaiting_contact_flush_;
+
+  //! Object type parameters shared by every patch's tactor traces.
+  FCollisionObjectQueryParams tactile_trace_object_params_;
+
+  //! Whether #tactile_trace_object_params_ has been built.
+  bool tactile_trace_object_params_built_;
+
+  //! Query parameters shared by the tactor traces of every patch on an actor, by actor and
+  //! whether traces are complex.
+  TMap<TPair<TWeakObjectPtr<AActor>, bool>, TSharedPtr<FCollisionQueryParams>>
+      tactile_trace_query_params_;
+
+  //! Gets the query parameters shared by the tactor traces of every patch on an actor, creating
+  //! them if necessary.
+  //!
+  //! @param owner The actor the patches are on. Must be valid.
+  //! @param trace_complex Whether the traces are complex.
+  //!
+  //! @returns The query parameters.
+  TSharedPtr<FCollisionQueryParams> findOrAddTactileTraceQueryParams(AActor* owner,
+      bool trace_complex);
+
+  //! Starts a new trace budget frame if GFrameCounter has advanced since the last claim.
+  void updateTactileTraceBudgetFrame();
+
+  //! The value of GFrameCounter during the current trace budget frame.
+  uint64 tactile_trace_budget_frame_;
+
+  //! Traces with at least this priority may be claimed this frame.
+  float tactile_trace_priority_threshold_;
+
+  //! The number of traces left in this frame's budget.
+  int32 tactile_traces_remaining_;
+
+  //! The priorities of every trace claimed this frame.
+  TArray<float> tactile_trace_demand_;
+
+  //! Registers spatial effects that overlap a body with the contact interpreter, unregisters
+  //! those that don't, and advances the effects left unregistered.
+  //!
+  //! @param delta_time_s The time [s] the contact interpreter is about to advance effects by.
+  void updateSpatialEffectRegistration(float delta_time_s);
+
+  //! Registers a spatial effect with the contact interpreter if it isn't already.
+  //!
+  //! @param effect The effect.
+  void registerSpatialEffectWithCi(class UHxSpatialEffectComponent* effect);
+
+  //! Every spatial effect passed to registerSpatialEffect().
+  HxSpatialEffectIndex spatial_effect_index_;
+
+  //! The spatial effects currently registered with the contact interpreter.
+  TMap<class UHxSpatialEffectComponent*, std::shared_ptr<HaptxApi::SpatialEffect>>
+      ci_spatial_effects_;
+
+  //! The spatial effects overlapping a body this frame.
+  TSet<class UHxSpatialEffectComponent*> nearby_spatial_effects_;
+
+  //! The components passed to registerBodyWithCi().
+  TArray<TWeakObjectPtr<UPrimitiveComponent>> ci_body_components_;
+
   //! Whether or not we've displayed a restart message yet (we only print one per session).
   static bool has_printed_restart_message_;
 
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <Runtime/Engine/Classes/Curves/CurveFloat.h>
+#include <Haptx/Public/hx_curve_table.h>
 #include <Haptx/Public/hx_direct_effect_component.h>
 #include "hx_curve_direct_effect_component.generated.h"
 
@@ -69,6 +70,30 @@ public:
   UFUNCTION(BlueprintCallable, Category = "Haptic Effects")
   void setOutputDisplacementScale(float output_displacement_scale);
 
+  //! Get the value of #curve_table_resolution_.
+  //!
+  //! @returns The value of #curve_table_resolution_.
+
+  // Get the value of Curve Table Resolution.
+  UFUNCTION(BlueprintCallable, Category = "Haptic Effects")
+  int32 getCurveTableResolution() const;
+
+  //! Set the value of #curve_table_resolution_, baking #displacement_curve_ again.
+  //!
+  //! @param curve_table_resolution The new value for #curve_table_resolution_.
+
+  // Set the value of Curve Table Resolution.
+  UFUNCTION(BlueprintCallable, Category = "Haptic Effects")
+  void setCurveTableResolution(int32 curve_table_resolution);
+
+  //! Get the largest difference between #displacement_curve_ and the table it's baked into.
+  //!
+  //! @returns The largest difference, in the curve's units. Zero if the curve isn't baked.
+
+  // Get the largest difference between Displacement Curve and the table it's baked into.
+  UFUNCTION(BlueprintCallable, Category = "Haptic Effects")
+  float getCurveTableMaxError() const;
+
 protected:
   //! Sets default values for this component's properties.
 
@@ -103,6 +128,17 @@ protected:
   UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Haptic Effects")
   float output_displacement_scale_;
 
+  //! @brief The number of samples #displacement_curve_ is baked into for evaluation.
+  //!
+  //! Baked curves are linearly interpolated between uniformly spaced samples, which is much
+  //! cheaper than evaluating the curve's keys. Values less than 2 evaluate the curve directly.
+
+  // The number of samples Displacement Curve is baked into for evaluation. Values less than 2
+  // evaluate the curve directly.
+  UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Haptic Effects",
+      meta = (ClampMin = "0", UIMin = "0"))
+  int32 curve_table_resolution_;
+
 private:
   //! Updates values internally so that scaling time works as expected.
 
@@ -119,4 +155,8 @@ private:
   //! The largest time value present in the curve.
 
   float max_time_s_;
+
+  //! #displacement_curve_ baked for evaluation.
+
+  HxCurveTable curve_table_;
 };
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <Runtime/Engine/Classes/Curves/CurveFloat.h>
+#include <Haptx/Public/hx_curve_table.h>
 #include <Haptx/Public/hx_spatial_effect_component.h>
 #include "hx_curve_spatial_effect_component.generated.h"
 
@@ -69,6 +70,30 @@ public:
   UFUNCTION(BlueprintCallable, Category = "Haptic Effects")
   void setOutputForceScale(float output_force_scale);
 
+  //! Get the value of #curve_table_resolution_.
+  //!
+  //! @returns The value of #curve_table_resolution_.
+
+  // Get the value of Curve Table Resolution.
+  UFUNCTION(BlueprintCallable, Category = "Haptic Effects")
+  int32 getCurveTableResolution() const;
+
+  //! Set the value of #curve_table_resolution_, baking #force_curve_ again.
+  //!
+  //! @param curve_table_resolution The new value for #curve_table_resolution_.
+
+  // Set the value of Curve Table Resolution.
+  UFUNCTION(BlueprintCallable, Category = "Haptic Effects")
+  void setCurveTableResolution(int32 curve_table_resolution);
+
+  //! Get the largest difference between #force_curve_ and the table it's baked into.
+  //!
+  //! @returns The largest difference, in the curve's units. Zero if the curve isn't baked.
+
+  // Get the largest difference between Force Curve and the table it's baked into.
+  UFUNCTION(BlueprintCallable, Category = "Haptic Effects")
+  float getCurveTableMaxError() const;
+
 protected:
   //! Sets default values for this component's properties.
 
@@ -102,6 +127,17 @@ protected:
   UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Haptic Effects")
   float output_force_scale_;
 
+  //! @brief The number of samples #force_curve_ is baked into for evaluation.
+  //!
+  //! Baked curves are linearly interpolated between uniformly spaced samples, which is much
+  //! cheaper than evaluating the curve's keys. Values less than 2 evaluate the curve directly.
+
+  // The number of samples Force Curve is baked into for evaluation. Values less than 2 evaluate the
+  // curve directly.
+  UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Haptic Effects",
+      meta = (ClampMin = "0", UIMin = "0"))
+  int32 curve_table_resolution_;
+
 private:
   //! Updates values internally so that scaling time works as expected.
 
@@ -118,4 +154,8 @@ private:
   //! The largest time value present in the curve.
 
   float max_time_s_;
+
+  //! #force_curve_ baked for evaluation.
+
+  HxCurveTable curve_table_;
 };
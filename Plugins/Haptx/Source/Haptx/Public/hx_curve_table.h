@@ -0,0 +1,118 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#pragma once
+
+#include <Runtime/Core/Public/CoreMinimal.h>
+#include <Runtime/Engine/Classes/Curves/CurveFloat.h>
+
+//! @brief A UCurveFloat baked into a uniformly sampled table.
+//!
+//! UCurveFloat::GetFloatValue() searches the curve's keys and interpolates between them on every
+//! call. Effects that evaluate their curve for every contact of every tactor each frame instead
+//! bake it once over the range of its keys and linearly interpolate between samples, which needs
+//! neither a search nor a branch. How far the table strays from the curve is measured when baking
+//! and reported by getMaxError().
+//!
+//! Curves that extrapolate past their keys by anything other than holding their end values can't
+//! be baked, and neither can curves without keys.
+//!
+//! In the editor the table watches the curve it baked and fires a callback when it's edited, so
+//! its owner can bake it again.
+class HAPTX_API HxCurveTable {
+ public:
+  //! Default constructor.
+  HxCurveTable();
+
+  //! Stops watching the baked curve.
+  ~HxCurveTable();
+
+  //! Tables aren't copyable since they're bound to the curve they watch.
+  HxCurveTable(const HxCurveTable&) = delete;
+
+  //! Tables aren't copyable since they're bound to the curve they watch.
+  HxCurveTable& operator=(const HxCurveTable&) = delete;
+
+  //! Bakes a curve, replacing whatever was baked before.
+  //!
+  //! @param curve The curve to bake.
+  //! @param resolution The number of samples to take. Values less than 2 disable baking.
+  //! @param on_curve_edited Called in the editor when @p curve is edited.
+  //!
+  //! @returns Whether the curve was baked.
+  bool bake(UCurveFloat* curve, int32 resolution,
+      FSimpleDelegate on_curve_edited = FSimpleDelegate());
+
+  //! Empties the table and stops watching the baked curve.
+  void reset();
+
+  //! Whether a curve is baked.
+  //!
+  //! @returns Whether a curve is baked.
+  bool isBaked() const;
+
+  //! Gets the largest difference between the table and the curve it was baked from, in the
+  //! curve's units. Zero if nothing is baked.
+  //!
+  //! @returns The largest difference between the table and its curve.
+  float getMaxError() const;
+
+  //! Evaluates the table. Only valid if isBaked().
+  //!
+  //! @param time The time to evaluate at. Clamped to the range of the curve's keys.
+  //!
+  //! @returns The interpolated value.
+  FORCEINLINE float evaluate(float time) const {
+    const float* values = values_.GetData();
+    const float index = FMath::Clamp((time - min_time_) * samples_per_time_, 0.0f, max_index_);
+    const int32 i = FMath::Min(FMath::TruncToInt(index), values_.Num() - 2);
+    return FMath::Lerp(values[i], values[i + 1], index - static_cast<float>(i));
+  }
+
+ private:
+  //! Measures how far the table strays from a curve.
+  //!
+  //! @param curve The curve the table was baked from.
+  //!
+  //! @returns The largest difference between the table and @p curve.
+  float measureMaxError(const UCurveFloat* curve) const;
+
+#if WITH_EDITOR
+  //! Starts watching a curve for edits, and stops watching the previous one.
+  //!
+  //! @param curve The curve to watch. Nullptr to stop watching.
+  //! @param on_curve_edited Called when @p curve is edited.
+  void watchCurve(UCurveFloat* curve, FSimpleDelegate on_curve_edited);
+
+  //! Called when the watched curve is edited.
+  //!
+  //! @param curve The curve.
+  //! @param change_type How it changed.
+  void onCurveUpdated(UCurveBase* curve, EPropertyChangeType::Type change_type);
+
+  //! The curve being watched for edits.
+  TWeakObjectPtr<UCurveFloat> watched_curve_;
+
+  //! Handle of the binding to #watched_curve_.
+  FDelegateHandle watched_curve_handle_;
+
+  //! Called when #watched_curve_ is edited.
+  FSimpleDelegate on_curve_edited_;
+#endif
+
+  //! Uniformly spaced samples of the curve, starting at #min_time_.
+  TArray<float> values_;
+
+  //! The time of the first sample.
+  float min_time_;
+
+  //! The number of samples per unit of time.
+  float samples_per_time_;
+
+  //! The index of the last sample.
+  float max_index_;
+
+  //! The largest difference between the table and the curve it was baked from.
+  float max_error_;
+};
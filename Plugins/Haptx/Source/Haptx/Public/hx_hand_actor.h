@@ -15,6 +15,7 @@
 #include <Haptx/Public/hx_core_actor.h>
 #include <Haptx/Public/hx_hand_actor_structs.h>
 #include <Haptx/Public/hx_patch_socket.h>
+#include <Haptx/Public/hx_patch_trace_origins.h>
 #include <Haptx/Public/peripheral_link.h>
 #include "hx_hand_actor.generated.h"
 
@@ -35,6 +36,13 @@ class HAPTX_API AHxHandActor : public ASkeletalMeshActor, public IPeripheralLink
     public IHxPatchSocket {
   GENERATED_UCLASS_BODY()
 
+  // Spawns scripted hands of both handednesses.
+  friend class UHxScaleBenchmarkCommandlet;
+  // Spawns and poses kinematic hands during replay playback.
+  friend class AHxReplayActor;
+  // Flushes buffered contacts before updating the contact interpreter and grasp detector.
+  friend class AHxCoreActor;
+
 public:
   //! Returns the properties used for network replication. This needs to be overridden by all actor
   //! classes with native replicated properties.
@@ -43,6 +51,20 @@ public:
   virtual void GetLifetimeReplicatedProps(
       TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+  //! Checks whether this actor is relevant to a given connection.
+  //!
+  //! While a physics state multicast is being sent this also applies the physics state interest
+  //! management settings (see #physics_state_full_rate_distance_cm_) so that unreliable physics
+  //! state only reaches the connections that need it.
+  //!
+  //! @param RealViewer The player controller of the connection being considered.
+  //! @param ViewTarget The actor the connection is viewing through.
+  //! @param SrcLocation The view location of the connection.
+  //!
+  //! @returns Whether this actor is relevant to the connection.
+  virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget,
+      const FVector& SrcLocation) const override;
+
   //! Called whenever a component has new physics data.
   //!
   //! @param component The component with new physics data.
@@ -51,6 +73,11 @@ public:
   //! Called when the game starts.
   virtual void BeginPlay() override;
 
+  //! Called when the game ends.
+  //!
+  //! @param EndPlayReason Why EndPlay() was called.
+  virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
   //! Called every frame pre-physics.
   //!
   //! @param DeltaTime The time since the last tick.
@@ -88,7 +115,10 @@ public:
       UPrimitiveComponent* OtherComp, bool bSelfMoved, FVector HitLocation, FVector HitNormal,
       FVector NormalImpulse, const FHitResult& Hit) override;
 
-  //! Get the name of the currently loaded user profile.
+  //! @brief Get the name of the currently loaded user profile.
+  //!
+  //! This and the other user profile getters read from HxUserProfileService's cache, and start
+  //! loading the profile if it hasn't been already.
   //!
   //! @returns The name of the currently loaded user profile, or "No user profile loaded"
 
@@ -142,6 +172,15 @@ public:
   UFUNCTION(BlueprintCallable)
   static AHxHandActor* getRightHand();
 
+  //! @brief Sets the tracked pose and simulated gesture of a hand with #scripted_input_ enabled.
+  //!
+  //! Takes the place of tracking and controller input until called again.
+  //!
+  //! @param w_mcp3 The world transform of the MCP3 joint.
+  //! @param gesture The simulated gesture to animate.
+  //! @param trigger_value How far through @p gesture to animate [0, 1].
+  void setScriptedInput(const FTransform& w_mcp3, HaptxApi::Gesture gesture, float trigger_value);
+
   //! Gets whether this hand is controlled by the local player.
   //!
   //! @returns True if this hand is controlled by the local player.
@@ -428,6 +467,16 @@ public:
   UPROPERTY(EditAnywhere, meta = (ClampMin = "0.0", UIMin = "0.0"))
   float simulated_animation_aggressiveness_1_s;
 
+  //! @brief Whether this hand is driven by setScriptedInput() instead of tracking hardware.
+  //!
+  //! Scripted hands always use simulated peripherals and don't count as duplicates of other hands,
+  //! so any number of them can share a world.
+
+  // Whether this hand is driven by setScriptedInput() instead of tracking hardware. Scripted hands
+  // always use simulated peripherals and don't count as duplicates of other hands.
+  UPROPERTY(EditAnywhere, AdvancedDisplay)
+  bool scripted_input_;
+
   //! This inline flag toggles force feedback visualization.
 
   // This inline flag toggles force feedback visualization.
@@ -530,6 +579,124 @@ protected:
   UPROPERTY(EditAnywhere, meta = (ClampMin = "0", UIMin = "0", ClampMax = "1", UIMax = "1"))
   float physics_authority_zone_radius_hysteresis_;
 
+  //! @brief Connections viewing this hand from within this distance [cm] receive physics state
+  //! at the full transmission frequency.
+  //!
+  //! Connections further away, or that can't see the hand, receive physics state at a rate
+  //! reduced by #physics_state_reduced_rate_divisor_. Connections whose hands share an object with
+  //! this hand's physics authority zone always receive physics state at the full rate.
+
+  // Connections viewing this hand from within this distance [cm] receive physics state at the full
+  // transmission frequency.
+  UPROPERTY(EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+  float physics_state_full_rate_distance_cm_;
+
+  //! @brief Connections viewing this hand from beyond this distance [cm] receive no physics state
+  //! at all.
+  //!
+  //! A value of 0 disables distance culling.
+
+  // Connections viewing this hand from beyond this distance [cm] receive no physics state at all. A
+  // value of 0 disables distance culling.
+  UPROPERTY(EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+  float physics_state_cull_distance_cm_;
+
+  //! @brief The factor by which physics state transmission frequency is divided for connections
+  //! that are far away from this hand or can't see it.
+  //!
+  //! A value of 1 sends physics state to every relevant connection at the full rate.
+
+  // The factor by which physics state transmission frequency is divided for connections that are
+  // far away from this hand or can't see it.
+  UPROPERTY(EditAnywhere, meta = (ClampMin = "1", UIMin = "1"))
+  int32 physics_state_reduced_rate_divisor_;
+
+  //! Whether connections that aren't looking at this hand receive physics state at a reduced rate.
+
+  // Whether connections that aren't looking at this hand receive physics state at a reduced rate.
+  UPROPERTY(EditAnywhere)
+  bool physics_state_view_culling_;
+
+  //! The angle [deg] added to each connection's half field of view when deciding whether it can
+  //! see this hand.
+
+  // The angle [deg] added to each connection's half field of view when deciding whether it can see
+  // this hand.
+  UPROPERTY(EditAnywhere, meta = (ClampMin = "0", UIMin = "0", ClampMax = "180", UIMax = "180",
+      editcondition = "physics_state_view_culling_"))
+  float physics_state_view_margin_deg_;
+
+  //! @brief Whether remote hands that are far away or off-screen stop simulating physics.
+  //!
+  //! While in this state the hand's bodies are kinematic and simply play back the physics state
+  //! received over the network. Full simulation resumes as soon as the hand comes within
+  //! #physics_lod_interaction_radius_cm_ of a local hand, or its physics authority zone shares an
+  //! object or overlaps with another player's.
+
+  // Whether remote hands that are far away or off-screen stop simulating physics and play back
+  // replicated physics state kinematically instead.
+  UPROPERTY(EditAnywhere)
+  bool physics_lod_enabled_;
+
+  //! @brief Remote hands further than this distance [cm] from the local view stop simulating
+  //! physics.
+  //!
+  //! A value of 0 disables distance based physics LOD.
+
+  // Remote hands further than this distance [cm] from the local view stop simulating physics. A
+  // value of 0 disables distance based physics LOD.
+  UPROPERTY(EditAnywhere, meta = (ClampMin = "0", UIMin = "0",
+      editcondition = "physics_lod_enabled_"))
+  float physics_lod_distance_cm_;
+
+  //! Whether remote hands that haven't been rendered recently stop simulating physics.
+
+  // Whether remote hands that haven't been rendered recently stop simulating physics.
+  UPROPERTY(EditAnywhere, meta = (editcondition = "physics_lod_enabled_"))
+  bool physics_lod_off_screen_;
+
+  //! Remote hands within this distance [cm] of a local hand always simulate physics.
+
+  // Remote hands within this distance [cm] of a local hand always simulate physics.
+  UPROPERTY(EditAnywhere, meta = (ClampMin = "0", UIMin = "0",
+      editcondition = "physics_lod_enabled_"))
+  float physics_lod_interaction_radius_cm_;
+
+  //! @brief The fraction by which #physics_lod_distance_cm_ shrinks or grows depending on whether
+  //! the hand is currently simulating.
+  //!
+  //! This prevents hands near the threshold from switching back and forth every frame.
+
+  // The fraction by which the physics LOD distance shrinks or grows depending on whether the hand
+  // is currently simulating. This prevents hands near the threshold from switching back and forth
+  // every frame.
+  UPROPERTY(EditAnywhere, meta = (ClampMin = "0", UIMin = "0", ClampMax = "1", UIMax = "1",
+      editcondition = "physics_lod_enabled_"))
+  float physics_lod_hysteresis_;
+
+  //! @brief How much hand and object pose history [s] the server keeps so it can rewind to a
+  //! client's timestamp when validating that client's contacts and grasps.
+  //!
+  //! When two players hold the same object, the grasp that began earliest on the server's
+  //! timeline keeps it, and the other client's state for that object is no longer forwarded.
+  //! Claims whose timestamps fall outside this history are rejected. The history is sized at
+  //! BeginPlay from this and #physics_state_transmission_frequency_hz_, up to 1024 frames. A
+  //! value of 0 disables server-side grasp validation.
+
+  // How much hand and object pose history [s] the server keeps so it can rewind to a client's
+  // timestamp when validating that client's contacts and grasps. A value of 0 disables server-side
+  // grasp validation.
+  UPROPERTY(EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+  float rewind_history_duration_s_;
+
+  //! How far [cm] a client's reported position of a contested object may be from the server's
+  //! rewound position before that client's claim on the object is rejected.
+
+  // How far [cm] a client's reported position of a contested object may be from the server's
+  // rewound position before that client's claim on the object is rejected.
+  UPROPERTY(EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+  float rewind_pose_tolerance_cm_;
+
   //! The mesh to use if this is a female left hand.
 
   // The mesh to use if this is a female left hand.
@@ -590,6 +757,24 @@ protected:
   UPROPERTY(EditAnywhere, BlueprintReadOnly, AdvancedDisplay)
   UStaticMesh* male_right_hand_static_mesh_;
 
+  //! @brief Patch trace origins baked ahead of time.
+  //!
+  //! Patches with an entry for their configuration and scale skip computing trace origins
+  //! against the static mesh when the hand spawns or changes scale. See UHxPatchTraceOrigins.
+
+  // Patch trace origins baked ahead of time.
+  UPROPERTY(EditAnywhere, BlueprintReadOnly, AdvancedDisplay)
+  UHxPatchTraceOrigins* trace_origins_asset_;
+
+  //! @brief Whether patches add the trace origins they compute to #trace_origins_asset_.
+  //!
+  //! Only applies in the editor. Save #trace_origins_asset_ afterward to keep them.
+
+  // Whether patches add the trace origins they compute to the trace origins asset. Only applies
+  // in the editor.
+  UPROPERTY(EditAnywhere, BlueprintReadOnly, AdvancedDisplay)
+  bool bake_trace_origins_;
+
   //! The material to use on the female hand for light skin.
 
   // The material to use on the female hand for light skin.
@@ -789,11 +974,42 @@ private:
   UFUNCTION(NetMulticast, Unreliable, WithValidation)
   void multicastUpdatePhysicsState(float time_s, const FHandPhysicsState& state);
 
+  //! Sends hand physics state to the server and all clients it's relevant to according to the
+  //! physics state interest management settings.
+  //!
+  //! @param time_s The world time that the state was generated.
+  //! @param state The hand physics state being sent.
+  void sendPhysicsStateToRelevantConnections(float time_s, const FHandPhysicsState& state);
+
+  //! Whether a connection should receive a given physics state multicast.
+  //!
+  //! @param real_viewer The player controller of the connection being considered.
+  //! @param w_view_location_cm The view location of the connection.
+  //!
+  //! @returns Whether the connection should receive the physics state multicast.
+  bool isPhysicsStateRelevantFor(const AActor* real_viewer,
+      const FVector& w_view_location_cm) const;
+
   //! Updates replicated constraints to match given constraint states.
   //!
   //! @param states The new constraint states to use.
   void updateReplicatedConstraints(const TArray<FConstraintPhysicsState>& states);
 
+  //! Switches this hand between full physics simulation and kinematic playback of replicated
+  //! physics state according to the physics LOD settings (see #physics_lod_enabled_).
+  void updatePhysicsLod();
+
+  //! Whether this hand is close enough to local players to need full physics simulation
+  //! regardless of physics LOD.
+  //!
+  //! @returns True if this hand might be interacting with local players.
+  bool isPhysicsLodInteracting() const;
+
+  //! Makes this hand's bodies kinematic or simulated.
+  //!
+  //! @param kinematic Whether the hand should be kinematic.
+  void setPhysicsLodKinematic(bool kinematic);
+
   //! Teleports the hand to a new world position and orientation.
   //!
   //! @param w_position_cm The new world position.
@@ -820,19 +1036,39 @@ private:
   //! Configure the constraint driving the hand in the level.
   void initPalmConstraint();
 
-  //! @brief Create a constraint between the given object and the palm that dampens the object's
+  //! @brief Get a constraint between the given object and the palm that dampens the object's
   //! motion.
   //!
-  //! The intent is to make the object easier to hold.
+  //! The intent is to make the object easier to hold. Constraints are taken from
+  //! #damping_constraint_pool_ when possible and only created if the pool is empty.
   //!
   //! @param other_comp The component whose motion to damp.
   //! @param other_bone The bone whose motion to damp.
   //!
-  //! @returns The new constraint.
-  UPhysicsConstraintComponent* createContactDampingConstraint(UPrimitiveComponent* other_comp,
+  //! @returns The constraint, now targeting the given object.
+  UPhysicsConstraintComponent* acquireContactDampingConstraint(UPrimitiveComponent* other_comp,
       FName other_bone);
 
-  //! Called when #PhysicsAuthorityZone begins overlapping another physical component.
+  //! Breaks a contact damping constraint and returns it to #damping_constraint_pool_.
+  //!
+  //! @param constraint The constraint to release.
+  void releaseContactDampingConstraint(UPhysicsConstraintComponent* constraint);
+
+  //! @brief Checks whether a line segment passes through any body that can engage contact
+  //! damping.
+  //!
+  //! Tests against the cached bounds of each body rather than querying the physics scene.
+  //!
+  //! @param w_begin_cm The beginning of the segment.
+  //! @param w_end_cm The end of the segment.
+  //! @param [out] w_hit_cm Where the segment first enters a body, if it does.
+  //!
+  //! @returns Whether the segment passes through any body that can engage contact damping.
+  bool segmentIntersectsContactDampingBodies(const FVector& w_begin_cm, const FVector& w_end_cm,
+      FVector& w_hit_cm);
+
+  //! Called when #PhysicsAuthorityZone begins overlapping another physical component. The event
+  //! is queued for processPhysicsAuthorityZoneOverlaps().
   //!
   //! @param overlapped_component The component on this actor that overlapped.
   //! @param other_actor The other actor being overlapped.
@@ -845,7 +1081,8 @@ private:
       AActor* other_actor, UPrimitiveComponent* other_comp, int32 other_body_index,
       bool from_sweep, const FHitResult& sweep_result);
 
-  //! Called when #PhysicsAuthorityZone stops overlapping another physical component.
+  //! Called when #PhysicsAuthorityZone stops overlapping another physical component. The event
+  //! is queued for processPhysicsAuthorityZoneOverlaps().
   //!
   //! @param overlapped_component The component on this actor that overlapped.
   //! @param other_actor The other actor being overlapped.
@@ -855,6 +1092,26 @@ private:
   void onPhysicsAuthorityZoneEndOverlap(UPrimitiveComponent* overlapped_component,
       AActor* other_actor, UPrimitiveComponent* other_comp, int32 other_body_index);
 
+  //! @brief Applies every physics authority zone overlap event queued since the last call, for all
+  //! hands at once.
+  //!
+  //! Events are coalesced into one net change per hand and component, so overlaps that begin and
+  //! end within a frame cancel out. Movement replication is then toggled in bulk on the affected
+  //! components and physics authority is re-arbitrated across all pawns. Only runs once per
+  //! frame no matter how many hands call it.
+  static void processPhysicsAuthorityZoneOverlaps();
+
+  //! Applies a net change in overlap between #PhysicsAuthorityZone and another component.
+  //!
+  //! @param other_comp The other component.
+  //! @param delta The net change in overlap count.
+  //! @param [out] comps_to_update Objects whose movement replication may need toggled, mapped to
+  //! whether a client hand changed them.
+  //!
+  //! @returns Whether any overlap state changed.
+  bool applyPhysicsAuthorityZoneOverlap(UPrimitiveComponent* other_comp, int delta,
+      TMap<UPrimitiveComponent*, bool>& comps_to_update);
+
   //! Evaluates whether the client should have physics authority. Should only be called by the
   //! server.
   UFUNCTION(Server, Reliable, WithValidation)
@@ -863,10 +1120,15 @@ private:
   //! Whether this hand currently has physics authority.
   bool isPhysicsAuthority() const;
 
-  //! Gets the physics states of all objects in our physics authority zone.
+  //! @brief Gets the physics states of all bodies in the hand and all objects in our physics
+  //! authority zone.
+  //!
+  //! All states are read in a single batch.
   //!
+  //! @param [out] w_body_states Populated with the states of the hand's bodies.
   //! @param [out] object_states Populated with object states.
-  void getPhysicsStatesOfObjectsInAuthorityZone(TArray<FObjectPhysicsState>& object_states);
+  void getPhysicsStates(TArray<FRigidBodyState>& w_body_states,
+      TArray<FObjectPhysicsState>& object_states);
 
   //! Gets the states of all constraints managed by the hand when it has physics authority.
   //!
@@ -913,6 +1175,21 @@ private:
   UPROPERTY()
   TMap<int64, UPhysicsConstraintComponent*> damping_constraint_from_object_id_;
 
+  //! Contact damping constraints that are not currently in use.
+  UPROPERTY()
+  TArray<UPhysicsConstraintComponent*> damping_constraint_pool_;
+
+  //! The body indices of all bones that can engage contact damping.
+  TArray<int32> contact_damping_body_indices_;
+
+  //! The unscaled world transforms of the bodies in #contact_damping_body_indices_ this frame.
+  //! Empty until first needed each frame.
+  TArray<FTransform> contact_damping_w_body_transforms_;
+
+  //! The bounds of the bodies in #contact_damping_body_indices_ at their current scale in their
+  //! unscaled frames [cm]. Filled alongside #contact_damping_w_body_transforms_.
+  TArray<FBox> contact_damping_l_body_bounds_cm_;
+
   //! The magnitude of the palm's compound bounding box extents.
   float palm_extent_;
 
@@ -948,14 +1225,25 @@ private:
   UPROPERTY()
   TMap<UPrimitiveComponent*, int> objects_in_physics_authority_zone_;
 
-  //! Components that have just had their movement replication paused and thus need their
-  //! replication targets cleared ASAP.
-  UPROPERTY()
-  TSet<UPrimitiveComponent*> comps_that_need_replication_targets_removed_;
-
   //! How many other physics authority zones are currently being overlapped.
   int num_physics_authority_zone_overlaps_;
 
+  //! Whether physics authority needs to be re-evaluated on the server.
+  bool physics_authority_needs_update_;
+
+  //! The physics authority mode physics authority was last evaluated in.
+  EPhysicsAuthorityMode physics_authority_mode_evaluated_;
+
+  //! Physics authority zone overlap events from all hands waiting for
+  //! processPhysicsAuthorityZoneOverlaps().
+  static TArray<HxPhysicsAuthorityZoneOverlap> pending_physics_authority_zone_overlaps_;
+
+  //! The frame processPhysicsAuthorityZoneOverlaps() last ran on.
+  static uint64 physics_authority_zone_overlaps_frame_;
+
+  //! All hands participating in physics authority arbitration.
+  static TArray<TWeakObjectPtr<AHxHandActor>> physics_authority_hands_;
+
   //! @brief A static map tracking global, inter-hand data about objects that are in at least one
   //! physics authority zone.
   //!
@@ -993,10 +1281,99 @@ private:
   //! game).
   float time_of_last_physics_transmission_s_;
 
+  //! The number of physics state multicasts this hand has sent. Used to stagger reduced rate
+  //! transmissions across connections.
+  uint32 physics_state_multicast_count_;
+
+  //! True while #multicastUpdatePhysicsState() is being sent so IsNetRelevantFor() can apply
+  //! physics state interest management.
+  bool is_sending_physics_state_multicast_;
+
+  //! Whether physics LOD has made this hand kinematic.
+  bool is_physics_lod_kinematic_;
+
+  //! Whether this hand was spawned by an AHxReplayActor for playback, in which case it's posed
+  //! entirely by the replay and does none of its own updates.
+  bool is_replay_puppet_;
+
+  //! Server-side history of hand and object poses used to rewind to client timestamps. Sized in
+  //! BeginPlay to cover #rewind_history_duration_s_.
+  TCircularBuffer<FHandPhysicsStateFrame> rewind_history_ =
+      TCircularBuffer<FHandPhysicsStateFrame>(1);
+
+  //! Where the next frame in #rewind_history_ will be written.
+  int rewind_history_head_i_;
+
+  //! How many frames in #rewind_history_ are valid.
+  int rewind_history_num_;
+
+  //! The last time a frame was added to #rewind_history_.
+  float time_of_last_rewind_record_s_;
+
+  //! The client timestamp at which this hand first reported holding each object it currently
+  //! reports holding [s].
+  TMap<UPrimitiveComponent*, float> rewind_claim_start_time_s_from_comp_;
+
+  //! Objects this hand's client has been told to let go of.
+  TSet<UPrimitiveComponent*> rewind_rejected_comps_;
+
+  //! Objects clients report holding mapped to the hand the server has given them to.
+  static TMap<UPrimitiveComponent*, HxGraspClaim> grasp_claim_from_comp_;
+
+  //! Adds the current hand and object poses to #rewind_history_. Server only.
+  //!
+  //! @param time_s The current server world time.
+  void recordRewindHistory(float time_s);
+
+  //! Reconstructs hand and object poses at a past time from #rewind_history_.
+  //!
+  //! @param time_s The time to rewind to.
+  //! @param [out] state Populated with the interpolated poses.
+  //!
+  //! @returns False if @p time_s is older than the history that has been kept.
+  bool rewindPhysicsState(float time_s, FHandPhysicsState& state) const;
+
+  //! @brief Arbitrates the objects a client reports holding against other players' claims.
+  //!
+  //! Competing claims are resolved in favor of the grasp that began earliest, and a challenger's
+  //! contact with the object is validated against the server's poses rewound to @p time_s.
+  //!
+  //! @param time_s The client timestamp of @p state.
+  //! @param state The physics state received from the client.
+  //! @param [out] rejected_comps Populated with the objects whose state shouldn't be forwarded.
+  void arbitrateGraspClaims(float time_s, const FHandPhysicsState& state,
+      TSet<UPrimitiveComponent*>& rejected_comps);
+
+  //! Whether the server agrees with a client about an object at a rewound time.
+  //!
+  //! @param object The object in question.
+  //! @param state The physics state received from the client.
+  //! @param rewound_state The server's poses at the same time.
+  //!
+  //! @returns True if the object was in this hand's physics authority zone and every reported
+  //! body is within #rewind_pose_tolerance_cm_ of the server's pose.
+  bool isObjectStateConsistent(UPrimitiveComponent* object, const FHandPhysicsState& state,
+      const FHandPhysicsState& rewound_state) const;
+
+  //! Tells this hand's client to let go of an object, if it hasn't been told already.
+  //!
+  //! @param object The object to let go of.
+  void rejectGraspClaim(UPrimitiveComponent* object);
+
+  //! Physically disables local constraints between the hand and an object another player has
+  //! been given.
+  //!
+  //! @param object The object to let go of.
+  UFUNCTION(Client, Reliable)
+  void clientRejectGraspClaim(UPrimitiveComponent* object);
+
   //! The effective world time from the simulation on the other end of the network that we're using
   //! to interpolate values.
   float follow_time_s_;
 
+  //! Reused storage for reading and writing physics state in a single batch.
+  RigidBodyStateBatch physics_state_batch_;
+
   //! Cached to prevent floating point loss.
   float physics_authority_zone_radius_enlarged_cm_;
 
@@ -1008,7 +1385,9 @@ private:
   //! @param delta_time The time [s] since the last hand animation update.
   void updateHandAnimation(float delta_time);
 
-  //! Load the correctly-sized hand mesh based on configuration and user profile settings.
+  //! @brief Load the correctly-sized hand mesh based on configuration and user profile settings.
+  //!
+  //! Uses the profile cached by HxUserProfileService, and is called again whenever it changes.
   void loadUserProfile();
 
   //! Updates the server with information derived from a user hand profile.
@@ -1058,6 +1437,16 @@ private:
   //! Draw contact damping visualization for one frame.
   void visualizeContactDamping();
 
+  //! Sends all contacts accumulated since the last call to the HaptxApi::ContactInterpreter and
+  //! HaptxApi::GraspDetector, and engages contact damping where appropriate.
+  void flushContacts();
+
+  //! Engages contact damping on an object if the hand is below it.
+  //!
+  //! @param contact The accumulated contact with the object.
+  //! @param other_inst The body instance of the object.
+  void tryEngageContactDamping(const HxHandActorContact& contact, FBodyInstance* other_inst);
+
   //! Draw mocap data in VR.
   //!
   //! @param mocap_frame The mocap data to draw.
@@ -1081,7 +1470,8 @@ private:
   //! @returns True if the displacement visualizer was successfully initialized.
   bool initializeDisplacementVisualizer();
 
-  //! Updates the displacement visualizer with the most recent bone displacements.
+  //! Writes the most recent physics targets to the displacement visualizer's pose and updates
+  //! its opacity, no faster than FDisplacementVisualizationParameters::update_rate_hz.
   //!
   //! @param delta_time_s Frame time.
   void updateDisplacementVisualizer(float delta_time_s);
@@ -1100,15 +1490,52 @@ private:
   UPROPERTY()
   UMaterialInstanceDynamic* dis_vis_mat_inst_;
 
+  //! The displacement visualizer's bone index for each hand joint, or INDEX_NONE if the joint
+  //! isn't visualized. Cached in initializeDisplacementVisualizer().
+  int32 dis_vis_joint_bone_indices_[HaptxApi::F_LAST][HaptxApi::FJ_LAST];
+
+  //! The constraint frame rotation of each hand joint that physics targets are relative to.
+  //! Cached in initializeDisplacementVisualizer().
+  FQuat dis_vis_joint_base_rotations_[HaptxApi::F_LAST][HaptxApi::FJ_LAST];
+
+  //! The displacement visualizer's palm bone index.
+  int32 dis_vis_palm_bone_index_;
+
+  //! The most recent physics targets, written to the displacement visualizer's pose at its own
+  //! update rate.
+  FHandPhysicsTargets dis_vis_targets_;
+
+  //! Whether #dis_vis_targets_ has changed since it was last written to the pose.
+  bool dis_vis_targets_dirty_;
+
+  //! Time accumulated since the displacement visualizer last updated [s].
+  float dis_vis_time_since_update_s_;
+
   //! Try to connect to the AHxCoreActor and disable ourselves if we fail.
   //!
   //! @returns Whether the AHxCoreActor is connected.
   bool connectToCore();
 
-  //! Builds #bone_data_from_bone_name_, registering bones with the CI and GD as necessary. Must
+  //! Builds #bone_data_from_body_index_, registering bones with the CI and GD as necessary. Must
   //! be called immediately after physics has initialized.
   void registerBones();
 
+  //! Gets the information associated with one of the hand's bodies.
+  //!
+  //! @param body_index The index of the body in the skeletal mesh component.
+  //!
+  //! @returns The information associated with the body, or nullptr if it isn't registered.
+  FHxHandActorBoneData* getBoneData(int32 body_index);
+
+  //! Gets the information associated with one of the hand's bones by name.
+  //!
+  //! Prefer getBoneData(int32) whenever a body index is available.
+  //!
+  //! @param bone_name The name of the bone.
+  //!
+  //! @returns The information associated with the bone, or nullptr if it isn't registered.
+  FHxHandActorBoneData* getBoneData(FName bone_name);
+
   //! Register retractuators on this hand's peripheral with the HaptxApi::ContactInterpreter.
   void registerRetractuators();
 
@@ -1137,8 +1564,16 @@ private:
   //! The HaptxApi::GraspDetector body ID referring to the hand as a whole.
   int64_t whole_hand_gd_body_id_;
 
-  //! Mapping from bone name to extra information associated with said bone.
-  TMap<FName, FHxHandActorBoneData> bone_data_from_bone_name_;
+  //! Extra information associated with each of the hand's bodies, indexed by the body's index in
+  //! the skeletal mesh component.
+  TArray<FHxHandActorBoneData> bone_data_from_body_index_;
+
+  //! Hits accumulated since the last call to flushContacts().
+  TArray<HxHandActorContact> contacts_;
+
+  //! Mapping from (hand body index, other component, other bone) to the matching index in
+  //! #contacts_.
+  TMap<TTuple<int32, const UPrimitiveComponent*, FName>, int32> contact_index_from_key_;
 
   //! Reference to the AHxCoreActor pseudo-singleton.
   UPROPERTY()
@@ -1150,6 +1585,12 @@ private:
   //! The last anim frame we used (if simulating hand animation).
   HaptxApi::AnimFrame last_simulated_anim_frame_;
 
+  //! The MCP3 transform most recently given to setScriptedInput().
+  FTransform scripted_w_mcp3_;
+
+  //! The trigger value most recently given to setScriptedInput().
+  float scripted_trigger_value_;
+
   //! The mocap system driving the fingers on this hand.
   std::weak_ptr<HaptxApi::HyleasSystem> mocap_system_;
 
@@ -1162,6 +1603,9 @@ private:
   //! The user of this hand.
   HaptxApi::UserProfile user_profile_;
 
+  //! Our binding to HxUserProfileService::onUserProfileChanged().
+  FDelegateHandle user_profile_changed_handle_;
+
   //! A profile derived from the dimensions of the avatar hand. The overall size of this hand is
   //! based on the real user profile.
   HaptxApi::UserProfile avatar_profile_;
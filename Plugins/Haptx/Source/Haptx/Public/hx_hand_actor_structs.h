@@ -217,6 +217,16 @@ struct FDisplacementVisualizationParameters {
   UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (UIMin = "0.0", ClampMin = "0.0",
       UIMax = "1.0", ClampMax = "1.0"))
   float max_opacity = 0.05f;
+
+  //! @brief The rate at which the visualizer pose and opacity update [Hz].
+  //!
+  //! Independent of the physics target rate. Set to 0 to update every frame.
+
+  // The rate at which the visualizer pose and opacity update [Hz]. Set to 0 to update every
+  // frame.
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Update Rate [Hz]",
+      UIMin = "0.0", ClampMin = "0.0"))
+  float update_rate_hz = 30.0f;
 };
 
 //! The physics information about a constraint that AHxHandActor needs to synchronize interactions
@@ -244,6 +254,11 @@ struct FConstraintPhysicsState {
   //! The value for UPhysicsConstraintComponent::ConstraintInstance.
   UPROPERTY()
   FConstraintInstance_NetQuantize100 constraint_instance;
+
+  //! Whether this is a grasp constraint, as opposed to contact damping. Only grasp constraints
+  //! claim objects when the server arbitrates between players.
+  UPROPERTY()
+  bool is_grasp = false;
 };
 
 //! The physics information about an FBodyInstance that AHxHandActor needs to synchronize
@@ -412,6 +427,35 @@ struct FGlobalPhysicsAuthorityObjectData {
   TMap<const APawn*, int> physics_authority_zone_count_from_pawn;
 };
 
+class AHxHandActor;
+
+//! A change in overlap between one hand's physics authority zone and another component, queued
+//! until the next frame's overlap processing pass.
+struct HxPhysicsAuthorityZoneOverlap {
+
+  //! The hand whose physics authority zone generated the event.
+  TWeakObjectPtr<AHxHandActor> hand{nullptr};
+
+  //! The component that began or ended overlapping.
+  TWeakObjectPtr<UPrimitiveComponent> other_comp{nullptr};
+
+  //! +1 for a begin overlap event and -1 for an end overlap event.
+  int delta{0};
+};
+
+//! The hand the server has given an object to while more than one player is grasping it.
+struct HxGraspClaim {
+
+  //! The hand whose claim on the object was granted.
+  TWeakObjectPtr<AHxHandActor> hand{nullptr};
+
+  //! The client timestamp at which the hand first reported holding the object [s].
+  float start_time_s{0.0f};
+
+  //! The client timestamp at which the hand last reported holding the object [s].
+  float last_time_s{0.0f};
+};
+
 //! A custom FTickFunction so @link AHxHandActor UHxHandComponents @endlink can tick before and
 //! after physics.
 
@@ -470,6 +514,54 @@ struct FHxHandActorBoneData {
 
   //! Whether this bone can engage contact damping.
   bool can_engage_contact_damping = false;
+
+  //! Whether this bone has been registered by the hand.
+  bool is_registered = false;
+};
+
+//! All hits between one hand bone and one other body accumulated over a single frame.
+struct HxHandActorContact {
+
+  //! The index of the hand body involved in the contact.
+  int32 body_index{INDEX_NONE};
+
+  //! The hand bone involved in the contact.
+  FName bone_name{NAME_None};
+
+  //! The other component involved in the contact.
+  TWeakObjectPtr<UPrimitiveComponent> other_comp{nullptr};
+
+  //! The bone on the other component involved in the contact.
+  FName other_bone_name{NAME_None};
+
+  //! The sum of the normal impulses of all hits [kg cm/s].
+  FVector w_normal_impulse{FVector::ZeroVector};
+
+  //! The sum of all hit locations weighted by impulse magnitude [cm].
+  FVector w_weighted_location_sum_cm{FVector::ZeroVector};
+
+  //! The sum of all hit location weights.
+  float location_weight_sum{0.0f};
+
+  //! The sum of all hit locations, used if no hit carried an impulse [cm].
+  FVector w_location_sum_cm{FVector::ZeroVector};
+
+  //! The number of hits accumulated.
+  int32 num_hits{0};
+
+  //! Gets a location that represents all accumulated hits.
+  //!
+  //! @returns The impulse weighted average hit location, or the plain average if no hit carried
+  //! an impulse [cm].
+  FVector getRepresentativeLocation() const {
+    if (location_weight_sum > SMALL_NUMBER) {
+      return w_weighted_location_sum_cm / location_weight_sum;
+    } else if (num_hits > 0) {
+      return w_location_sum_cm / num_hits;
+    } else {
+      return FVector::ZeroVector;
+    }
+  }
 };
 
 //! Different ways hand animation can be optimized.
@@ -0,0 +1,123 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <Runtime/Core/Public/CoreMinimal.h>
+#include <HaptxApi/haptic_effect.h>
+
+//! @brief Evaluates the sine waves of every wave effect together.
+//!
+//! The contact interpreter queries a wave effect for every contact of every tactor it touches,
+//! and each query used to call sinf(). Instead each wave effect owns an oscillator here. Once per
+//! haptic frame advance() predicts the play time each oscillator will be queried at and evaluates
+//! all of them at once with a vectorized polynomial. Queries return the precomputed value when
+//! they're for that play time and the wave's parameters haven't changed, and evaluate and keep a
+//! new one otherwise, so a wave is evaluated at most once per distinct play time however many
+//! contacts read it. Phases are computed in double precision so that long play times and high
+//! frequencies don't lose accuracy.
+//!
+//! Values differ from sinf() by less than 1e-5 of the amplitude. Hits and misses are counted by
+//! HxBenchmarkStats while it's recording.
+//!
+//! Must only be used from the game thread.
+class HAPTX_API HxOscillatorBank {
+ public:
+  //! Adds an oscillator.
+  //!
+  //! @param effect The effect whose play time drives the oscillator.
+  //! @param frequency_Hz The frequency of the wave [Hz].
+  //! @param amplitude The amplitude of the wave.
+  //! @param phase_offset_deg The phase offset of the wave [deg].
+  //!
+  //! @returns The oscillator's index.
+  static int32 addOscillator(std::shared_ptr<HaptxApi::HapticEffect> effect, float frequency_Hz,
+      float amplitude, float phase_offset_deg);
+
+  //! Removes an oscillator so its index can be reused.
+  //!
+  //! @param oscillator The oscillator's index.
+  static void removeOscillator(int32 oscillator);
+
+  //! Evaluates every oscillator whose effect is playing at the play time it will have once it's
+  //! been advanced. Called once per haptic frame, before the contact interpreter commits.
+  //!
+  //! @param delta_time_s The time [s] effects will be advanced by this frame.
+  static void advance(float delta_time_s);
+
+  //! @brief Samples an oscillator, with the same output as evaluateSineWave() scaled by
+  //! @p amplitude.
+  //!
+  //! The wave's parameters are passed in since effects may change them at any time.
+  //!
+  //! @param oscillator The oscillator's index. If invalid the wave is evaluated directly.
+  //! @param time_s The time that the wave has been playing for [s].
+  //! @param frequency_Hz The frequency of the wave [Hz].
+  //! @param amplitude The amplitude of the wave.
+  //! @param phase_offset_deg The phase offset of the wave [deg].
+  //!
+  //! @returns A value between -amplitude and amplitude.
+  static float sample(int32 oscillator, float time_s, float frequency_Hz, float amplitude,
+      float phase_offset_deg);
+
+ private:
+  //! Hidden default constructor.
+  HxOscillatorBank();
+
+  //! Gets the phase of a wave, wrapped into [-0.5, 0.5) [rev].
+  //!
+  //! @param time_s The time that the wave has been playing for [s].
+  //! @param frequency_Hz The frequency of the wave [Hz].
+  //! @param phase_offset_deg The phase offset of the wave [deg].
+  //!
+  //! @returns The wrapped phase [rev].
+  static float getPhaseRev(float time_s, float frequency_Hz, float phase_offset_deg);
+
+  //! Folds a wrapped phase into the angle in [-pi/2, pi/2] with the same sine [rad].
+  //!
+  //! @param phase_rev A phase in [-0.5, 0.5) [rev].
+  //!
+  //! @returns The folded angle [rad].
+  static float foldPhase(float phase_rev);
+
+  //! Approximates the sine of a folded angle.
+  //!
+  //! @param angle_rad An angle in [-pi/2, pi/2] [rad].
+  //!
+  //! @returns The sine of @p angle_rad.
+  static float approximateSine(float angle_rad);
+
+  //! Approximates the sine of four folded angles.
+  //!
+  //! @param angle_rad Angles in [-pi/2, pi/2] [rad].
+  //!
+  //! @returns The sines of @p angle_rad.
+  static VectorRegister approximateSine(const VectorRegister& angle_rad);
+
+  //! The effect driving each oscillator.
+  static std::vector<std::weak_ptr<HaptxApi::HapticEffect>> effects_;
+
+  //! The frequency of each oscillator [Hz].
+  static TArray<float> frequencies_Hz_;
+
+  //! The amplitude of each oscillator.
+  static TArray<float> amplitudes_;
+
+  //! The phase offset of each oscillator [deg].
+  static TArray<float> phase_offsets_deg_;
+
+  //! The play time each oscillator was last evaluated at [s]. Negative if it has no value.
+  static TArray<float> times_s_;
+
+  //! The angle each oscillator is evaluated at in advance() [rad].
+  static TArray<float> folded_angles_rad_;
+
+  //! The value of each oscillator at #times_s_.
+  static TArray<float> values_;
+
+  //! Indices of removed oscillators available for reuse.
+  static TArray<int32> free_oscillators_;
+};
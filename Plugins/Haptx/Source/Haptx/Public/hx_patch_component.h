@@ -8,10 +8,13 @@
 #include <Runtime/Engine/Classes/Components/PrimitiveComponent.h>
 #include <Runtime/Engine/Classes/Components/SkeletalMeshComponent.h>
 #include <Runtime/Engine/Public/CollisionQueryParams.h>
+#include <Runtime/Engine/Public/WorldCollision.h>
 #include <HaptxApi/contact_interpreter.h>
 #include <Haptx/Private/haptx_shared.h>
 #include <Haptx/Public/contact_interpreter_parameters.h>
+#include <Haptx/Public/hx_analytic_trace_sampler.h>
 #include <Haptx/Public/hx_core_actor.h>
+#include <Haptx/Public/hx_patch_trace_origins.h>
 #include <Haptx/Public/hx_simulation_callbacks.h>
 #include <Haptx/Public/ihaptx.h>
 #include <Haptx/Public/peripheral_link.h>
@@ -43,6 +46,60 @@ struct FTactileFeedbackVisualizationParameters {
   float draw_offset = 3.f;
 };
 
+//! @brief The last object hit by one of a tactor's traces.
+//!
+//! Values prefixed with o_ are relative to the hit body so the hit can be reused while the tactor
+//! and the body are stationary relative to each other.
+struct HxPatchComponentTraceCache {
+
+  //! Whether the rest of this cache holds a hit.
+  bool valid{false};
+
+  //! The component that was hit.
+  TWeakObjectPtr<UPrimitiveComponent> component{};
+
+  //! The bone that was hit.
+  FName bone{NAME_None};
+
+  //! The value of GFrameCounter when the hit was traced.
+  uint64 frame{0u};
+
+  //! The value of GFrameCounter when this trace direction was last traced, whether or not it hit
+  //! anything. Unlike the rest of this cache this is always valid.
+  uint64 traced_frame{0u};
+
+  //! The value of GFrameCounter when this trace direction last reported a sample, traced or
+  //! cached. Like traced_frame this is always valid.
+  uint64 sampled_frame{0u};
+
+  //! The world position of the hit body the last time this cache was checked [cm].
+  FVector w_body_position_cm{FVector::ZeroVector};
+
+  //! The trace origin when the hit was traced [cm].
+  FVector o_origin_cm{FVector::ZeroVector};
+
+  //! The trace direction when the hit was traced.
+  FVector o_direction{FVector::ZeroVector};
+
+  //! FHitResult::Location [cm].
+  FVector o_location_cm{FVector::ZeroVector};
+
+  //! FHitResult::ImpactPoint [cm].
+  FVector o_impact_point_cm{FVector::ZeroVector};
+
+  //! FHitResult::Normal.
+  FVector o_normal{FVector::ZeroVector};
+
+  //! FHitResult::ImpactNormal.
+  FVector o_impact_normal{FVector::ZeroVector};
+
+  //! FHitResult::Distance [cm].
+  float distance_cm{0.0f};
+
+  //! FHitResult::FaceIndex.
+  int32 face_index{INDEX_NONE};
+};
+
 //! Everything a patch needs to cache about a HaptxApi::Tactor.
 struct HxPatchComponentTactorData {
   
@@ -65,6 +122,42 @@ struct HxPatchComponentTactorData {
 
   //! The trace origin relative to this component.
   FTransform l_trace_origin{FTransform::Identity};
+
+  //! The last hit of each of the tactor's trace directions.
+  TArray<HxPatchComponentTraceCache> trace_caches{};
+
+  //! The trace priority of the tactor's coverage region. See
+  //! AHxCoreActor::coverage_region_trace_priorities_.
+  float trace_priority{1.0f};
+
+  //! The value of GFrameCounter when one of the tactor's traces last hit an object, or 0 if none
+  //! have.
+  uint64 last_contact_frame{0u};
+};
+
+//! One object trace from a tactor.
+struct HxPatchComponentTrace {
+
+  //! The tactor the trace belongs to.
+  HxPatchComponentTactorData* tactor_datum{nullptr};
+
+  //! The index of the trace among the tactor's trace directions.
+  int32 direction_i{0};
+
+  //! The world position of the tactor's trace origin [cm].
+  FVector w_origin_cm{FVector::ZeroVector};
+
+  //! The world direction of the trace.
+  FVector w_direction{FVector::ZeroVector};
+
+  //! The world position where the trace starts [cm].
+  FVector w_start_cm{FVector::ZeroVector};
+
+  //! The world position where the trace ends [cm].
+  FVector w_end_cm{FVector::ZeroVector};
+
+  //! The handle of the trace if it was submitted asynchronously.
+  FTraceHandle handle{};
 };
 
 //! A custom FTickFunction so @link UHxPatchComponent UHxPatchComponents @endlink can tick 
@@ -151,7 +244,9 @@ public:
   //! Settings for this component's second tick function.
   struct FHxPatchSecondaryTickFunction SecondaryComponentTick;
 
-  //! Ignores a given actor with all ray traces.
+  //! @brief Ignores a given actor with all ray traces.
+  //!
+  //! Trace parameters are shared, so this applies to every patch on the same actor.
   //!
   //! @param actor The actor to ignore.
 
@@ -159,12 +254,37 @@ public:
   UFUNCTION(BlueprintCallable)
   void ignoreActor(AActor* actor);
 
-  //! Computes and caches trace origins for the skeletal mesh of the hand by tracing against a
-  //! static mesh representation of the hand in its base pose.
+  //! @brief Runs the traces computed this frame by each patch across worker threads and sends
+  //! their results to the HaptxApi::ContactInterpreter.
+  //!
+  //! Scene queries run in a ParallelFor under a single physics scene read lock and write into
+  //! per-trace result slots. Results are then sent serially since the contact interpreter isn't
+  //! thread safe.
+  //!
+  //! @param patches The patches whose traces to run.
+  static void traceInParallel(const TArray<TWeakObjectPtr<UHxPatchComponent>>& patches);
+
+  //! @brief Computes and caches trace origins for the skeletal mesh of the hand by tracing
+  //! against a static mesh representation of the hand in its base pose.
+  //!
+  //! If @p baked_trace_origins has entries for this patch's configuration at or around its scale
+  //! they're used instead of tracing.
   //!
   //! @param skeletal_mesh The skeletal mesh representing the physically simulated hand.
   //! @param static_mesh The static mesh version to trace against.
-  void updateTraceOrigins(USkeletalMeshComponent* skeletal_mesh, UStaticMesh* static_mesh);
+  //! @param baked_trace_origins Optional trace origins baked ahead of time.
+  //! @param bake_trace_origins Whether to add the result to @p baked_trace_origins if it had to
+  //! be traced. Only applies in the editor.
+  void updateTraceOrigins(USkeletalMeshComponent* skeletal_mesh, UStaticMesh* static_mesh,
+      UHxPatchTraceOrigins* baked_trace_origins = nullptr, bool bake_trace_origins = false);
+
+  //! Gets the key that identified this patch's configuration the last time updateTraceOrigins()
+  //! ran. Equal for patches that can share baked trace origins.
+  //!
+  //! @returns The key, or an empty string if trace origins haven't been updated.
+  const FString& getTraceOriginsKey() const {
+    return trace_origins_key_;
+  }
 
   //! The locating feature this patch gets aligned with.
 
@@ -211,7 +331,10 @@ public:
   UPROPERTY(EditAnywhere, Category = "Tracing")
   bool object_trace_complex_{true};
 
-  //! Which UV channels to query when tracing.
+  //! @brief Which UV channels to query when tracing.
+  //!
+  //! UVs are only sampled on static meshes whose UHxPhysicalMaterial sets
+  //! UHxPhysicalMaterial::sample_uvs_.
 
   // Which UV channels to query when tracing.
   UPROPERTY(EditAnywhere, Category = "Tracing")
@@ -229,6 +352,60 @@ public:
   UPROPERTY(EditAnywhere, Category = "Tracing", DisplayName = "Component Object Trace Directions")
   TArray<FVector> l_object_trace_directions_;
 
+  //! @brief Whether to skip all of this patch's object traces in frames where nothing is near
+  //! it.
+  //!
+  //! A single overlap query against a sphere bounding every trace is run first each frame.
+
+  // Whether to skip all of this patch's object traces in frames where nothing is near it.
+  UPROPERTY(EditAnywhere, Category = "Tracing")
+  bool cull_object_traces_{true};
+
+  //! @brief Whether to reuse a tactor's last hit while the tactor and the hit object barely move
+  //! relative to each other.
+  //!
+  //! Cached hits are refreshed every #trace_cache_max_frames_ frames and whenever the object
+  //! moves farther than #trace_cache_teleport_distance_cm_ in one frame.
+
+  // Whether to reuse a tactor's last hit while the tactor and the hit object barely move relative
+  // to each other.
+  UPROPERTY(EditAnywhere, Category = "Tracing")
+  bool cache_object_traces_{true};
+
+  //! How far a trace origin may move relative to the hit object before its cached hit is
+  //! discarded [cm].
+
+  // How far a trace origin may move relative to the hit object before its cached hit is
+  // discarded [cm].
+  UPROPERTY(EditAnywhere, Category = "Tracing", meta=(UIMin="0.0", ClampMin="0.0",
+      editcondition = "cache_object_traces_"))
+  float trace_cache_max_translation_cm_{0.05f};
+
+  //! How far a trace direction may rotate relative to the hit object before its cached hit is
+  //! discarded [deg].
+
+  // How far a trace direction may rotate relative to the hit object before its cached hit is
+  // discarded [deg].
+  UPROPERTY(EditAnywhere, Category = "Tracing", meta=(UIMin="0.0", ClampMin="0.0",
+      editcondition = "cache_object_traces_"))
+  float trace_cache_max_rotation_deg_{0.5f};
+
+  //! The number of frames after which a cached hit is always traced again.
+
+  // The number of frames after which a cached hit is always traced again.
+  UPROPERTY(EditAnywhere, Category = "Tracing", meta=(UIMin="1", ClampMin="1",
+      editcondition = "cache_object_traces_"))
+  int32 trace_cache_max_frames_{10};
+
+  //! How far the hit object may move in one frame before it's treated as a teleport and its
+  //! cached hits are discarded [cm].
+
+  // How far the hit object may move in one frame before it's treated as a teleport and its cached
+  // hits are discarded [cm].
+  UPROPERTY(EditAnywhere, Category = "Tracing", meta=(UIMin="0.0", ClampMin="0.0",
+      editcondition = "cache_object_traces_"))
+  float trace_cache_teleport_distance_cm_{5.0f};
+
   //! The amount by which to increment self traces if they fail [cm].
 
   // The amount by which to increment self traces if they fail [cm].
@@ -272,9 +449,105 @@ private:
   void registerTactors();
 
   //! Generates trace results and sends them to the HaptxApi::ContactInterpreter.
+  //!
+  //! When the core's async tactile traces are enabled, the results of last frame's traces are
+  //! sent and this frame's traces are submitted to the world's async trace batch.
   void updateTraces();
 
-  //! Sets raytrace blacklists and white lists.
+  //! Computes the world geometry of every object trace this frame in one pass over the trace
+  //! geometry arrays.
+  //!
+  //! @param [out] traces Populated with one trace per tactor per trace direction.
+  void computeTraces(TArray<HxPatchComponentTrace>& traces);
+
+  //! Identifies everything other than scale and static mesh geometry that determines this patch's
+  //! trace origins.
+  //!
+  //! @param skeletal_mesh The skeletal mesh representing the physically simulated hand.
+  //! @param static_mesh The static mesh version to trace against.
+  //! @param l_attach_bone The attach bone relative to the root bone in the base pose.
+  //!
+  //! @returns A hash of the patch's configuration.
+  FString makeTraceOriginsKey(USkeletalMeshComponent* skeletal_mesh, UStaticMesh* static_mesh,
+      const FTransform& l_attach_bone) const;
+
+  //! Computes trace origins by spawning @p static_mesh and self tracing against it from each
+  //! tactor.
+  //!
+  //! @param skeletal_mesh The skeletal mesh representing the physically simulated hand.
+  //! @param static_mesh The static mesh version to trace against.
+  //! @param l_attach_bone The attach bone relative to the root bone in the base pose.
+  void computeTraceOrigins(USkeletalMeshComponent* skeletal_mesh, UStaticMesh* static_mesh,
+      const FTransform& l_attach_bone);
+
+  //! Recomputes the bounds of the trace origins used for broadphase culling.
+  void updateTraceBounds();
+
+  //! Rebuilds #trace_tactors_, #l_trace_origins_cm_ and #l_tactor_trace_directions_ from
+  //! #tactor_data_.
+  void rebuildTraceGeometry();
+
+  //! Sends cached hits for any traces whose tactor and hit object haven't moved relative to each
+  //! other, and removes those traces.
+  //!
+  //! @param [in,out] traces The traces to check.
+  void resolveCachedTraces(TArray<HxPatchComponentTrace>& traces);
+
+  //! Sends a trace's cached hit if it still has one.
+  //!
+  //! @param trace The trace.
+  //! @param w_radius_cm The world radius of the trace sphere [cm].
+  //! @param require_steady Whether the tactor and the hit object must not have moved relative to
+  //! each other, and the hit must be no older than #trace_cache_max_frames_.
+  //!
+  //! @returns Whether a cached hit was sent.
+  bool tryResolveCachedTrace(const HxPatchComponentTrace& trace, float w_radius_cm,
+      bool require_steady);
+
+  //! @brief Claims as many traces as possible from the core's shared trace budget, highest
+  //! priority first, and removes the rest.
+  //!
+  //! Removed traces send their cached hit if they still have one. Does nothing if the core's
+  //! trace budget is disabled.
+  //!
+  //! @param [in,out] traces The traces to schedule.
+  void scheduleTraces(TArray<HxPatchComponentTrace>& traces);
+
+  //! Sweeps traces against the collision gathered in #analytic_trace_sampler_, sends their
+  //! results, and removes them. Does nothing if the core's analytic traces are disabled or nothing
+  //! was gathered this frame.
+  //!
+  //! @param [in,out] traces The traces to run.
+  void traceAnalytically(TArray<HxPatchComponentTrace>& traces);
+
+  //! Computes the priority of a trace for the core's shared trace budget.
+  //!
+  //! @param trace The trace.
+  //! @param w_reach_cm The world length of a trace [cm].
+  //!
+  //! @returns The trace's priority.
+  float getTracePriority(const HxPatchComponentTrace& trace, float w_reach_cm) const;
+
+  //! @brief Checks whether any object could be hit by this patch's object traces this frame.
+  //!
+  //! When the core's trace budget is enabled this also populates #w_nearby_object_bounds_, and
+  //! when its analytic traces are enabled this gathers nearby collision into
+  //! #analytic_trace_sampler_.
+  //!
+  //! @returns False if the sphere bounding every trace overlaps nothing, or true if it does or if
+  //! culling is disabled.
+  bool anyObjectsNearTraces();
+
+  //! Sends the result of an object trace to the HaptxApi::ContactInterpreter and visualizes it.
+  //!
+  //! @param trace The trace.
+  //! @param hit The trace's blocking hit, or nullptr if it didn't hit anything.
+  //! @param w_radius_cm The world radius of the trace sphere [cm].
+  //! @param is_cached Whether @p hit came from the trace's cache rather than a scene query.
+  void processTraceResult(const HxPatchComponentTrace& trace, const FHitResult* hit,
+      float w_radius_cm, bool is_cached = false);
+
+  //! Gets the object trace parameters the core shares with every patch on our owner.
   void configureTraceParameters();
 
   //! Draw tactile feedback visualization information.
@@ -288,12 +561,55 @@ private:
   //! Updates patch transform according to #locating_feature_ and #locating_feature_offset_.
   void alignWithLocatingSocket();
 
-  //! Object parameters for heightfield trace onto objects (WHITELIST).
-  TArray<TEnumAsByte<EObjectTypeQuery>> object_trace_collision_type_whitelist_;
-
-  //! Which actors to ignore during object traces (BLACKLIST).
+  //! Actors to ignore during object traces that were given before the core was connected.
   TArray<AActor*> object_trace_ignore_actors_;
 
+  //! Object type parameters for object traces. Owned by the core.
+  const FCollisionObjectQueryParams* object_trace_object_params_{nullptr};
+
+  //! Query parameters for object traces, shared by every patch on our owner.
+  TSharedPtr<const FCollisionQueryParams> object_trace_query_params_;
+
+  //! Object traces computed this frame when tracing synchronously or in parallel.
+  TArray<HxPatchComponentTrace> traces_;
+
+  //! Per-trace hit results of #traces_ when tracing in parallel.
+  TArray<FHitResult> trace_hits_;
+
+  //! Whether each of #traces_ hit anything when tracing in parallel.
+  TArray<bool> trace_is_hit_;
+
+  //! Reused to sample UVs at each hit.
+  TArray<FVector2D> uvs_;
+
+  //! Reused to send the UVs at each hit to the HaptxApi::ContactInterpreter.
+  std::vector<HaptxApi::Vector2D> uv_coordinates_;
+
+  //! The world bounds of objects found near this patch's traces this frame when the core's
+  //! trace budget is enabled.
+  TArray<FBox> w_nearby_object_bounds_;
+
+  //! Reused to find objects near this patch's traces.
+  TArray<FOverlapResult> nearby_overlaps_;
+
+  //! Sweeps traces against the simple collision of objects near this patch.
+  HxAnalyticTraceSampler analytic_trace_sampler_;
+
+  //! Whether #analytic_trace_sampler_ gathered what's near this patch's traces this frame.
+  bool analytic_traces_ready_{false};
+
+  //! Reused to hold the priority of each trace being scheduled.
+  TArray<float> trace_priorities_;
+
+  //! Reused to order traces being scheduled. Pairs of priority and trace index.
+  TArray<TPair<float, int32>> trace_schedule_;
+
+  //! Reused to hold the traces that were scheduled.
+  TArray<HxPatchComponentTrace> scheduled_traces_;
+
+  //! Object traces submitted asynchronously last frame whose results are pending.
+  TArray<HxPatchComponentTrace> pending_async_traces_;
+
   //! Reference to the AHxCoreActor pseudo-singleton.
 
   // Reference to the AHxCoreActor pseudo-singleton.
@@ -308,4 +624,35 @@ private:
 
   //! The list of tactors this patch represents.
   std::list<HxPatchComponentTactorData> tactor_data_{};
+
+  //! Whether #l_trace_bounds_center_cm_ and #l_trace_bounds_radius_cm_ are valid.
+  bool trace_bounds_valid_{false};
+
+  //! The center of a sphere bounding all valid trace origins, relative to this component [cm].
+  FVector l_trace_bounds_center_cm_{FVector::ZeroVector};
+
+  //! The radius of a sphere bounding all valid trace origins, relative to this component [cm].
+  float l_trace_bounds_radius_cm_{0.0f};
+
+  //! The number of tactors with valid trace origins.
+  int32 num_valid_trace_origins_{0};
+
+  //! The key identifying this patch's configuration in UHxPatchTraceOrigins.
+  FString trace_origins_key_{};
+
+  //! Whether the trace geometry arrays below need rebuilding from #tactor_data_.
+  bool trace_geometry_dirty_{true};
+
+  //! Tactors with valid trace origins. The trace geometry arrays below share this order.
+  TArray<HxPatchComponentTactorData*> trace_tactors_;
+
+  //! The trace origin of each of #trace_tactors_ relative to this component [cm].
+  TArray<FVector> l_trace_origins_cm_;
+
+  //! Each of #t_object_trace_directions_ for each of #trace_tactors_, normalized and relative to
+  //! this component. Indexed by tactor * #num_tactor_trace_directions_ + direction.
+  TArray<FVector> l_tactor_trace_directions_;
+
+  //! The number of tactor trace directions #l_tactor_trace_directions_ was built with.
+  int32 num_tactor_trace_directions_{0};
 };
@@ -0,0 +1,121 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#pragma once
+
+#include <Runtime/Engine/Classes/Engine/DataAsset.h>
+#include "hx_patch_trace_origins.generated.h"
+
+//! The trace origins of one patch configuration at one patch scale.
+
+// The trace origins of one patch configuration at one patch scale.
+USTRUCT()
+struct FHxPatchTraceOriginsEntry {
+  GENERATED_BODY()
+
+  //! Identifies the hand mesh, patch placement and tactor layout the origins were computed for.
+  //! See UHxPatchComponent::updateTraceOrigins().
+
+  // Identifies the hand mesh, patch placement and tactor layout the origins were computed for.
+  UPROPERTY(VisibleAnywhere, Category = "Trace Origins")
+  FString key;
+
+  //! The patch's scale relative to its attach bone when the origins were computed.
+
+  // The patch's scale relative to its attach bone when the origins were computed.
+  UPROPERTY(VisibleAnywhere, Category = "Trace Origins")
+  float patch_scale{1.0f};
+
+  //! The lighting GUID of the static hand mesh the origins were traced against, which changes
+  //! whenever the mesh is rebuilt.
+
+  // The lighting GUID of the static hand mesh the origins were traced against.
+  UPROPERTY(VisibleAnywhere, Category = "Trace Origins")
+  FGuid static_mesh_guid;
+
+  //! Whether each tactor's trace origin is valid, in tactor registration order.
+
+  // Whether each tactor's trace origin is valid, in tactor registration order.
+  UPROPERTY(VisibleAnywhere, Category = "Trace Origins")
+  TArray<bool> trace_origins_valid;
+
+  //! Each tactor's trace origin relative to the patch, in tactor registration order.
+
+  // Each tactor's trace origin relative to the patch, in tactor registration order.
+  UPROPERTY(VisibleAnywhere, Category = "Trace Origins")
+  TArray<FTransform> l_trace_origins;
+};
+
+//! @brief Patch trace origins baked ahead of time so hands don't have to compute them on spawn.
+//!
+//! Computing trace origins live spawns a static mesh copy of the hand and walks self traces out
+//! from every tactor, which stalls hand spawn and every hand scale change. Assign one of these
+//! to AHxHandActor::trace_origins_asset_ and enable AHxHandActor::bake_trace_origins_, then play
+//! in the editor at the hand scales you want covered. Each live computation is added to this
+//! asset, which then needs to be saved.
+//!
+//! User profile hand scales are continuous, so patches between two baked scales interpolate
+//! between them. Bake scales spanning the range of hands you expect, no further apart than
+//! #max_interpolation_scale_span_. Patches outside the baked range, or whose entries have gone
+//! stale because the hand mesh or patch layout changed, fall back to the live computation and
+//! log a warning. Mesh edits can only be detected in the editor since cooked meshes don't keep
+//! their lighting GUID.
+//!
+//! @ingroup group_unreal_plugin
+
+// Patch trace origins baked ahead of time so hands don't have to compute them on spawn.
+UCLASS(BlueprintType, HideCategories = Object)
+class HAPTX_API UHxPatchTraceOrigins : public UDataAsset {
+  GENERATED_UCLASS_BODY()
+
+public:
+  //! Looks up the trace origins of a patch configuration. Uses the entry at the nearest scale
+  //! within #max_scale_error_ if there is one, and otherwise interpolates between the nearest
+  //! entries on either side of @p patch_scale.
+  //!
+  //! @param key The patch configuration's key.
+  //! @param static_mesh_guid The lighting GUID of the static hand mesh.
+  //! @param patch_scale The patch's scale relative to its attach bone.
+  //! @param num_tactors The number of tactors on the patch.
+  //! @param [out] trace_origins_valid Whether each tactor's trace origin is valid.
+  //! @param [out] l_trace_origins Each tactor's trace origin relative to the patch.
+  //!
+  //! @returns Whether trace origins were found.
+  bool findTraceOrigins(const FString& key, const FGuid& static_mesh_guid, float patch_scale,
+      int32 num_tactors, TArray<bool>& trace_origins_valid,
+      TArray<FTransform>& l_trace_origins) const;
+
+  //! Adds an entry, replacing any entry for the same configuration and scale.
+  //!
+  //! @param entry The entry to add.
+  void addEntry(const FHxPatchTraceOriginsEntry& entry);
+
+  //! @brief The largest relative difference between a patch's scale and an entry's scale for
+  //! the entry to be used.
+  //!
+  //! Trace origins move with hand scale, so larger values cover more hand sizes with fewer
+  //! entries at the cost of accuracy.
+
+  // The largest relative difference between a patch's scale and an entry's scale for the entry to
+  // be used.
+  UPROPERTY(EditAnywhere, Category = "Trace Origins", meta=(UIMin="0.0", ClampMin="0.0"))
+  float max_scale_error_;
+
+  //! @brief The largest relative difference between the scales of two entries for a patch
+  //! between them to interpolate their trace origins.
+  //!
+  //! Trace origins don't move linearly with scale, so larger values cover more hand sizes with
+  //! fewer entries at the cost of accuracy.
+
+  // The largest relative difference between the scales of two entries for a patch between them to
+  // interpolate their trace origins.
+  UPROPERTY(EditAnywhere, Category = "Trace Origins", meta=(UIMin="0.0", ClampMin="0.0"))
+  float max_interpolation_scale_span_;
+
+  //! The baked entries.
+
+  // The baked entries.
+  UPROPERTY(VisibleAnywhere, Category = "Trace Origins")
+  TArray<FHxPatchTraceOriginsEntry> entries_;
+};
@@ -76,6 +76,16 @@ public:
       UIMax = "0.01"))
   float compliance_cm_cn_;
 
+  //! @brief Whether tactor traces sample texture coordinates on static meshes with this material.
+  //!
+  //! Needed by UV-driven tactile effects. Samples the channels in
+  //! UHxPatchComponent::object_trace_uv_channels_. The mesh must have "Allow CPU Access" enabled
+  //! in cooked builds. See HxCollisionUvSampler.
+
+  // Whether tactor traces sample texture coordinates on static meshes with this material.
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Contact Interpreter")
+  bool sample_uvs_;
+
   //! @brief Override the default settings for #grasping_enabled_.
   //! 
   //! Note: this property applies to rigidly grouped objects. If an object is welded, the setting
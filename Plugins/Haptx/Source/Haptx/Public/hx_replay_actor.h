@@ -0,0 +1,337 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#pragma once
+
+#include <Runtime/Engine/Classes/GameFramework/Actor.h>
+#include <Haptx/Public/hx_core_actor.h>
+#include <Haptx/Public/hx_hand_actor.h>
+#include "hx_replay_actor.generated.h"
+
+DECLARE_STATS_GROUP_IF_PROFILING(TEXT("AHxReplayActor"), STATGROUP_AHxReplayActor,
+    STATCAT_Advanced)
+
+//! The pose of one body in a replay frame.
+struct HxReplayBodyPose {
+
+  //! World position [cm].
+  FVector w_position_cm{FVector::ZeroVector};
+
+  //! World orientation.
+  FQuat w_orient{FQuat::Identity};
+};
+
+//! The state of one hand in a replay frame.
+struct HxReplayHandFrame {
+
+  //! Index into the replay's hand table.
+  int32 hand_id{INDEX_NONE};
+
+  //! The hand's physics targets.
+  FHandPhysicsTargets targets{};
+
+  //! The pose of each of the hand's bodies, in skeletal mesh body order.
+  TArray<HxReplayBodyPose> w_body_poses{};
+};
+
+//! The state of one object body in a replay frame.
+struct HxReplayObjectFrame {
+
+  //! Index into the replay's object table.
+  int32 object_id{INDEX_NONE};
+
+  //! The index of the body in the object's component.
+  int32 body_index{0};
+
+  //! The body's pose.
+  HxReplayBodyPose w_pose{};
+};
+
+//! Everything recorded at one moment of a replay.
+struct HxReplayFrame {
+
+  //! Time since recording started [s].
+  float time_s{0.0f};
+
+  //! The state of every recorded hand.
+  TArray<HxReplayHandFrame> hands{};
+
+  //! The state of every object in at least one hand's physics authority zone.
+  TArray<HxReplayObjectFrame> objects{};
+};
+
+//! A grasp or release recorded in a replay.
+struct HxReplayGraspEvent {
+
+  //! Time since recording started [s].
+  float time_s{0.0f};
+
+  //! Index into the replay's object table.
+  int32 object_id{INDEX_NONE};
+
+  //! True for a grasp, false for a release.
+  bool is_grasp{true};
+};
+
+//! A hand that appears in a replay.
+struct HxReplayHandInfo {
+
+  //! The path of the hand's class, used to spawn a matching hand for playback.
+  FString class_path{};
+
+  //! Which hand this is.
+  ERelativeDirection hand{ERelativeDirection::LEFT};
+};
+
+//! @brief Records hand physics, authority zone objects and grasp events to a compact file, and
+//! plays them back.
+//!
+//! Hand physics state travels over custom RPCs rather than replicated properties, so the engine's
+//! demo recorder doesn't capture it well. This actor samples every hand in the world at
+//! #record_rate_hz_ and writes a compressed stream to Saved/HaptxReplays/<#replay_name_>.hxreplay.
+//!
+//! During playback a kinematic copy of each recorded hand is spawned and posed directly, and
+//! recorded objects found in the world are made kinematic and posed the same way, so nothing is
+//! simulated. Recorded grasp events fire #on_replay_grasp_ and #on_replay_release_.
+//!
+//! @ingroup group_unreal_plugin
+
+// Records hand physics, authority zone objects and grasp events to a compact file, and plays them
+// back.
+UCLASS(ClassGroup = (Haptx))
+class HAPTX_API AHxReplayActor : public AActor {
+  GENERATED_BODY()
+
+public:
+  //! Default constructor.
+  AHxReplayActor();
+
+  //! Called every frame.
+  //!
+  //! @param DeltaTime The time since the last tick.
+  virtual void Tick(float DeltaTime) override;
+
+  //! Called when the actor stops playing. Saves any recording in progress.
+  //!
+  //! @param EndPlayReason Why the actor is stopping.
+  virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+  //! Starts recording. Stops any playback in progress.
+
+  // Starts recording. Stops any playback in progress.
+  UFUNCTION(BlueprintCallable, Category = "Replay")
+  void startRecording();
+
+  //! Stops recording and writes the replay file.
+  //!
+  //! @returns Whether the file was written.
+
+  // Stops recording and writes the replay file.
+  UFUNCTION(BlueprintCallable, Category = "Replay")
+  bool stopRecording();
+
+  //! Whether a recording is in progress.
+  //!
+  //! @returns Whether a recording is in progress.
+
+  // Whether a recording is in progress.
+  UFUNCTION(BlueprintCallable, Category = "Replay")
+  bool isRecording() const;
+
+  //! Loads the replay file and starts playing it back. Stops any recording in progress.
+  //!
+  //! @returns Whether the file was loaded.
+
+  // Loads the replay file and starts playing it back. Stops any recording in progress.
+  UFUNCTION(BlueprintCallable, Category = "Replay")
+  bool startPlayback();
+
+  //! Stops playback, removing playback hands and returning objects to physics simulation.
+
+  // Stops playback, removing playback hands and returning objects to physics simulation.
+  UFUNCTION(BlueprintCallable, Category = "Replay")
+  void stopPlayback();
+
+  //! Whether playback is in progress.
+  //!
+  //! @returns Whether playback is in progress.
+
+  // Whether playback is in progress.
+  UFUNCTION(BlueprintCallable, Category = "Replay")
+  bool isPlayingBack() const;
+
+  //! Gets the path of the replay file.
+  //!
+  //! @returns The path of the replay file.
+
+  // Gets the path of the replay file.
+  UFUNCTION(BlueprintCallable, Category = "Replay")
+  FString getReplayFilePath() const;
+
+  //! The name of the replay file, without directory or extension.
+
+  // The name of the replay file, without directory or extension.
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Replay")
+  FString replay_name_;
+
+  //! @brief The rate at which frames are recorded [Hz].
+  //!
+  //! Playback interpolates between frames, so this only limits how fine the recorded motion is.
+
+  // The rate at which frames are recorded [Hz].
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Replay",
+      meta = (ClampMin = "1.0", UIMin = "1.0"))
+  float record_rate_hz_;
+
+  //! Whether objects in hands' physics authority zones are recorded.
+
+  // Whether objects in hands' physics authority zones are recorded.
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Replay")
+  bool record_objects_;
+
+  //! Whether grasp events are recorded.
+
+  // Whether grasp events are recorded.
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Replay")
+  bool record_grasp_events_;
+
+  //! The speed of playback relative to real time.
+
+  // The speed of playback relative to real time.
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Replay",
+      meta = (ClampMin = "0.0", UIMin = "0.0"))
+  float playback_rate_;
+
+  //! Whether playback starts over when it reaches the end. Otherwise the last frame is held until
+  //! stopPlayback() is called.
+
+  // Whether playback starts over when it reaches the end.
+  UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Replay")
+  bool loop_playback_;
+
+  //! Gets fired when a recorded grasp is played back.
+
+  // Gets fired when a recorded grasp is played back.
+  UPROPERTY(BlueprintAssignable, Category = "Events")
+  FOnGrasp on_replay_grasp_;
+
+  //! Gets fired when a recorded release is played back.
+
+  // Gets fired when a recorded release is played back.
+  UPROPERTY(BlueprintAssignable, Category = "Events")
+  FOnRelease on_replay_release_;
+
+private:
+  //! Samples every hand in the world into a frame and appends it to #recording_payload_.
+  void recordFrame();
+
+  //! Called when the core creates a grasp while recording.
+  //!
+  //! @param component The grasped component.
+  UFUNCTION()
+  void onGrasp(UPrimitiveComponent* component);
+
+  //! Called when the core destroys a grasp while recording.
+  //!
+  //! @param component The released component.
+  UFUNCTION()
+  void onRelease(UPrimitiveComponent* component);
+
+  //! Adds a grasp event to #recorded_grasp_events_.
+  //!
+  //! @param component The component involved.
+  //! @param is_grasp True for a grasp, false for a release.
+  void recordGraspEvent(UPrimitiveComponent* component, bool is_grasp);
+
+  //! Gets the id of an object in the replay's object table, adding it if necessary.
+  //!
+  //! @param component The object.
+  //!
+  //! @returns The object's id.
+  int32 getRecordedObjectId(UPrimitiveComponent* component);
+
+  //! Gets the id of a hand in the replay's hand table, adding it if necessary.
+  //!
+  //! @param hand The hand.
+  //!
+  //! @returns The hand's id.
+  int32 getRecordedHandId(AHxHandActor* hand);
+
+  //! Spawns a kinematic playback hand for every hand in #hand_infos_.
+  void spawnPlaybackHands();
+
+  //! Finds the objects in #object_paths_ and makes them kinematic.
+  void resolvePlaybackObjects();
+
+  //! Poses hands and objects for the current playback time and fires any grasp events passed.
+  void updatePlayback();
+
+  //! Whether a recording is in progress.
+  bool is_recording_;
+
+  //! Whether playback is in progress.
+  bool is_playing_back_;
+
+  //! The world time when recording started [s].
+  float recording_start_time_s_;
+
+  //! The last time a frame was recorded, relative to #recording_start_time_s_ [s].
+  float time_of_last_record_s_;
+
+  //! The number of frames in #recording_payload_.
+  int32 num_recorded_frames_;
+
+  //! Serialized frames recorded so far.
+  TArray<uint8> recording_payload_;
+
+  //! Grasp events recorded so far.
+  TArray<HxReplayGraspEvent> recorded_grasp_events_;
+
+  //! The core whose grasp events are being recorded.
+  UPROPERTY()
+  AHxCoreActor* hx_core_;
+
+  //! The replay's hand table ids of recorded hands.
+  TMap<TWeakObjectPtr<AHxHandActor>, int32> hand_id_from_hand_;
+
+  //! The replay's object table ids of recorded objects.
+  TMap<TWeakObjectPtr<UPrimitiveComponent>, int32> object_id_from_comp_;
+
+  //! The replay's hand table.
+  TArray<HxReplayHandInfo> hand_infos_;
+
+  //! The replay's object table. Paths are relative to the world.
+  TArray<FString> object_paths_;
+
+  //! Frames loaded for playback.
+  TArray<HxReplayFrame> playback_frames_;
+
+  //! Grasp events loaded for playback.
+  TArray<HxReplayGraspEvent> playback_grasp_events_;
+
+  //! The current playback time [s].
+  float playback_time_s_;
+
+  //! The index of the latest frame at or before #playback_time_s_.
+  int32 playback_frame_i_;
+
+  //! The index of the next grasp event to fire.
+  int32 playback_grasp_event_i_;
+
+  //! Kinematic hands posed during playback, indexed by hand id.
+  UPROPERTY()
+  TArray<AHxHandActor*> playback_hands_;
+
+  //! Recorded objects found in the world, indexed by object id. Null if not found.
+  UPROPERTY()
+  TArray<UPrimitiveComponent*> playback_objects_;
+
+  //! Objects made kinematic for playback that were simulating physics beforehand.
+  UPROPERTY()
+  TArray<UPrimitiveComponent*> comps_simulating_before_playback_;
+
+  //! Skeletal mesh objects made to blend physics for playback that weren't beforehand.
+  UPROPERTY()
+  TArray<USkeletalMeshComponent*> smcs_blending_for_playback_;
+};
@@ -0,0 +1,137 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#pragma once
+
+#include <Runtime/Engine/Classes/Commandlets/Commandlet.h>
+#include <Runtime/Engine/Classes/GameFramework/Controller.h>
+#include <Runtime/Json/Public/Dom/JsonObject.h>
+#include <Haptx/Public/hx_hand_actor.h>
+#include "hx_scale_benchmark_commandlet.generated.h"
+
+//! Possesses the pawns that own benchmark hands so that the hands are locally controlled.
+UCLASS(NotPlaceable, Transient)
+class HAPTX_API AHxBenchmarkController : public AController {
+  GENERATED_BODY()
+};
+
+//! @brief Measures how the plugin scales with the number of hands and spatial effects in a world.
+//!
+//! For each requested number of hand pairs this spawns that many pawns, each with a pair of
+//! scripted hands (see AHxHandActor::scripted_input_) hovering over a table with graspable
+//! objects. The hands repeatedly reach, grasp, lift and release while cycling through simulated
+//! gestures. Each hand pair count is run once for each requested number of small spatial wave
+//! effects, which are scattered around the tables, and each requested number of wave object
+//! effects on every graspable object. Per-subsystem timings from HxBenchmarkStats, along with how
+//! many wave samples HxOscillatorBank precomputed, are written to a JSON file. Each hand spawns at
+//! a different world pose, and every pass also checks that patches on hands of the same side
+//! agree on their UHxPatchTraceOrigins keys.
+//!
+//! Runs headless:
+//! @code
+//! UE4Editor-Cmd <Project>.uproject -run=HxScaleBenchmark -nullrhi -unattended
+//!     [-Map=/Game/Path/To/Map] [-HandPairs=1,2,4,8,16,32] [-WarmupFrames=90] [-Frames=900]
+//!     [-FrameRate=90] [-HandClass=/haptx/HaptxHand_BP.HaptxHand_BP_C] [-Output=<file>]
+//!     [-SpatialEffects=0] [-SpatialEffectIndex=true] [-WaveObjectEffects=0]
+//! @endcode
+//!
+//! For example -HandPairs=1 -SpatialEffects=10,30,100,300,1000 measures how spatial effects
+//! scale, and running it again with -SpatialEffectIndex=false measures it without
+//! AHxCoreActor::index_spatial_effects_. Likewise -WaveObjectEffects=0,1,4 measures what wave
+//! effects cost as hands touch them, and how often their samples hit the oscillator bank.
+//!
+//! Without -Map the benchmark runs in an empty world containing only the objects it spawns.
+//!
+//! @ingroup group_unreal_plugin
+UCLASS()
+class HAPTX_API UHxScaleBenchmarkCommandlet : public UCommandlet {
+  GENERATED_UCLASS_BODY()
+
+public:
+  //! Runs the benchmark.
+  //!
+  //! @param Params The command line.
+  //!
+  //! @returns 0 on success.
+  virtual int32 Main(const FString& Params) override;
+
+private:
+  //! Runs the benchmark with a given number of hand pairs, spatial effects and wave object
+  //! effects.
+  //!
+  //! @param num_hand_pairs How many hand pairs to spawn.
+  //! @param num_spatial_effects How many spatial effects to spawn.
+  //! @param num_wave_object_effects How many wave object effects to add to each graspable object.
+  //!
+  //! @returns The results of the pass, or nullptr if it failed.
+  TSharedPtr<FJsonObject> runPass(int32 num_hand_pairs, int32 num_spatial_effects,
+      int32 num_wave_object_effects);
+
+  //! Creates and begins play in a game world, either empty or loaded from #map_.
+  //!
+  //! @returns The new world, or nullptr if it couldn't be created.
+  UWorld* createWorld();
+
+  //! Ends play in and destroys a world made by createWorld().
+  //!
+  //! @param world The world to destroy.
+  void destroyWorld(UWorld* world);
+
+  //! Spawns a table with graspable objects on it.
+  //!
+  //! @param world The world to spawn in.
+  //! @param w_origin_cm The location of the floor beneath the table.
+  //! @param num_wave_object_effects How many wave object effects to add to each graspable object.
+  void spawnObjects(UWorld* world, const FVector& w_origin_cm, int32 num_wave_object_effects);
+
+  //! Spawns a pawn with a pair of scripted hands.
+  //!
+  //! @param world The world to spawn in.
+  //! @param w_origin_cm The location of the floor beneath the hands.
+  //! @param [out] hands The list to add the new hands to.
+  void spawnHandPair(UWorld* world, const FVector& w_origin_cm, TArray<AHxHandActor*>& hands);
+
+  //! Spawns small spatial wave effects at random locations.
+  //!
+  //! @param world The world to spawn in.
+  //! @param num_spatial_effects How many effects to spawn.
+  //! @param w_region_cm The region to spawn them in.
+  void spawnSpatialEffects(UWorld* world, int32 num_spatial_effects, const FBox& w_region_cm);
+
+  //! Checks that every hand's patches found the same UHxPatchTraceOrigins keys as the other
+  //! hands on the same side, even though each hand spawned at a different world pose.
+  //!
+  //! @param hands The hands to check.
+  //!
+  //! @returns True if the keys match.
+  bool checkTraceOriginsKeys(const TArray<AHxHandActor*>& hands);
+
+  //! Poses scripted hands for a given moment in the benchmark sequence.
+  //!
+  //! @param hands The hands to pose.
+  //! @param time_s The time since the benchmark sequence started [s].
+  void driveHands(const TArray<AHxHandActor*>& hands, float time_s);
+
+  //! The map to run in. Empty to run in an empty world.
+  FString map_;
+
+  //! The hand class to spawn.
+  UPROPERTY()
+  TSubclassOf<AHxHandActor> hand_class_;
+
+  //! The number of frames to simulate before recording.
+  int32 warmup_frames_;
+
+  //! The number of frames to record.
+  int32 frames_;
+
+  //! The fixed rate the world is ticked at [Hz].
+  float frame_rate_hz_;
+
+  //! The value of AHxCoreActor::index_spatial_effects_ to run with.
+  bool index_spatial_effects_;
+
+  //! The world location of the floor beneath each hand in the current pass.
+  TMap<AHxHandActor*, FVector> w_origin_cm_from_hand_;
+};
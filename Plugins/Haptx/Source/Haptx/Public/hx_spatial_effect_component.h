@@ -49,6 +49,11 @@ public:
   UFUNCTION(BlueprintCallable, Category = "Haptic Effects")
   void setBoundingVolume(UHxBoundingVolume* bounding_volume);
 
+  //! Get the underlying spatial effect.
+  //!
+  //! @returns The underlying spatial effect. Null before play begins.
+  std::shared_ptr<HaptxApi::SpatialEffect> getSpatialEffect() const;
+
 protected:
   //! Default constructor.
   UHxSpatialEffectComponent();
@@ -0,0 +1,138 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#pragma once
+
+#include <Runtime/Core/Public/CoreMinimal.h>
+
+class UHxSpatialEffectComponent;
+
+//! @brief A uniform grid over the world bounds of spatial effects' bounding volumes.
+//!
+//! The contact interpreter tests every registered spatial effect's bounding volume against every
+//! tactor, so its cost grows with the number of effects in the world even when few of them are
+//! near a hand. AHxCoreActor uses this index to find the effects whose bounds overlap the hands
+//! each frame and only registers those.
+//!
+//! Each effect's bounds are refreshed every update() but it only moves between cells when the
+//! range of cells its bounds cover changes. Unbounded effects, and effects whose bounds cover too
+//! many cells, are kept in a separate list that every query returns.
+//!
+//! Must only be used from the game thread.
+class HAPTX_API HxSpatialEffectIndex {
+ public:
+  //! Default constructor.
+  HxSpatialEffectIndex();
+
+  //! Sets the size of grid cells, re-binning every effect if it changed.
+  //!
+  //! @param cell_size_cm The edge length of grid cells [cm].
+  void setCellSizeCm(float cell_size_cm);
+
+  //! Adds an effect. Does nothing if it's already indexed.
+  //!
+  //! @param effect The effect.
+  void addEffect(UHxSpatialEffectComponent* effect);
+
+  //! Removes an effect.
+  //!
+  //! @param effect The effect.
+  void removeEffect(UHxSpatialEffectComponent* effect);
+
+  //! Whether an effect is indexed.
+  //!
+  //! @param effect The effect.
+  //!
+  //! @returns Whether @p effect is indexed.
+  bool containsEffect(UHxSpatialEffectComponent* effect) const;
+
+  //! Gets every indexed effect.
+  //!
+  //! @returns Every indexed effect.
+  const TArray<UHxSpatialEffectComponent*>& getEffects() const;
+
+  //! Refreshes the bounds of every effect and moves effects whose bounds changed cells. Drops
+  //! effects that have been destroyed.
+  void update();
+
+  //! Finds the effects whose bounds overlap a box.
+  //!
+  //! @param w_box_cm The box in world space [cm].
+  //! @param [out] effects Effects found are added to this set.
+  void findEffects(const FBox& w_box_cm, TSet<UHxSpatialEffectComponent*>& effects) const;
+
+  //! Gets the world bounds of an effect's bounding volume.
+  //!
+  //! @param effect The effect.
+  //! @param [out] w_bounds_cm The bounds in world space [cm]. Only set if the effect is bounded.
+  //!
+  //! @returns Whether the effect is bounded.
+  static bool getWorldBounds(const UHxSpatialEffectComponent* effect, FBox& w_bounds_cm);
+
+ private:
+  //! An indexed effect.
+  struct Entry {
+    //! The effect.
+    TWeakObjectPtr<UHxSpatialEffectComponent> effect{};
+
+    //! The effect's bounds in world space [cm].
+    FBox w_bounds_cm{ForceInit};
+
+    //! Whether the effect is in #oversized_effects_ rather than grid cells.
+    bool is_oversized{false};
+
+    //! The lowest cell the effect's bounds cover.
+    FIntVector min_cell{0, 0, 0};
+
+    //! The highest cell the effect's bounds cover.
+    FIntVector max_cell{-1, -1, -1};
+  };
+
+  //! Gets the cell containing a point.
+  //!
+  //! @param w_position_cm The point in world space [cm].
+  //!
+  //! @returns The cell.
+  FIntVector getCell(const FVector& w_position_cm) const;
+
+  //! Counts the cells in a range.
+  //!
+  //! @param min_cell The lowest cell.
+  //! @param max_cell The highest cell.
+  //!
+  //! @returns The number of cells from @p min_cell to @p max_cell inclusive.
+  static int64 countCells(const FIntVector& min_cell, const FIntVector& max_cell);
+
+  //! Sets the cells an entry covers from its bounds.
+  //!
+  //! @param [in,out] entry The entry.
+  void bin(Entry& entry) const;
+
+  //! Adds an effect to the cells its entry covers, or to #oversized_effects_.
+  //!
+  //! @param effect The effect.
+  //! @param entry The effect's entry, already binned.
+  void insert(UHxSpatialEffectComponent* effect, const Entry& entry);
+
+  //! Removes an effect from the cells it was added to by insert().
+  //!
+  //! @param effect The effect.
+  //! @param entry The entry it was inserted with.
+  void erase(UHxSpatialEffectComponent* effect, const Entry& entry);
+
+  //! The edge length of grid cells [cm].
+  float cell_size_cm_;
+
+  //! Entries by effect.
+  TMap<UHxSpatialEffectComponent*, Entry> entry_from_effect_;
+
+  //! Every indexed effect.
+  TArray<UHxSpatialEffectComponent*> effects_;
+
+  //! The effects whose bounds overlap each occupied cell.
+  TMap<FIntVector, TArray<UHxSpatialEffectComponent*>> effects_from_cell_;
+
+  //! Unbounded effects and effects that cover too many cells to bin.
+  TArray<UHxSpatialEffectComponent*> oversized_effects_;
+};
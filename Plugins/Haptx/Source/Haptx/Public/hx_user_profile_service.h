@@ -0,0 +1,122 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#pragma once
+
+#include <Runtime/Core/Public/CoreMinimal.h>
+#include <Runtime/Core/Public/Delegates/Delegate.h>
+#include <HaptxApi/user_profile_database.h>
+
+//! Broadcast on the game thread when HxUserProfileService loads a profile that differs from the one
+//! it had cached.
+DECLARE_MULTICAST_DELEGATE(FOnHxUserProfileChanged);
+
+//! @brief Caches the active HaptxApi::UserProfile and the values derived from it.
+//!
+//! HaptxApi::UserProfileDatabase reads from disk, so the active profile is loaded on a worker
+//! thread the first time it's requested and again whenever refresh() is called. Everything else
+//! only reads the cache, and must be called from the game thread.
+class HAPTX_API HxUserProfileService {
+ public:
+  //! Begins loading the active profile if it hasn't been loaded or requested yet.
+  static void requestLoad();
+
+  //! Begins reloading the active profile unless a load is already in progress.
+  static void refresh();
+
+  //! Whether a load has finished.
+  //!
+  //! @returns True if a load has finished.
+  static bool isLoaded();
+
+  //! Whether the cached profile came from the database, as opposed to being the default profile.
+  //!
+  //! @returns True if the cached profile came from the database.
+  static bool hasActiveProfile();
+
+  //! Gets the cached profile. This is the default profile until hasActiveProfile() is true.
+  //!
+  //! @returns The cached profile.
+  static const HaptxApi::UserProfile& getUserProfile();
+
+  //! Gets the name of the cached profile.
+  //!
+  //! @returns The name of the cached profile. Empty unless hasActiveProfile() is true.
+  static const FString& getUsername();
+
+  //! Gets the hand length of the cached profile.
+  //!
+  //! @returns The hand length [m] of the cached profile, or 0 if there isn't an active profile.
+  static float getHandLengthM();
+
+  //! Gets the hand width of the cached profile.
+  //!
+  //! @returns The hand width [m] of the cached profile, or 0 if there isn't an active profile.
+  static float getHandWidthM();
+
+  //! Gets the length of the middle finger of the cached profile from MCP3 to fingertip.
+  //!
+  //! @returns The middle finger length [m] of the cached profile.
+  static float getMiddleFingerLengthM();
+
+  //! The delegate broadcast when the cached profile changes.
+  //!
+  //! @returns The delegate broadcast when the cached profile changes.
+  static FOnHxUserProfileChanged& onUserProfileChanged();
+
+ private:
+  //! Hidden default constructor.
+  HxUserProfileService();
+
+  //! What a worker thread read from the database.
+  struct LoadResult {
+    //! Whether the active profile was read.
+    bool success{false};
+
+    //! The name of the active profile.
+    FString username{};
+
+    //! The active profile, or the default profile if it couldn't be read.
+    HaptxApi::UserProfile user_profile{};
+  };
+
+  //! Starts a load on a worker thread.
+  static void beginLoad();
+
+  //! Caches the result of a load and broadcasts #on_user_profile_changed_ if anything changed.
+  //! Called on the game thread.
+  //!
+  //! @param result The result of the load.
+  static void applyLoadResult(const LoadResult& result);
+
+  //! Whether a load has finished.
+  bool is_loaded_;
+
+  //! Whether a load is in progress.
+  bool is_loading_;
+
+  //! Whether #user_profile_ came from the database.
+  bool has_active_profile_;
+
+  //! The cached profile.
+  HaptxApi::UserProfile user_profile_;
+
+  //! The name of #user_profile_.
+  FString username_;
+
+  //! The hand length [m] of #user_profile_.
+  float hand_length_m_;
+
+  //! The hand width [m] of #user_profile_.
+  float hand_width_m_;
+
+  //! The middle finger length [m] of #user_profile_.
+  float middle_finger_length_m_;
+
+  //! Broadcast when the cached profile changes.
+  FOnHxUserProfileChanged on_user_profile_changed_;
+
+  //! The singleton instance of this class.
+  static HxUserProfileService ups_;
+};
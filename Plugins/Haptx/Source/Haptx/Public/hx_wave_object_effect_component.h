@@ -6,6 +6,7 @@
 
 #include <Haptx/Private/haptx_shared.h>
 #include <Haptx/Public/hx_object_effect_component.h>
+#include <Haptx/Public/hx_oscillator_bank.h>
 #include "hx_wave_object_effect_component.generated.h"
 
 //! An implementation of UHxObjectEffectComponent that defines the Haptic Effect using a
@@ -70,6 +71,11 @@ protected:
   //! Called when the game starts.
   virtual void BeginPlay() override;
 
+  //! Called when the game ends.
+  //!
+  //! @param EndPlayReason Why the game ended.
+  virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
+
   //! Differs from parent by outputting the output from our sine wave generator.
   float getForceN(
       const HaptxApi::ObjectEffect::ContactInfo& contact_info) const override;
@@ -85,4 +91,8 @@ private:
   //! Updates duration internally.
 
   void updateDuration();
+
+  //! The index of this effect's oscillator in HxOscillatorBank.
+
+  int32 oscillator_;
 };
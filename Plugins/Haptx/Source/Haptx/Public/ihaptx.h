@@ -24,10 +24,16 @@ DECLARE_LOG_CATEGORY_EXTERN(HaptX, Log, All);
 #define DECLARE_STATS_GROUP_IF_PROFILING(name, group, stat_cat) DECLARE_STATS_GROUP(name, group, stat_cat)
 #define DECLARE_CYCLE_STAT_IF_PROFILING(name, stat, group) DECLARE_CYCLE_STAT(name, stat, group)
 #define SCOPE_CYCLE_COUNTER_IF_PROFILING(stat) SCOPE_CYCLE_COUNTER(stat)
+#define DECLARE_DWORD_COUNTER_STAT_IF_PROFILING(name, stat, group) DECLARE_DWORD_COUNTER_STAT(name, stat, group)
+#define INC_DWORD_STAT_IF_PROFILING(stat) INC_DWORD_STAT(stat)
+#define INC_DWORD_STAT_BY_IF_PROFILING(stat, amount) INC_DWORD_STAT_BY(stat, amount)
 #else
 #define DECLARE_STATS_GROUP_IF_PROFILING(name, group, stat_cat)
 #define DECLARE_CYCLE_STAT_IF_PROFILING(name, stat, group)
 #define SCOPE_CYCLE_COUNTER_IF_PROFILING(stat)
+#define DECLARE_DWORD_COUNTER_STAT_IF_PROFILING(name, stat, group)
+#define INC_DWORD_STAT_IF_PROFILING(stat)
+#define INC_DWORD_STAT_BY_IF_PROFILING(stat, amount)
 #endif
 
 //! Manages the HaptX module.
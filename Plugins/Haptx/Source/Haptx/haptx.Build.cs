@@ -14,6 +14,7 @@ namespace UnrealBuildTool.Rules {
           "CoreUObject",
           "Engine",
           "HeadMountedDisplay",
+          "Json",
           "SteamVR",
           "SteamVRController",
           "OpenVR"
@@ -6,6 +6,7 @@
 #include <Editor/UnrealEd/Classes/Editor/UnrealEdEngine.h>
 #include <Editor/UnrealEd/Public/UnrealEdGlobals.h>
 #include <Runtime/Core/Public/Modules/ModuleManager.h>
+#include <HaptxEditor/Public/asset_type_actions_hx_patch_trace_origins.h>
 #include <HaptxEditor/Public/asset_type_actions_hx_physical_material.h>
 #include <HaptxEditor/Public/hx_spatial_effect_component_visualizer.h>
 
@@ -25,6 +26,10 @@ void FHaptxEditor::StartupModule() {
   assetToolsModule.Get().RegisterAssetTypeActions(
       MakeShareable(new FAssetTypeActions_HxPhysicalMaterial));
 
+  // Register the UHxPatchTraceOrigins action with the FAssetToolsModule.
+  assetToolsModule.Get().RegisterAssetTypeActions(
+      MakeShareable(new FAssetTypeActions_HxPatchTraceOrigins));
+
   // Register the FHxSpatialEffectComponentVisualizer visualizer with the engine.
   if (GUnrealEd != nullptr) {
     TSharedPtr<FComponentVisualizer> visualizer = 
@@ -0,0 +1,19 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#ifdef WITH_EDITOR
+#include <HaptxEditor/Public/hx_patch_trace_origins_factory.h>
+
+UHxPatchTraceOriginsFactory::UHxPatchTraceOriginsFactory(
+    const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer) {
+  SupportedClass = UHxPatchTraceOrigins::StaticClass();
+  bCreateNew = true;
+  bEditAfterNew = true;
+}
+
+UObject* UHxPatchTraceOriginsFactory::FactoryCreateNew(UClass* Class, UObject* InParent,
+    FName Name, EObjectFlags Flags, UObject* Context, FFeedbackContext* Warn) {
+  return NewObject<UObject>(InParent, Class, Name, Flags);
+}
+#endif // WITH_EDITOR
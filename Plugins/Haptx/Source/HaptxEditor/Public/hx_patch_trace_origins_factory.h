@@ -0,0 +1,22 @@
+// Copyright (C) 2020 by HaptX Incorporated - All Rights Reserved.
+// Unauthorized copying of this file via any medium is strictly prohibited.
+// The contents of this file are proprietary and confidential.
+
+#pragma once
+
+#include <Editor/UnrealEd/Classes/Factories/Factory.h>
+#include <Haptx/Public/hx_patch_trace_origins.h>
+#include "hx_patch_trace_origins_factory.generated.h"
+
+//! A class that allows @link UHxPatchTraceOrigins UHxPatchTraceOrigins @endlink assets to be
+//! created in the editor.
+UCLASS(HideCategories = Object)
+class UHxPatchTraceOriginsFactory : public UFactory {
+  GENERATED_UCLASS_BODY()
+
+  //! Create a new UHxPatchTraceOrigins.
+  //!
+  //! @returns The new UHxPatchTraceOrigins.
+  virtual UObject* FactoryCreateNew(UClass* Class, UObject* InParent, FName Name,
+      EObjectFlags Flags, UObject* Context, FFeedbackContext* Warn) override;
+};